@@ -1,5 +1,6 @@
 #pragma once
 
+#include "audio/RealFFT.h"
 #include <vector>
 #include <cstdint>
 
@@ -51,13 +52,14 @@ public:
 
 private:
     /**
-     * @brief Generate a Hann window for FFT processing
+     * @brief Prepare the real FFT and its input buffer for a waveform size
      * 
-     * @param size Size of the window
+     * @param size Number of waveform samples (zero-padded to a power of 2)
      */
-    void generateHannWindow(size_t size);
+    void preparePlan(size_t size);
 
-    std::vector<float> m_window;        // Window function for FFT
+    RealFFT m_realFFT;                  // Real-input FFT (includes the window)
+    std::vector<float> m_fftInput;      // Windowed, zero-padded FFT input
     int m_sampleRate;                  // Sample rate in Hz
     int m_channels;                    // Number of audio channels
 
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "audio/AudioSource.h"
+#include "audio/TripleBuffer.h"
+#include "audio/AudioHistory.h"
+#include "audio/Filterbank.h"
+#include "audio/FeatureExtractor.h"
+
 #include <vector>
-#include <deque>
 #include <memory>
 #include <string>
+#include <functional>
+#include <cstdint>
 
 namespace av {
 
@@ -11,37 +18,124 @@ namespace av {
  * Structure to hold audio analysis results
  */
 struct AudioData {
-    float energy;          // Overall energy level (0.0-1.0)
+    float energy;          // Overall energy level (0.0-1.0; ~0.5 at the programme's usual loudness)
     float bass;            // Bass level (0.0-1.0)
     float mid;             // Mid-range level (0.0-1.0)
     float treble;          // Treble level (0.0-1.0)
-    float transient;       // Transient detection (sudden changes)
+    float transient;       // Transient detection (same as onset, kept for existing visualizers)
+    float onset;           // Onset envelope (0.0-1.0): jumps on detected onsets, decays over ~100 ms
+    float bpm;             // Tempo estimate in beats per minute (0 while unknown)
+    float beatPhase;       // Position within the current beat (0.0-1.0, beats fall on 0)
+    float pitchHz;         // Fundamental of the dominant periodic sound (0 when none was found)
+    float pitchConfidence; // How periodic the sound is (0.0-1.0; below ~0.5 the pitch is unreliable)
+    int key;               // Estimated key's tonic as a pitch class (0 = C ... 11 = B; -1 while unknown)
+    bool keyMinor;         // Whether the estimated key is minor
+    float keyConfidence;   // Correlation of the recent chroma with the key's profile (0.0-1.0)
+    float loudnessMomentary;  // EBU R128 loudness over 400 ms, in LUFS (-70 is silence)
+    float loudnessShortTerm;  // Over 3 s
+    float loudnessIntegrated; // Gated loudness of everything heard so far
     std::vector<float> spectrum;    // Full frequency spectrum
-    std::vector<float> waveform;    // Time-domain waveform
+    std::vector<float> bands;       // Perceptual bands from the filterbank (0.0-1.0, low to high;
+                                    // relative to each band's recent range unless adaptiveBands is off)
+    std::vector<float> chroma;      // Pitch classes C, C#, ..., B (0.0-1.0, strongest is 1.0)
+    std::vector<float> envelopes;   // Time-domain crossover levels (bass, mid, presence, air; 0.0-1.0)
+    std::vector<float> envelopeBlocks;  // The same levels every few ms through the hop, oldest first
+                                        // (envelopes.size() values per block)
+    std::vector<float> probes;      // Levels of the probes from AudioProcessor::registerProbe (0.0-1.0)
+    AudioFeatures features;         // Spectral shape and signal statistics (spectral ones need the FFT stage)
+    std::vector<float> waveform;    // Time-domain waveform (mid of left and right)
+    
+    // Stereo image (empty with stereo analysis off): left, right, mid (L+R)/2 and side (L-R)/2
+    // spectra processed like spectrum (these need the FFT stage), the left/right correlation and
+    // the newest hop's goniometer points
+    std::vector<float> spectrumLeft;
+    std::vector<float> spectrumRight;
+    std::vector<float> spectrumMid;
+    std::vector<float> spectrumSide;
+    float stereoCorrelation;        // 1 mono, 0 unrelated channels, -1 opposite polarity (0 while silent)
+    std::vector<float> goniometer;  // Interleaved x, y: x = (L-R)/sqrt(2), y = (L+R)/sqrt(2)
+};
+
+/**
+ * How the analysis thread measures AudioData::bands
+ */
+struct AudioAnalysisConfig {
+    FilterbankScale bandScale = FilterbankScale::Log;
+    int numBands = 32;              // Ignored for 1/3-octave bands (derived from the range)
+    bool multiResolution = false;   // Long decimated windows for low bands, short ones for highs
+    bool spectrum = true;           // false skips the FFT stage (spectrum, bands, onsets, tempo, pitch, key);
+                                    // levels then come from the envelopes and probes only
+    bool slidingBands = false;      // Bands from a sliding DFT of one bin per band, updated every sample
+                                    // (kept, with onsets and tempo, when the FFT stage is skipped)
+    bool adaptiveBands = true;      // Each band maps its level against its own recent 10th-95th percentile
+                                    // range; false uses a fixed log curve
+    bool stereo = true;             // Per-channel analysis of live sources (stereo spectra, correlation,
+                                    // goniometer); false mixes to mono on input. Offline analysis is mono.
 };
 
 /**
  * Handles audio capture and analysis
+ *
+ * Analysis runs on its own thread at the audio hop rate and publishes each
+ * finished frame through a triple buffer; update() picks up the newest one
+ * without blocking.
  */
 class AudioProcessor {
 public:
     AudioProcessor();
     ~AudioProcessor();
 
-    // Initialize audio capture
+    // Choose where samples come from (call before initialize)
+    void setSourceConfig(const AudioSourceConfig& config);
+    
+    // Choose how AudioData::bands are measured (call before initialize)
+    void setAnalysisConfig(const AudioAnalysisConfig& config);
+    
+    // Initialize audio capture (or replay, for the "track" and "replay" source types)
     bool initialize(int sampleRate = 44100, int frameSize = 1024);
     
+    // Set up the analysis alone, with no source or thread, for analyzing audio ahead of time
+    bool initializeOffline(int sampleRate, int frameSize = 1024);
+    
+    // Analyze samples on the calling thread after initializeOffline, calling onFrame with each
+    // finished frame (one per hop; a partial hop waits for the next call)
+    void analyzeOffline(const float* samples, size_t count, const std::function<void(const AudioData&)>& onFrame);
+    
+    // Feature track or log replay: seconds into the recording that playback is at now
+    void setPlaybackPosition(double seconds);
+    
+    // Append every published frame to an AudioData log until stopRecording() (or shutdown)
+    bool startRecording(const std::string& path);
+    void stopRecording();
+    bool isRecording() const;
+    
     // Shutdown and cleanup
     void shutdown();
     
-    // Process audio and update analysis
+    // Pick up the latest analysis results (never blocks)
     void update();
     
-    // Get the latest audio analysis results
-    const AudioData& getAudioData() const { return m_currentAudioData; }
+    // Measure the level around a fixed frequency with a Goertzel probe; the result
+    // appears in AudioData::probes[index] from the next frame on. Returns the index,
+    // or -1 if the probe is invalid. Can be called from any thread at any time.
+    int registerProbe(float frequencyHz, float bandwidthHz);
+    
+    // Centre frequency in Hz of each entry of AudioData::bands
+    const std::vector<float>& getBandFrequencies() const;
+    
+    // Get the audio analysis results picked up by the last update()
+    const AudioData& getAudioData() const { return m_snapshots.getReadBuffer(); }
+    
+    // Recent frames picked up by update(), newest first (render thread only)
+    const AudioHistory& getHistory() const { return m_history; }
     
     // Check if audio is being processed
     bool isAudioAvailable() const { return m_audioAvailable; }
+    
+    // Capture ring health: sample frames dropped because analysis fell behind,
+    // and hop periods in which the source delivered nothing
+    uint64_t getOverrunCount() const;
+    uint64_t getUnderrunCount() const;
 
 private:
     // Implementation-specific data structure
@@ -51,11 +145,13 @@ private:
     // Analysis parameters
     int m_sampleRate;
     int m_frameSize;
+    int m_hopSize;          // Samples consumed from the capture ring per analysis frame
     int m_historySize;
     
-    // Audio analysis results
+    // Frame being analyzed (analysis thread only) and published results
     AudioData m_currentAudioData;
-    std::deque<AudioData> m_audioHistory;
+    TripleBuffer<AudioData> m_snapshots;
+    AudioHistory m_history;
     
     // Status flag
     bool m_audioAvailable;
@@ -65,8 +161,58 @@ private:
     float m_midFrequencyLimit;     // Upper limit for mid (e.g., 2000Hz)
     float m_maxFrequency;          // Maximum frequency to analyze
     
-    // Helper method to generate test audio data
-    void generateTestData();
+    // How AudioData::bands are measured
+    AudioAnalysisConfig m_analysisConfig;
+    
+    // Analysis pipeline setup shared by live and offline analysis
+    bool initializeAnalysis();
+    
+    // Map the configured feature track or AudioData log and start its playback clock
+    bool initializeReplay();
+    
+    // Publish the recorded frame at the playback position (render thread)
+    void replayFrame();
+    
+    // Analysis thread: analyze each hop and publish it
+    void analysisLoop();
+    void publishFrame();
+    
+    // Fade the levels out while the source delivers nothing
+    void decayFrame();
+    
+    // Slide one hop from the capture ring into the analysis frame (and the stereo frames)
+    bool readHop();
+    
+    // Feed the hop in the hop buffer to the frame and the per-sample stages
+    void processHop();
+    
+    // Store the crossover envelopes of one finished block
+    void recordEnvelopeBlock(const float* levels, int numBands);
+    
+    // Pick up newly registered probes and measure all of them
+    void updateProbes();
+    
+    // Analyze the current frame into m_currentAudioData
+    void analyzeFrame();
+    
+    // FFT stage: spectrum, bands and the bass/mid/treble levels
+    void analyzeSpectrum();
+    
+    // Raw band magnitudes into processed AudioData::bands (the filterbank reads the raw spectrum)
+    void analyzeBands();
+    
+    // Raw band magnitudes against each band's recent range (adaptiveBands)
+    void normalizeBands();
+    
+    // Chroma and key from the 1/8-rate stream
+    void analyzeHarmony();
+    
+    // Stereo image from the left and right frames (and their spectra with the FFT stage)
+    void analyzeStereo();
+    
+    // Loudness into AudioData, returning the auto-gained energy level
+    float analyzeLoudness();
+
 };
 
 } // namespace av 
\ No newline at end of file
@@ -25,6 +25,12 @@ public:
     Engine();
     ~Engine();
 
+    // Choose the audio source (call before initialize)
+    void setAudioSourceConfig(const AudioSourceConfig& config) { m_audioSourceConfig = config; }
+    
+    // Choose how the audio is analyzed (call before initialize)
+    void setAudioAnalysisConfig(const AudioAnalysisConfig& config) { m_audioAnalysisConfig = config; }
+    
     // Initialize the engine
     bool initialize(int width, int height, const std::string& title);
     
@@ -97,6 +103,10 @@ private:
     std::unique_ptr<SimpleVisualizer> m_simpleVisualizer;
     std::unique_ptr<UI> m_ui;
     
+    // Audio source and analysis selected at startup
+    AudioSourceConfig m_audioSourceConfig;
+    AudioAnalysisConfig m_audioAnalysisConfig;
+    
     // Engine state
     bool m_isRunning;
     double m_lastFrameTime;
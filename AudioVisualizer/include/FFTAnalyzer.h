@@ -1,28 +1,75 @@
 #pragma once
 
+#include "audio/RealFFT.h"
+#include "audio/SlidingDFT.h"
 #include <vector>
 #include <complex>
 #include <memory>
+#include <functional>
+#include <cstdint>
 
 namespace av {
 
+/**
+ * One spectral frame produced by the streaming STFT
+ */
+struct SpectralFrame {
+    int64_t startSample;    // Stream index of the first windowed sample (negative while the first window fills)
+    double centerTime;      // Time of the window center in seconds from the start of the stream
+    const std::vector<float>& magnitudes;   // Magnitude spectrum in dB (fftSize/2+1 bins, or the selected bins)
+};
+
 /**
  * Fast Fourier Transform audio analyzer
  * Processes audio data to extract frequency information
+ *
+ * Works as a streaming STFT: input goes into a mirrored circular buffer, so
+ * every hop the latest fftSize samples are already contiguous and the only
+ * per-hop work is the transform itself. Each frame is reported to the frame
+ * callback with a sample-accurate timestamp.
+ *
+ * The sliding DFT mode trades the full spectrum for latency: only the selected
+ * bins are tracked, every one of them is updated sample by sample, and a frame
+ * is emitted at the end of every buffer passed in rather than every hop.
  */
 class FFTAnalyzer {
 public:
+    // Standard overlaps between consecutive frames (value is fftSize / hopSize)
+    enum class Overlap {
+        Half = 2,               // 50%
+        ThreeQuarters = 4,      // 75%
+        SevenEighths = 8        // 87.5%
+    };
+    
+    using FrameCallback = std::function<void(const SpectralFrame& frame)>;
+    
+    enum class Mode {
+        STFT,           // Full spectrum every hop
+        SlidingDFT      // Selected bins after every buffer
+    };
+
     FFTAnalyzer();
     ~FFTAnalyzer();
     
     // Initialize with specified parameters
     bool initialize(int sampleRate, int fftSize, int hopSize);
+    bool initialize(int sampleRate, int fftSize, Overlap overlap);
+    
+    // Sliding DFT mode: track bins (1..fftSize/2-1) of an fftSize-point Hann-windowed DFT.
+    // damping just below 1 keeps the recurrence stable (see SlidingDFT).
+    bool initializeSliding(int sampleRate, int fftSize, const std::vector<int>& bins, float damping = 0.9999f);
     void shutdown();
     
-    // Process a new buffer of audio samples
+    // Called on every new frame from within processAudioBuffer
+    void setFrameCallback(FrameCallback callback) { m_frameCallback = std::move(callback); }
+    
+    // Process a new buffer of audio samples, emitting a frame every hop (every buffer in sliding mode)
     void processAudioBuffer(const float* buffer, int bufferSize);
     
-    // Get the frequency data after FFT analysis
+    // Forget buffered input and restart timestamps at zero
+    void reset();
+    
+    // Get the frequency data after FFT analysis (one value per selected bin in sliding mode)
     const std::vector<float>& getFrequencyData() const;
     
     // Get specific frequency bands
@@ -30,30 +77,50 @@ public:
     float getMidFrequencyMagnitude() const;  // Mids (250-4000Hz)
     float getHighFrequencyMagnitude() const; // Highs (4000-20000Hz)
     
+    // One-shot magnitude spectrum (size/2+1 bins) of a buffer, zero-padded to a power of 2
+    static std::vector<float> computeFFT(const std::vector<float>& input);
+    
     // Get properties
+    Mode getMode() const { return m_mode; }
+    const std::vector<int>& getBins() const { return m_slidingDFT.getBins(); }
     int getSampleRate() const { return m_sampleRate; }
     int getFFTSize() const { return m_fftSize; }
     int getHopSize() const { return m_hopSize; }
+    uint64_t getSamplesProcessed() const { return m_samplesProcessed; }
+    uint64_t getFrameCount() const { return m_frameCount; }
     
 private:
     // Helper methods for FFT computation
-    void performFFT();
-    void applyWindow();
+    void performFFT(const float* window);
     void computeMagnitudes();
+    void computeSlidingMagnitudes();
+    void emitFrame();
+    float averageMagnitude(float lowFrequency, float highFrequency) const;
+    
+    Mode m_mode;
     
     // FFT parameters
     int m_sampleRate;
     int m_fftSize;
     int m_hopSize;
     
-    // Audio buffers
+    // Audio buffers: input is written twice, at i and i + fftSize, so the
+    // last fftSize samples always start contiguously at m_writePosition
     std::vector<float> m_inputBuffer;
-    std::vector<std::complex<float>> m_fftBuffer;
     std::vector<float> m_frequencyData;
-    std::vector<float> m_window;
+    
+    // Real-input FFT over m_fftSize samples
+    RealFFT m_realFFT;
+    
+    // Selected bins in sliding mode
+    SlidingDFT m_slidingDFT;
     
     // State tracking
-    int m_bufferPosition;
+    int m_writePosition;        // Next slot in the circular input
+    int m_samplesUntilFrame;    // Samples left before the next hop completes
+    uint64_t m_samplesProcessed;
+    uint64_t m_frameCount;
+    FrameCallback m_frameCallback;
     bool m_initialized;
 };
 
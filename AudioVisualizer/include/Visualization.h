@@ -22,6 +22,9 @@ public:
     virtual void cleanup();
     virtual void onResize(int width, int height);
     
+    // Ask for Goertzel probes on fixed frequencies (called once the audio processor is running)
+    virtual void registerProbes(AudioProcessor& /*audioProcessor*/) {}
+    
     // Render the visualization
     virtual void render(Renderer* renderer, const AudioData& audioData) = 0;
     
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "audio/MappedFile.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+namespace av {
+
+struct AudioData;
+
+/**
+ * AudioData logs: published analysis frames recorded at full precision
+ *
+ * Layout (little-endian):
+ *   AudioDataLogHeader
+ *   per frame: AudioDataLogRecord, then the frame's payload (every level
+ *   and feature as stored in AudioData, and each vector as a count and its
+ *   floats)
+ *   on a clean close: AudioDataLogIndexEntry per frame, then AudioDataLogFooter
+ *
+ * The log is only ever appended to, so a recording cut short (a crash, a
+ * killed process) still replays: without a footer, the reader rebuilds the
+ * index by walking the records.
+ */
+struct AudioDataLogHeader {
+    char magic[4];              // "AVDL"
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t hopSize;
+};
+
+struct AudioDataLogRecord {
+    uint32_t payloadBytes;
+    uint32_t reserved;
+    double timestamp;           // Seconds since recording started
+};
+
+struct AudioDataLogIndexEntry {
+    double timestamp;
+    uint64_t offset;            // Of the AudioDataLogRecord, from the start of the file
+};
+
+struct AudioDataLogFooter {
+    uint64_t indexOffset;
+    uint32_t frameCount;
+    char magic[4];              // "AVDI"
+};
+
+/**
+ * Appends frames to an AudioData log
+ */
+class AudioDataLogWriter {
+public:
+    AudioDataLogWriter();
+    ~AudioDataLogWriter();
+
+    AudioDataLogWriter(const AudioDataLogWriter&) = delete;
+    AudioDataLogWriter& operator=(const AudioDataLogWriter&) = delete;
+
+    bool open(const std::string& path, int sampleRate, int hopSize);
+
+    // Append one frame (reuses its serialization buffer, so steady-state appends don't allocate)
+    bool append(const AudioData& frame, double timestamp);
+
+    // Write the index and footer and close the file
+    void close();
+
+    bool isOpen() const { return m_file.is_open(); }
+    size_t getFrameCount() const { return m_index.size(); }
+
+private:
+    std::ofstream m_file;
+    uint64_t m_offset;
+    std::vector<uint8_t> m_payload;
+    std::vector<AudioDataLogIndexEntry> m_index;
+};
+
+/**
+ * Reads an AudioData log in place from a memory mapping
+ */
+class AudioDataLogReader {
+public:
+    AudioDataLogReader();
+
+    // Map the file and load (or rebuild) its index
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Frame that was current at the given time since recording started (-1 before the first one)
+    int findFrame(double seconds) const;
+
+    // Restore a frame into data (vectors are resized to the recorded sizes); false if the record is corrupt
+    bool decode(int frame, AudioData& data) const;
+
+    // Get properties
+    int getFrameCount() const { return static_cast<int>(m_index.size()); }
+    double getTimestamp(int frame) const { return m_index[frame].timestamp; }
+    double getDuration() const;
+    int getSampleRate() const { return m_sampleRate; }
+    int getHopSize() const { return m_hopSize; }
+
+private:
+    // Walk the records after the header (for logs without a footer)
+    void rebuildIndex();
+
+    MappedFile m_file;
+    int m_sampleRate;
+    int m_hopSize;
+    std::vector<AudioDataLogIndexEntry> m_index;
+};
+
+} // namespace av
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+struct AudioData;
+
+/**
+ * Read-only view of a contiguous run of floats owned by someone else
+ */
+struct FloatView {
+    const float* data = nullptr;
+    size_t size = 0;
+
+    const float& operator[](size_t i) const { return data[i]; }
+    const float* begin() const { return data; }
+    const float* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * Fixed-capacity history of recent AudioData frames
+ *
+ * Storage is allocated once in initialize(): one contiguous array per scalar
+ * field and one capacity x length block each for spectra and waveforms.
+ * push() copies a frame into the oldest slot, so steady-state operation does
+ * no heap traffic, and frames are read back through zero-copy views indexed
+ * by age (0 is the newest frame).
+ */
+class AudioHistory {
+public:
+    AudioHistory();
+
+    // Allocate room for capacity frames of the given spectrum and waveform lengths
+    void initialize(size_t capacity, size_t spectrumSize, size_t waveformSize);
+
+    // Forget all frames (keeps the storage)
+    void clear();
+
+    // Record a frame, overwriting the oldest once full.
+    // Spectrum/waveform are truncated or zero-padded to the initialized lengths.
+    void push(const AudioData& data);
+
+    // Number of frames stored (at most getCapacity())
+    size_t size() const { return m_count; }
+    size_t getCapacity() const { return m_capacity; }
+    bool empty() const { return m_count == 0; }
+
+    // Fields of the frame `age` frames ago (age < size())
+    float getEnergy(size_t age) const { return m_energy[slot(age)]; }
+    float getBass(size_t age) const { return m_bass[slot(age)]; }
+    float getMid(size_t age) const { return m_mid[slot(age)]; }
+    float getTreble(size_t age) const { return m_treble[slot(age)]; }
+    float getTransient(size_t age) const { return m_transient[slot(age)]; }
+    FloatView getSpectrum(size_t age) const;
+    FloatView getWaveform(size_t age) const;
+
+private:
+    // Storage slot of the frame `age` frames ago
+    size_t slot(size_t age) const { return (m_newest + m_capacity - age) % m_capacity; }
+
+    size_t m_capacity;
+    size_t m_spectrumSize;
+    size_t m_waveformSize;
+    size_t m_newest;    // Slot of the most recent frame
+    size_t m_count;
+
+    // Per-field arrays, one entry (or row) per slot
+    std::vector<float> m_energy;
+    std::vector<float> m_bass;
+    std::vector<float> m_mid;
+    std::vector<float> m_treble;
+    std::vector<float> m_transient;
+    std::vector<float> m_spectra;
+    std::vector<float> m_waveforms;
+};
+
+} // namespace av
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "audio/SampleFormat.h"
+#include "audio/SyntheticScenario.h"
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+namespace av {
+
+class RingBuffer;
+
+/**
+ * Startup selection of where AudioProcessor gets its samples
+ */
+struct AudioSourceConfig {
+    std::string type = "auto";      // auto, capture, wasapi, synthetic, wav, pcm, track, replay
+    std::string path;               // wav: file to play, pcm: "-" for stdin or a named pipe,
+                                    // track: feature track from av_analyze to replay,
+                                    // replay: AudioData log from --record to replay
+    float replaySpeed = 1.0f;       // track, replay: playback rate (0 publishes the next frame
+                                    // on every update, as fast as frames are drawn)
+    int sampleRate = 44100;         // pcm: rate of the incoming stream
+    int channels = 2;               // pcm: number of interleaved channels
+    SampleFormat format = SampleFormat::Int16;  // pcm: sample encoding
+    SyntheticScenario scenario = SyntheticScenario::Tones;  // synthetic: signal to generate
+    uint32_t seed = 1;              // synthetic: noise seed (same seed, same samples)
+};
+
+/**
+ * Producer of stereo float samples for analysis
+ *
+ * A source runs on its own thread (or the audio driver's) and writes into
+ * the analysis ring as samples become available, converting straight into
+ * ring storage where it can. The ring holds interleaved left/right frames:
+ * sources write whole frames (an even number of samples, see
+ * convertToStereo), which keeps every write, read and drop frame-aligned.
+ * The ring's overrun counter records anything a source had to drop because
+ * analysis fell behind.
+ */
+class AudioSource {
+public:
+    virtual ~AudioSource() = default;
+
+    // Open the source; sampleRate is the preferred rate for sources that can choose
+    virtual bool initialize(int sampleRate) = 0;
+
+    // Start delivering samples into ring (ring must outlive stop())
+    virtual bool start(RingBuffer& ring) = 0;
+
+    // Stop delivering; the ring is not touched after this returns
+    virtual void stop() = 0;
+
+    // Rate of the delivered samples (valid after initialize)
+    virtual int getSampleRate() const = 0;
+
+    // Human-readable description for logs
+    virtual std::string getName() const = 0;
+
+    // Create the source for config ("auto" means the platform capture backend),
+    // returns nullptr for an unknown type
+    static std::unique_ptr<AudioSource> create(const AudioSourceConfig& config);
+};
+
+} // namespace av
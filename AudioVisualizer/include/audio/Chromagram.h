@@ -0,0 +1,46 @@
+#pragma once
+
+#include "audio/Filterbank.h"
+
+#include <vector>
+
+namespace av {
+
+/**
+ * Pitch-class profile (chroma) of a magnitude spectrum
+ *
+ * A filterbank with one triangular filter per equal-tempered semitone
+ * (each spanning the neighbouring semitones' centres, A = 440 Hz) measures
+ * every note over a range of whole octaves. The notes are stored octave
+ * by octave, so folding them into the 12 pitch classes is a sum of
+ * 12-float rows: three SIMD adds per octave and no per-note bookkeeping.
+ */
+class Chromagram {
+public:
+    static const int NumPitchClasses = 12;
+
+    Chromagram();
+
+    // Semitone filters for numOctaves octaves starting at the C with MIDI number lowestC
+    // (36 = C2, 65.4 Hz), on fftSize-point spectra at sampleRate
+    bool initialize(int fftSize, int sampleRate, int lowestC = 36, int numOctaves = 5);
+
+    // Fold a linear magnitude spectrum (fftSize/2+1 bins) into pitch classes
+    void process(const float* magnitudes);
+
+    // C, C#, ..., B scaled so the strongest class is 1.0 (all zero in silence)
+    const float* getChroma() const { return m_chroma; }
+
+    // Get properties
+    int getNumOctaves() const { return m_numOctaves; }
+    float getLowestFrequency() const { return m_notes.getCenterFrequencies().front(); }
+    float getHighestFrequency() const { return m_notes.getCenterFrequencies().back(); }
+
+private:
+    int m_numOctaves;
+    Filterbank m_notes;
+    std::vector<float> m_noteLevels;    // Octave by octave, C first
+    alignas(16) float m_chroma[NumPitchClasses];
+};
+
+} // namespace av
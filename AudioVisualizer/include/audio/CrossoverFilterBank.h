@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Time-domain band levels from a bank of Linkwitz-Riley band filters
+ *
+ * Each band is a 4th-order Linkwitz-Riley highpass at its lower crossover
+ * followed by a 4th-order lowpass at its upper one (each is two cascaded
+ * Butterworth biquads), so adjacent bands meet at -6 dB. Bands run side by
+ * side in the lanes of a SIMD vector: every biquad section processes four
+ * bands per instruction with the input sample broadcast, and 5-8 bands use
+ * a second group of four lanes.
+ *
+ * Each band's rectified output drives an attack/release envelope follower.
+ * Levels are published every blockSize samples, so meters can follow the
+ * audio at a few milliseconds per update whatever the FFT size.
+ */
+class CrossoverFilterBank {
+public:
+    // Called with the band envelopes at the end of every block
+    using BlockCallback = std::function<void(const float* levels, int numBands)>;
+
+    // Bands supported (crossovers + 1)
+    static const int MinBands = 2;
+    static const int MaxBands = 8;
+
+    CrossoverFilterBank();
+
+    // Crossover frequencies in ascending order split the input into crossovers.size() + 1 bands
+    bool initialize(int sampleRate, const std::vector<float>& crossovers,
+                    float attackSeconds = 0.002f, float releaseSeconds = 0.12f, int blockSize = 128);
+
+    // Clear filter and envelope state
+    void reset();
+
+    // Filter samples and follow the envelopes, calling the block callback at each block boundary
+    void process(const float* samples, size_t count);
+
+    // Receive the levels of each finished block
+    void setBlockCallback(BlockCallback callback) { m_blockCallback = std::move(callback); }
+
+    // Band envelopes at the end of the last finished block (amplitude, a full-scale sine reads ~1.0)
+    const float* getLevels() const { return m_levels.data(); }
+
+    // Get properties
+    int getNumBands() const { return m_numBands; }
+    int getBlockSize() const { return m_blockSize; }
+    const std::vector<float>& getCrossovers() const { return m_crossovers; }
+
+private:
+    // Highpass, highpass, lowpass, lowpass
+    static const int NumSections = 4;
+    static const int Lanes = 4;
+
+    void processGroup(int group, const float* samples, size_t count);
+
+    int m_numBands;
+    int m_numGroups;
+    int m_blockSize;
+    int m_blockPosition;
+    std::vector<float> m_crossovers;
+
+    // Per group and section: b0, b1, b2, a1, a2 for each lane
+    std::vector<float> m_coefficients;
+
+    // Per group and section: z1, z2 for each lane (transposed direct form II)
+    std::vector<float> m_state;
+
+    // Per group: envelope of each lane, and the follower coefficients
+    std::vector<float> m_envelope;
+    float m_attack;
+    float m_release;
+
+    std::vector<float> m_levels;
+    BlockCallback m_blockCallback;
+};
+
+} // namespace av
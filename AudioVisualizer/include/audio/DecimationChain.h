@@ -0,0 +1,65 @@
+#pragma once
+
+#include "audio/HalfBandDecimator.h"
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Cascade of half-band decimators publishing the signal at 1/2, 1/4, 1/8 ... rate
+ *
+ * Analysis stages that only look at low frequencies subscribe to the
+ * coarsest stream that still covers their range and do proportionally less
+ * work. Each stage carries its filter state across blocks, so streams are
+ * continuous whatever block sizes the input arrives in. Stages past the
+ * deepest subscription are not run.
+ *
+ * Stream callbacks run on the thread that calls process(), in order of
+ * increasing decimation.
+ */
+class DecimationChain {
+public:
+    // Called with each block of a decimated stream
+    using StreamCallback = std::function<void(const float* samples, size_t count)>;
+
+    DecimationChain();
+
+    // Set up numStages stages (decimation up to 2^numStages) and drop all subscriptions.
+    // Each stage filters blocks of up to maxBlockSize input samples without allocating.
+    bool initialize(int sampleRate, int numStages, size_t maxBlockSize = 1024, int taps = 31);
+
+    // Clear the filter state of every stage
+    void reset();
+
+    // Receive the stream decimated by a power of 2 (1 is the input itself)
+    bool subscribe(int decimation, StreamCallback callback);
+
+    // Feed input samples (any block size)
+    void process(const float* samples, size_t count);
+
+    // Get properties
+    int getSampleRate() const { return m_sampleRate; }
+    int getNumStages() const { return static_cast<int>(m_stages.size()); }
+    int getMaxDecimation() const { return 1 << getNumStages(); }
+
+    // Group delay of a decimated stream, in input samples
+    int getDelay(int decimation) const;
+
+private:
+    struct Stage {
+        HalfBandDecimator decimator;
+        std::vector<float> output;
+        std::vector<StreamCallback> subscribers;
+    };
+
+    int m_sampleRate;
+    size_t m_maxBlockSize;
+    std::vector<StreamCallback> m_inputSubscribers;
+    std::vector<Stage> m_stages;
+    int m_activeStages;         // Stages up to the deepest subscription
+};
+
+} // namespace av
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace av {
+
+/**
+ * Butterfly kernels for the split real/imaginary FFT layout
+ *
+ * Each kernel set implements one radix-2 pass and one fused radix-4 pass
+ * (two radix-2 stages per sweep over the data). SIMD sets only handle passes
+ * whose butterfly half-size fills a whole vector; smaller passes go to the
+ * fallback set, ending at the scalar reference implementation.
+ */
+struct FFTKernels {
+    // Radix-2 pass over n points combining sub-transforms of size h into size 2h
+    using Radix2Pass = void (*)(float* re, float* im, int n, int h,
+                                const float* wRe, const float* wIm);
+
+    // Radix-4 pass combining four sub-transforms of size h into size 4h.
+    // w1 are the twiddles of the size-2h stage, w2 those of the size-4h stage.
+    using Radix4Pass = void (*)(float* re, float* im, int n, int h,
+                                const float* w1Re, const float* w1Im,
+                                const float* w2Re, const float* w2Im);
+
+    const char* name;
+    int width;                      // Floats per vector; passes need h >= width
+    Radix2Pass radix2;
+    Radix4Pass radix4;
+    const FFTKernels* fallback;     // Used for passes narrower than width
+
+    // Kernel sets; sse2() and avx2() return nullptr when not built for this target
+    // or, for AVX2, when CPUID reports no support
+    static const FFTKernels& scalar();
+    static const FFTKernels* sse2();
+    static const FFTKernels* avx2();
+
+    // Fastest kernel set supported by this CPU, detected once via CPUID
+    static const FFTKernels& best();
+};
+
+} // namespace av
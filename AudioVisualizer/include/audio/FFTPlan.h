@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+#include <cstdint>
+
+namespace av {
+
+struct FFTKernels;
+
+/**
+ * Precomputed tables for an iterative in-place radix-2 FFT
+ *
+ * A plan holds everything that only depends on the transform size: the
+ * bit-reversal permutation, the twiddle factors and the Hann analysis window.
+ * Plans are immutable once built, so a single instance per size is shared by
+ * every analyzer through FFTPlan::get() and transforms never allocate.
+ *
+ * The interleaved std::complex transform is the scalar reference. The split
+ * real/imaginary transform runs fused radix-4 passes on the SIMD kernels
+ * selected at startup (see FFTKernels).
+ */
+class FFTPlan {
+public:
+    explicit FFTPlan(int size);
+
+    // Get the shared plan for a power-of-two size (nullptr if the size is invalid)
+    static std::shared_ptr<const FFTPlan> get(int size);
+
+    // In-place forward transform of getSize() complex values (scalar reference)
+    void forward(std::complex<float>* data) const;
+
+    // In-place forward transform in split layout using the best kernels for this CPU
+    void forward(float* re, float* im) const;
+
+    // In-place forward transform in split layout using a specific kernel set
+    void forward(float* re, float* im, const FFTKernels& kernels) const;
+
+    // Multiply input by the cached window and widen it into a complex buffer
+    void applyWindow(const float* input, std::complex<float>* output) const;
+
+    // Get properties
+    int getSize() const { return m_size; }
+    int getLog2Size() const { return m_log2Size; }
+    const std::vector<float>& getWindow() const { return m_window; }
+    const std::vector<std::complex<float>>& getTwiddles() const { return m_twiddles; }
+
+    // Sum of the window coefficients, used to scale magnitudes back to amplitudes
+    float getWindowSum() const { return m_windowSum; }
+
+    // Size helpers
+    static bool isPowerOfTwo(int n) { return n > 0 && (n & (n - 1)) == 0; }
+    static int nextPowerOfTwo(int n);
+
+private:
+    int m_size;
+    int m_log2Size;
+
+    std::vector<uint32_t> m_bitReverse;              // Bit-reversed index of each position
+    std::vector<std::complex<float>> m_twiddles;     // e^(-2*pi*i*k/N) for k < N/2
+    std::vector<float> m_stageTwiddlesRe;            // Per-stage contiguous twiddles, split layout:
+    std::vector<float> m_stageTwiddlesIm;            // stage with half-size h starts at offset h-1
+    std::vector<float> m_window;                     // Hann window
+    float m_windowSum;
+};
+
+} // namespace av
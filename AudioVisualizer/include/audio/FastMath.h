@@ -0,0 +1,51 @@
+#pragma once
+
+#include "audio/Simd.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace av {
+
+// Natural log for positive normal floats, within ~1e-6 absolute.
+// Branch-free so per-bin loops vectorize, unlike calling logf per bin.
+inline float fastLog(float x)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    // Split into exponent and a mantissa centred on 1 (in [sqrt(1/2), sqrt(2)))
+    const uint32_t centred = bits - 0x3F3504F3u;
+    const float exponent = static_cast<float>(static_cast<int32_t>(centred) >> 23);
+    bits = (centred & 0x007FFFFFu) + 0x3F3504F3u;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // ln(m) = 2 * atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172
+    const float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+    const float t2 = t * t;
+    const float series = t * (2.0f + t2 * (2.0f / 3.0f + t2 * (2.0f / 5.0f + t2 * (2.0f / 7.0f))));
+    return exponent * 0.69314718f + series;
+}
+
+#ifdef AV_SIMD_SSE2
+// fastLog on four lanes
+inline __m128 fastLog(__m128 x)
+{
+    const __m128i offset = _mm_set1_epi32(0x3F3504F3);
+    const __m128i centred = _mm_sub_epi32(_mm_castps_si128(x), offset);
+    const __m128 exponent = _mm_cvtepi32_ps(_mm_srai_epi32(centred, 23));
+    const __m128 mantissa = _mm_castsi128_ps(
+        _mm_add_epi32(_mm_and_si128(centred, _mm_set1_epi32(0x007FFFFF)), offset));
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+    const __m128 t2 = _mm_mul_ps(t, t);
+    __m128 series = _mm_add_ps(_mm_set1_ps(2.0f / 5.0f), _mm_mul_ps(t2, _mm_set1_ps(2.0f / 7.0f)));
+    series = _mm_add_ps(_mm_set1_ps(2.0f / 3.0f), _mm_mul_ps(t2, series));
+    series = _mm_mul_ps(t, _mm_add_ps(_mm_set1_ps(2.0f), _mm_mul_ps(t2, series)));
+    return _mm_add_ps(_mm_mul_ps(exponent, _mm_set1_ps(0.69314718f)), series);
+}
+#endif
+
+} // namespace av
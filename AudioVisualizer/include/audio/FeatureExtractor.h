@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Scalar descriptors of the current frame for driving visuals
+ */
+struct AudioFeatures {
+    float centroid = 0.0f;          // Magnitude-weighted mean frequency in Hz ("brightness")
+    float spread = 0.0f;            // Standard deviation around the centroid in Hz
+    float rolloff = 0.0f;           // Frequency below which 85% of the magnitude lies, in Hz
+    float flatness = 0.0f;          // Geometric over arithmetic mean power (0 tonal - 1 noise-like)
+    float flux = 0.0f;              // Magnitude gained since the last frame over the frame's total (0-1)
+    float zeroCrossingRate = 0.0f;  // Sign changes per sample over the frame
+    float rms = 0.0f;               // RMS of the frame's samples
+    float truePeak = 0.0f;          // Peak of the 4x oversampled signal over the latest block
+};
+
+/**
+ * Computes AudioFeatures in one pass over each spectrum and each block
+ *
+ * processSpectrum() accumulates every spectral sum (magnitude, frequency
+ * moments, log power for the flatness, rectified change against the last
+ * spectrum) in a single SIMD loop over the bins. The rolloff needs the total
+ * first, so the loop also stores partial sums per four bins and the rolloff
+ * is found by scanning those rather than the spectrum again.
+ *
+ * processBlock() takes each new block of samples once for the energy, the
+ * zero crossings and the true peak. The peak comes from a 48-tap polyphase
+ * interpolator (as in ITU-R BS.1770), with the four phases of each sample
+ * computed together in one vector. Energy and crossings are kept per block,
+ * so the frame values are sums over the last few blocks.
+ */
+class FeatureExtractor {
+public:
+    FeatureExtractor();
+
+    // Spectra have fftSize/2+1 bins; the frame is the last fftSize samples, arriving in blocks of blockSize
+    bool initialize(int sampleRate, int fftSize, int blockSize, float rolloffFraction = 0.85f);
+
+    // Forget the previous spectrum and the sample history
+    void reset();
+
+    // Spectral features from a linear magnitude spectrum
+    void processSpectrum(const float* magnitudes);
+
+    // Time-domain features from the next block of samples (at most blockSize)
+    void processBlock(const float* samples, size_t count);
+
+    const AudioFeatures& getFeatures() const { return m_features; }
+
+private:
+    static const int PeakTaps = 12;         // Taps per phase of the 4x interpolator
+
+    int m_sampleRate;
+    int m_numBins;
+    int m_blockSize;
+    float m_binWidth;
+    float m_rolloffFraction;
+
+    // Spectral state: last spectrum for the flux, magnitude sums per four bins for the rolloff
+    std::vector<float> m_previous;
+    std::vector<float> m_chunkSums;
+
+    // Interpolator taps as [tap][phase], and the input with PeakTaps - 1 samples of history in front
+    std::vector<float> m_peakCoefficients;
+    std::vector<float> m_input;
+
+    // Energy and crossings of the blocks in the frame, oldest overwritten first
+    std::vector<float> m_blockEnergy;
+    std::vector<int> m_blockCrossings;
+    std::vector<size_t> m_blockLength;
+    size_t m_blockIndex;
+
+    AudioFeatures m_features;
+};
+
+} // namespace av
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "audio/MappedFile.h"
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace av {
+
+struct AudioData;
+
+/**
+ * Feature track files: analysis results of a whole track, computed ahead of time
+ *
+ * Layout (little-endian, written and read as plain structs):
+ *   FeatureTrackHeader
+ *   FeatureTrackIndexEntry per frame, in time order
+ *   one record per frame: FeatureTrackFrame, then the spectrum bins and the
+ *   bands, one byte each
+ *
+ * Levels are quantized (16 bits for the scalar levels, 8 bits per spectrum bin
+ * and band), so a three-minute track at 512-sample hops is under 10 MB and
+ * can be mapped and read in place at show time.
+ */
+struct FeatureTrackHeader {
+    char magic[4];              // "AVFT"
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t hopSize;
+    uint32_t frameCount;
+    uint32_t spectrumBins;
+    uint32_t numBands;
+    uint32_t frameBytes;        // Size of each frame record
+    uint64_t indexOffset;
+    uint64_t framesOffset;
+};
+
+struct FeatureTrackIndexEntry {
+    uint64_t sampleTime;        // Input sample at which the frame becomes current
+    uint64_t offset;            // Of the frame record, from the start of the file
+};
+
+struct FeatureTrackFrame {
+    uint16_t energy;            // Levels in 1/65535
+    uint16_t bass;
+    uint16_t mid;
+    uint16_t treble;
+    uint16_t onset;
+    uint16_t beatPhase;
+    uint16_t bpm;               // In 1/100 BPM
+    uint8_t flags;              // FeatureTrackOnset, FeatureTrackBeat
+    uint8_t reserved;
+};
+
+const uint8_t FeatureTrackOnset = 1;    // An onset was detected in this frame
+const uint8_t FeatureTrackBeat = 2;     // A beat fell in this frame
+
+/**
+ * Quantizes analysis frames and writes them out as a feature track
+ */
+class FeatureTrackWriter {
+public:
+    FeatureTrackWriter();
+
+    bool initialize(int sampleRate, int hopSize, int spectrumBins, int numBands);
+
+    // Size of one frame record
+    size_t getFrameBytes() const { return m_frameBytes; }
+
+    // Quantize a frame into a record of getFrameBytes() bytes
+    void encode(const AudioData& frame, uint8_t flags, uint8_t* record) const;
+
+    // Write the header, the index and the records of consecutive frames, one per hop,
+    // the first becoming current at firstSampleTime
+    bool write(const std::string& path, const std::vector<uint8_t>& records, uint64_t firstSampleTime) const;
+
+private:
+    int m_sampleRate;
+    int m_hopSize;
+    int m_spectrumBins;
+    int m_numBands;
+    size_t m_frameBytes;
+};
+
+/**
+ * Reads a feature track in place from a memory mapping
+ */
+class FeatureTrackReader {
+public:
+    FeatureTrackReader();
+
+    // Map and validate the file
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // Frame current at the given time (-1 before the first one)
+    int findFrame(double seconds) const;
+
+    // Expand a frame into data's levels, spectrum and bands (vectors are resized to the track's sizes)
+    void decode(int frame, AudioData& data) const;
+
+    // FeatureTrackOnset / FeatureTrackBeat flags of a frame
+    uint8_t getFlags(int frame) const;
+
+    // Get properties
+    int getSampleRate() const { return static_cast<int>(m_header->sampleRate); }
+    int getHopSize() const { return static_cast<int>(m_header->hopSize); }
+    int getFrameCount() const { return static_cast<int>(m_header->frameCount); }
+    int getSpectrumBins() const { return static_cast<int>(m_header->spectrumBins); }
+    int getNumBands() const { return static_cast<int>(m_header->numBands); }
+    double getDuration() const;
+
+private:
+    MappedFile m_file;
+    const FeatureTrackHeader* m_header;
+    const FeatureTrackIndexEntry* m_index;
+};
+
+} // namespace av
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Frequency spacing of filterbank bands
+ */
+enum class FilterbankScale {
+    Log,            // Equal width in log frequency
+    Mel,            // Equal width on the mel scale
+    ThirdOctave     // Standard 1/3-octave centres (1 kHz * 2^(k/3)); band count follows the range
+};
+
+/**
+ * Maps FFT magnitude bins to perceptual bands with precomputed triangular weights
+ *
+ * Band b is a triangle rising from edge b to its centre at edge b+1 and
+ * falling to edge b+2, with weights normalized to sum to 1 so a band is the
+ * weighted mean of the bins under it. Weights are stored sparsely in
+ * compressed-row form. Because every triangle covers a contiguous run of
+ * bins, a row stores its first bin instead of one column index per weight,
+ * and applying the bank is one contiguous dot product per band.
+ */
+class Filterbank {
+public:
+    Filterbank();
+
+    // Build the weights for an fftSize-point transform (fftSize/2+1 bins)
+    bool initialize(FilterbankScale scale, int numBands, int fftSize, int sampleRate,
+                    float minFrequency = 20.0f, float maxFrequency = 20000.0f);
+
+    // Build the weights from explicit band edges (band b spans edges[b]..edges[b+2])
+    bool initialize(const std::vector<float>& edges, int fftSize, int sampleRate);
+
+    // Band edges for a scale over a frequency range (numBands + 2 edges, or the
+    // 1/3-octave edges that fit the range)
+    static bool computeEdges(FilterbankScale scale, int numBands, float minFrequency, float maxFrequency,
+                             std::vector<float>& edges);
+
+    // bands[b] = sum of weight * spectrum[bin] over the bins of band b
+    void apply(const float* spectrum, float* bands) const;
+
+    // Get properties
+    int getNumBands() const { return static_cast<int>(m_centerFrequencies.size()); }
+    int getNumBins() const { return m_numBins; }
+    FilterbankScale getScale() const { return m_scale; }
+    const std::vector<float>& getCenterFrequencies() const { return m_centerFrequencies; }
+    bool isInitialized() const { return m_numBins > 0; }
+
+    // Number of stored weights (for cost estimates)
+    size_t getNumWeights() const { return m_weights.size(); }
+
+private:
+    FilterbankScale m_scale;
+    int m_numBins;
+    std::vector<float> m_centerFrequencies;
+
+    // Compressed rows: band b owns m_weights[m_rowOffsets[b] .. m_rowOffsets[b+1])
+    // applied to bins starting at m_firstBin[b]
+    std::vector<int> m_rowOffsets;
+    std::vector<int> m_firstBin;
+    std::vector<float> m_weights;
+};
+
+} // namespace av
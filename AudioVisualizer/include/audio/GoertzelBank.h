@@ -0,0 +1,64 @@
+#pragma once
+
+#include "audio/DecimationChain.h"
+#include "audio/SlidingWindow.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Amplitude at a handful of fixed frequencies without a full FFT
+ *
+ * Each probe runs the Goertzel recurrence (one multiply-add per sample)
+ * over a Hann-windowed stretch of recent audio, whose length is set by the
+ * probe's bandwidth. A probe costs O(N) per update, so a few probes are far
+ * cheaper than a transform when only a few frequencies matter. Probes read
+ * the coarsest decimated stream that still holds their frequency, so narrow
+ * low-frequency probes stay cheap as well.
+ */
+class GoertzelBank {
+public:
+    GoertzelBank();
+
+    // Keep up to maxWindowSeconds of every stream of the chain for the probes to read.
+    // The chain must outlive this object; samples arrive through chain.process().
+    bool initialize(DecimationChain& chain, float maxWindowSeconds = 0.25f);
+
+    // Measure the amplitude around frequency over a band bandwidth Hz wide
+    // (the -6 dB width of the window's main lobe). Returns the probe index, or -1.
+    int addProbe(float frequency, float bandwidth);
+
+    // Remove all probes
+    void clearProbes();
+
+    // Run every probe over its latest window
+    void update();
+
+    // Amplitude from the last update (a full-scale sine at the probe frequency reads 1.0)
+    float getMagnitude(int probe) const { return m_probes[probe].magnitude; }
+
+    // Get properties
+    int getNumProbes() const { return static_cast<int>(m_probes.size()); }
+    int getDecimation(int probe) const { return 1 << m_probes[probe].stream; }
+    size_t getWindowSize(int probe) const { return m_probes[probe].window.size(); }
+
+private:
+    struct Probe {
+        int stream;                 // Reads stream 1/2^stream
+        float coefficient;          // 2 cos(w)
+        float scale;                // 2 / window sum
+        std::vector<float> window;  // Hann window over the probe's N samples
+        float magnitude;
+    };
+
+    int m_sampleRate;
+    float m_maxWindowSeconds;
+
+    // Recent samples of the full-rate stream and each decimated stream
+    std::vector<SlidingWindow> m_streams;
+    std::vector<Probe> m_probes;
+};
+
+} // namespace av
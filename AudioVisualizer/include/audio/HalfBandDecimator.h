@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Halves the sample rate with a linear-phase half-band lowpass
+ *
+ * Every other tap of a half-band filter is zero apart from the centre tap.
+ * Split into its two polyphase branches, the filter becomes a symmetric FIR
+ * over the even input samples plus a single delayed tap on the odd ones, and
+ * only outputs that are kept get computed: (taps + 1) / 4 multiplies per
+ * output sample. The even branch is vectorized across four outputs at a
+ * time. Each branch keeps its own history, so a stream can be pushed in
+ * blocks of any size (including odd sizes) and the output is identical to
+ * decimating it in one go.
+ */
+class HalfBandDecimator {
+public:
+    HalfBandDecimator();
+
+    // Design the filter; taps is rounded up to the next 4k+3 length (at least 7).
+    // Longer inputs are processed in blocks of maxBlockSize without allocating.
+    bool initialize(int taps = 31, size_t maxBlockSize = 1024);
+
+    // Clear the history (the next input is treated as the start of a stream)
+    void reset();
+
+    // Filter count input samples and write the decimated samples to output,
+    // which needs room for (count + 1) / 2 samples. Returns the number written.
+    size_t process(const float* input, size_t count, float* output);
+
+    // Get properties
+    int getNumTaps() const { return m_numTaps; }
+
+    // Delay of the filter in input samples
+    int getDelay() const { return (m_numTaps - 1) / 2; }
+
+private:
+    size_t processBlock(const float* input, size_t count, float* output);
+
+    int m_numTaps;
+    int m_halfLength;           // K for a 4K+3 tap filter
+    size_t m_maxBlockSize;
+
+    // Even branch taps g[0..K] (g[t] == g[2K+1-t]) and the odd branch's single tap
+    std::vector<float> m_evenTaps;
+    float m_centreTap;
+
+    // Branch histories (2K+1 even and K+1 odd samples) followed by the current block
+    std::vector<float> m_even;
+    std::vector<float> m_odd;
+    bool m_nextIsOdd;           // Parity of the next input sample in the stream
+};
+
+} // namespace av
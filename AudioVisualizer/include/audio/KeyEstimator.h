@@ -0,0 +1,48 @@
+#pragma once
+
+namespace av {
+
+/**
+ * Running estimate of the musical key from chroma frames
+ *
+ * Chroma is averaged with exponential decay (a memory of several seconds,
+ * so a chord change doesn't flip the key) and correlated with the
+ * Krumhansl-Kessler major and minor key profiles rotated to all 12 tonics.
+ * The profiles are stored zero-mean and unit-length, so each of the 24
+ * correlations is a single 12-element dot product.
+ */
+class KeyEstimator {
+public:
+    static const int NumPitchClasses = 12;
+
+    KeyEstimator();
+
+    // Chroma arrives frameRate times per second; memorySeconds is the averaging time constant
+    bool initialize(float frameRate, float memorySeconds = 8.0f);
+
+    // Forget the averaged chroma
+    void reset();
+
+    // Add one chroma frame (12 values, C first)
+    void process(const float* chroma);
+
+    // Tonic as a pitch class (0 = C ... 11 = B), -1 until there is enough to go on
+    int getKey() const { return m_key; }
+    bool isMinor() const { return m_minor; }
+
+    // Correlation of the averaged chroma with the winning profile (0-1)
+    float getConfidence() const { return m_confidence; }
+
+private:
+    float m_decay;
+
+    // Rows 0-11: major keys on C..B, rows 12-23: minor keys
+    alignas(16) float m_profiles[2 * NumPitchClasses][NumPitchClasses];
+    alignas(16) float m_average[NumPitchClasses];
+
+    int m_key;
+    bool m_minor;
+    float m_confidence;
+};
+
+} // namespace av
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Loudness meter after EBU R128 / ITU-R BS.1770
+ *
+ * Each channel is K-weighted (a high-shelf "head" filter then the RLB
+ * highpass, two biquads) and the channels' energies summed into short
+ * sub-blocks, so correlated stereo reads 3 dB above either channel alone.
+ * All channels weigh 1, as BS.1770 has it for left, right and centre. Momentary (400 ms)
+ * and short-term (3 s) loudness are running sums over a ring of sub-block
+ * energies: each finished sub-block is added and the one leaving the window
+ * subtracted, so updates cost the same whatever the window length.
+ *
+ * Integrated loudness gates the 400 ms blocks (one every 100 ms, 75% overlap)
+ * at -70 LUFS and then 10 LU below their average. Blocks are kept as a
+ * histogram of 0.1 LU bins with their summed energy, so the gated average is
+ * one pass over a fixed number of bins however long the programme runs.
+ */
+class LoudnessMeter {
+public:
+    // Absolute gate, and the floor of all reported values
+    static constexpr float SilenceLoudness = -70.0f;
+
+    LoudnessMeter();
+
+    bool initialize(int sampleRate, int channels = 1);
+
+    // Clear filter state, the windows and the integrated measurement
+    void reset();
+
+    // K-weight and measure count frames of interleaved samples, getChannels() per frame
+    void process(const float* frames, size_t count);
+
+    // Loudness in LUFS, SilenceLoudness until measured or when quieter than the gate
+    float getMomentary() const { return m_momentary; }
+    float getShortTerm() const { return m_shortTerm; }
+    float getIntegrated() const { return m_integrated; }
+
+    // Whether at least one gated block has counted towards the integrated loudness
+    bool hasIntegrated() const { return m_gatedBlocks > 0; }
+
+    int getSampleRate() const { return m_sampleRate; }
+    int getChannels() const { return m_channels; }
+
+private:
+    // Sub-blocks per second; 400 ms and 3 s are whole numbers of them
+    static const int SubBlocksPerSecond = 40;
+    static const int MomentarySubBlocks = 16;
+    static const int ShortTermSubBlocks = 120;
+    static const int GatingStepSubBlocks = 4;
+
+    static const int HistogramBins = 750;  // -70 to +5 LUFS
+
+    void finishSubBlock();
+    void updateIntegrated();
+
+    int m_sampleRate;
+    int m_channels;
+    int m_subBlockSize;
+
+    // Head shelf then RLB highpass: b0, b1, b2, a1, a2 each; per channel z1, z2 of each
+    double m_coefficients[2][5];
+    std::vector<double> m_state;
+
+    // Energy of the sub-block being filled
+    double m_subBlockEnergy;
+    int m_subBlockPosition;
+
+    // Mean square of the last ShortTermSubBlocks sub-blocks, and the running window sums
+    std::vector<double> m_subBlocks;
+    int m_subBlockIndex;
+    int64_t m_subBlocksSeen;
+    double m_momentarySum;
+    double m_shortTermSum;
+
+    // Gating blocks by loudness: count and summed mean square per bin
+    std::vector<int64_t> m_histogramCounts;
+    std::vector<double> m_histogramEnergy;
+    int64_t m_gatedBlocks;
+    double m_gatedEnergy;
+
+    float m_momentary;
+    float m_shortTerm;
+    float m_integrated;
+};
+
+} // namespace av
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Read-only memory mapping of a whole file
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file; returns false (and reports why) if it can't be opened or mapped
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+};
+
+} // namespace av
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "audio/Filterbank.h"
+#include "audio/DecimationChain.h"
+#include "audio/SlidingWindow.h"
+#include "audio/RealFFT.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * One resolution of a multi-resolution analysis
+ *
+ * The tier transforms fftSize samples taken at sampleRate / decimation, so
+ * its bins are as narrow as an fftSize * decimation transform at full rate.
+ * Bands whose centre lies below maxFrequency (and above the previous tier's
+ * limit) are measured by this tier.
+ */
+struct ResolutionTier {
+    int decimation;         // Power of 2; 1 transforms the full-rate signal
+    int fftSize;            // Power of 2, in decimated samples
+    float maxFrequency;     // Upper limit for band centres (ignored for the last tier)
+};
+
+/**
+ * Filterbank bands measured with a window length that suits each frequency range
+ *
+ * Low bands need long windows to be resolved, high bands want short windows
+ * to stay responsive. Each tier keeps a sliding window of its stream and a
+ * filterbank over its share of the bands. Tiers subscribe to the streams of
+ * a shared DecimationChain, so the long window runs on a downsampled signal
+ * and costs a fraction of the equivalent full-rate transform.
+ *
+ * The bands are laid out exactly like a single Filterbank over the whole
+ * range. Each band reads the RMS amplitude of the signal under its triangle
+ * (a full-scale sine at a band centre reads 1.0), which unlike a mean over
+ * bins does not depend on the bin width of the tier that measured it, so
+ * levels line up across tier boundaries.
+ */
+class MultiResolutionSpectrum {
+public:
+    MultiResolutionSpectrum();
+
+    // Default tiers: 8192-point equivalent below 250 Hz, 2048 below 2 kHz, 512 above
+    static std::vector<ResolutionTier> getDefaultTiers();
+
+    // Split the bands of a scale over the tiers (sorted by ascending maxFrequency)
+    // and subscribe each tier to its stream. The chain needs enough stages for the
+    // largest decimation and must outlive this object; samples arrive through
+    // chain.process().
+    bool initialize(DecimationChain& chain, FilterbankScale scale, int numBands,
+                    float minFrequency = 20.0f, float maxFrequency = 20000.0f,
+                    const std::vector<ResolutionTier>& tiers = getDefaultTiers());
+
+    // Clear all input history
+    void reset();
+
+    // Transform the latest window of every tier and write all band amplitudes
+    void computeBands(float* bands);
+
+    // Get properties
+    int getNumBands() const { return static_cast<int>(m_centerFrequencies.size()); }
+    const std::vector<float>& getCenterFrequencies() const { return m_centerFrequencies; }
+    int getNumTiers() const { return static_cast<int>(m_tiers.size()); }
+    const ResolutionTier& getTier(int tier) const { return m_tiers[tier].config; }
+
+    // Bands [first, first + count) come from the given tier
+    int getTierFirstBand(int tier) const { return m_tiers[tier].firstBand; }
+    int getTierNumBands(int tier) const { return m_tiers[tier].filterbank.getNumBands(); }
+
+private:
+    struct Tier {
+        ResolutionTier config;
+        int firstBand;
+        SlidingWindow window;           // Latest fftSize samples of the tier's stream
+
+        RealFFT fft;
+        float powerScale;
+        std::vector<float> power;
+        Filterbank filterbank;
+    };
+
+    std::vector<Tier> m_tiers;
+    std::vector<float> m_centerFrequencies;
+    std::vector<float> m_bandBins;      // Bins under each band's triangle in its tier
+};
+
+} // namespace av
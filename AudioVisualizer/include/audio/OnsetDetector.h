@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+namespace av {
+
+/**
+ * Spectral-flux onset detector on filterbank bands
+ *
+ * Each frame the band magnitudes are log-compressed and the half-wave
+ * rectified increase over the previous frame is summed (spectral flux), so
+ * only rising energy counts and slow swells add little. An onset is a local
+ * flux peak above an adaptive threshold (a multiple of the median of the
+ * recent flux plus a fraction of the running peak). Peaks are confirmed one
+ * frame late, and a minimum spacing suppresses double triggers.
+ */
+class OnsetDetector {
+public:
+    OnsetDetector();
+
+    // numBands filterbank bands arriving at frameRate frames per second
+    bool initialize(int numBands, float frameRate);
+    void reset();
+
+    // Feed one frame of band magnitudes, returns true if an onset was confirmed
+    bool process(const float* bandMagnitudes);
+
+    // Half-wave rectified flux of the last frame (novelty curve for tempo tracking)
+    float getFlux() const { return m_flux; }
+
+    // Adaptive threshold in effect for the last frame
+    float getThreshold() const { return m_threshold; }
+
+    // Onset envelope (0.0-1.0): jumps to the onset strength and decays over ~100 ms,
+    // so consumers sampling slower than the frame rate still see every onset
+    float getOnsetStrength() const { return m_strength; }
+
+private:
+    int m_numBands;
+
+    // Log-compressed bands of the previous and current frame
+    std::vector<float> m_previousLog;
+    std::vector<float> m_currentLog;
+
+    // Recent flux values for the median threshold
+    std::vector<float> m_fluxHistory;
+    std::vector<float> m_medianScratch;
+    int m_historyPosition;
+    int m_historyCount;
+
+    // Peak picking state
+    float m_flux;
+    float m_previousFlux;
+    float m_previousPreviousFlux;
+    float m_threshold;
+    float m_fluxPeak;           // Slowly decaying maximum, for normalization
+    float m_peakDecay;
+    int m_framesSinceOnset;
+    int m_minOnsetFrames;
+
+    // Output envelope
+    float m_strength;
+    float m_strengthDecay;
+};
+
+} // namespace av
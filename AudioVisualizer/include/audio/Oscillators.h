@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Sine oscillator reading a shared wavetable
+ *
+ * The phase is a 32-bit fixed-point accumulator that wraps on its own, so
+ * the output depends only on the frequency and the number of samples
+ * generated, never on floating-point drift. The top bits index the table and
+ * the rest interpolate linearly between neighbouring entries, which keeps
+ * harmonics below -100 dB for a table-lookup and a multiply-add per sample.
+ */
+class WavetableOscillator {
+public:
+    WavetableOscillator();
+
+    void setFrequency(double frequencyHz, int sampleRate);
+
+    // Scale the frequency (for exponential glides without recomputing it)
+    void scaleFrequency(double factor);
+
+    void reset() { m_phase = 0; }
+
+    float next()
+    {
+        const uint32_t index = m_phase >> FractionBits;
+        const float fraction = static_cast<float>(m_phase & FractionMask) * (1.0f / (FractionMask + 1.0f));
+        const float a = m_table[index];
+        const float b = m_table[index + 1];
+        m_phase += m_increment;
+        return a + (b - a) * fraction;
+    }
+
+private:
+    static const int TableBits = 11;
+    static const int FractionBits = 32 - TableBits;
+    static const uint32_t FractionMask = (1u << FractionBits) - 1;
+
+    const float* m_table;       // 2^TableBits entries and a guard copy of the first
+    uint32_t m_phase;
+    uint32_t m_increment;       // Phase step per sample, in 2^-32 cycles
+    double m_increment64;       // Unrounded step, so repeated scaling doesn't accumulate rounding
+};
+
+/**
+ * Seedable white and pink noise
+ *
+ * White noise comes from a xorshift generator, so a seed reproduces the same
+ * samples on every platform. Pink noise filters it with three one-pole
+ * sections whose sum approximates a -3 dB/octave slope to within 0.5 dB over
+ * the audio band.
+ */
+class NoiseGenerator {
+public:
+    explicit NoiseGenerator(uint32_t seed = 1);
+
+    // Restart the sequence and clear the pink filter
+    void seed(uint32_t seed);
+
+    // Uniform in [-1, 1)
+    float white()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return static_cast<float>(static_cast<int32_t>(m_state)) * (1.0f / 2147483648.0f);
+    }
+
+    // About -12 dBFS RMS, with peaks a little past 1
+    float pink()
+    {
+        const float input = white();
+        m_pink0 = 0.99765f * m_pink0 + input * 0.0990460f;
+        m_pink1 = 0.96300f * m_pink1 + input * 0.2965164f;
+        m_pink2 = 0.57000f * m_pink2 + input * 1.0526913f;
+        return (m_pink0 + m_pink1 + m_pink2 + input * 0.1848f) * PinkGain;
+    }
+
+private:
+    static constexpr float PinkGain = 0.15f;
+
+    uint32_t m_state;
+    float m_pink0;
+    float m_pink1;
+    float m_pink2;
+};
+
+} // namespace av
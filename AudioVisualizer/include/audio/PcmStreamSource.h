@@ -0,0 +1,54 @@
+#pragma once
+
+#include "audio/AudioSource.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Reads raw interleaved PCM from stdin or a named pipe
+ *
+ * The stream has no header, so rate, channel count and sample format come
+ * from the configuration. Data is consumed as fast as the writer produces
+ * it, so the writer is expected to run in real time (e.g. `ffmpeg -re` or a
+ * capture tool). When the writer of a named pipe goes away the source waits
+ * for the next one.
+ */
+class PcmStreamSource : public AudioSource {
+public:
+    // path "-" reads stdin
+    PcmStreamSource(const std::string& path, int sampleRate, int channels, SampleFormat format);
+    ~PcmStreamSource() override;
+
+    bool initialize(int sampleRate) override;
+    bool start(RingBuffer& ring) override;
+    void stop() override;
+    int getSampleRate() const override { return m_sampleRate; }
+    std::string getName() const override;
+
+private:
+    // Reader thread: read, convert whole frames into the ring, keep partial frames
+    void readLoop(RingBuffer* ring);
+
+    // Wait up to timeoutMs for data and read what is there; 0 on timeout, -1 on end of stream
+    int readSome(uint8_t* dest, size_t size, int timeoutMs);
+
+    std::string m_path;
+    int m_sampleRate;
+    int m_channels;
+    SampleFormat m_format;
+
+    int m_fd;
+    bool m_isStdin;
+    std::vector<uint8_t> m_readBuffer;
+
+    // Reader thread
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
+
+} // namespace av
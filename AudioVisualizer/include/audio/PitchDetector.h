@@ -0,0 +1,63 @@
+#pragma once
+
+#include "audio/RealFFT.h"
+
+#include <vector>
+
+namespace av {
+
+/**
+ * Fundamental frequency of the dominant periodic sound in a window
+ *
+ * Uses the McLeod pitch method: the normalized square difference function
+ *     n(t) = 2 r(t) / m(t),  m(t) = sum over j of x[j]^2 + x[j+t]^2
+ * is YIN's difference function d(t) = m(t) - 2 r(t) rescaled to [-1, 1], so
+ * it needs no cumulative normalization and peaks near 1 at the period. The
+ * autocorrelation r comes from two real FFTs of twice the window (power
+ * spectrum, then its transform back, which is the same forward transform
+ * since the power spectrum is real and even), and m from a running sum of
+ * squares, so a 2048-sample window costs O(N log N) instead of O(N^2).
+ *
+ * The period is the first peak reaching 90% of the highest one, refined
+ * by parabolic interpolation; its height is the confidence.
+ */
+class PitchDetector {
+public:
+    PitchDetector();
+
+    // Detect pitches between minFrequency and maxFrequency in windows of windowSize samples
+    bool initialize(int sampleRate, int windowSize = 2048, float minFrequency = 50.0f,
+                    float maxFrequency = 2000.0f);
+
+    // Estimate the pitch of windowSize contiguous samples
+    void process(const float* window);
+
+    // Fundamental in Hz from the last window (0 when nothing periodic was found)
+    float getPitch() const { return m_pitch; }
+
+    // How periodic the last window was (0-1); below ~0.5 the pitch is unreliable
+    float getConfidence() const { return m_confidence; }
+
+    // Get properties
+    int getWindowSize() const { return m_windowSize; }
+    int getSampleRate() const { return m_sampleRate; }
+
+private:
+    int m_sampleRate;
+    int m_windowSize;
+    int m_minLag;
+    int m_maxLag;
+
+    // Transform of twice the window, shared by both passes
+    RealFFT m_realFFT;
+
+    // Work buffers, sized once
+    std::vector<float> m_padded;        // Window, then the mirrored power spectrum
+    std::vector<float> m_squares;       // Running sum of squares
+    std::vector<float> m_nsdf;          // n(t) for t in 0..maxLag+1
+
+    float m_pitch;
+    float m_confidence;
+};
+
+} // namespace av
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+namespace av {
+
+/**
+ * Streaming quantiles of a value over a decaying memory
+ *
+ * Values land in a fixed histogram whose bins all decay by the same factor
+ * every add. Rather than scaling every bin, each new value is added with a
+ * weight that grows by 1/decay per add (the bins are rescaled on the rare
+ * occasions the weights get large). Decay then leaves every bin's share of
+ * the total unchanged, so each tracked quantile is a bin pointer with the
+ * weight below it, moved a step or two as values arrive: adds cost O(1)
+ * whatever the bin count, and memory is fixed.
+ */
+class QuantileSketch {
+public:
+    QuantileSketch();
+
+    // Track the given quantiles (0-1) of values in [minValue, maxValue], in numBins bins,
+    // forgetting with a time constant of memory adds
+    bool initialize(const std::vector<float>& quantiles, float minValue, float maxValue,
+                    int numBins, float memory);
+
+    // Forget everything added so far
+    void reset();
+
+    // Add one value (clamped to the range)
+    void add(float value);
+
+    // Estimate of the index'th tracked quantile (minValue until something is added)
+    float getQuantile(int index) const;
+
+    // Whether anything has been added since the last reset
+    bool isEmpty() const { return m_total <= 0.0; }
+
+private:
+    struct Tracker {
+        double fraction;    // Quantile being tracked
+        int bin;            // Bin holding it
+        double below;       // Weight in the bins below
+    };
+
+    void rescale();
+
+    float m_minValue;
+    float m_binWidth;
+    double m_growth;        // 1 / decay
+    double m_weight;        // Weight of the next value
+    double m_total;
+    std::vector<double> m_bins;
+    std::vector<Tracker> m_trackers;
+};
+
+} // namespace av
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+
+namespace av {
+
+class FFTPlan;
+
+/**
+ * Forward FFT of real-valued input
+ *
+ * N real samples are packed as N/2 complex values (even samples in the real
+ * part, odd samples in the imaginary part), transformed with the shared N/2
+ * plan and then untangled into the N/2+1 non-redundant bins. This costs about
+ * half of a full N-point complex transform and needs half the working memory.
+ * Packing deinterleaves straight into the split real/imaginary layout used by
+ * the SIMD kernels.
+ *
+ * Each instance owns its scratch buffer, so use one per analysis thread.
+ */
+class RealFFT {
+public:
+    RealFFT();
+
+    // Initialize for a power-of-two number of real samples (at least 2)
+    bool initialize(int size);
+
+    // Transform getSize() real samples, optionally applying the plan's Hann window
+    void forward(const float* input, bool applyWindow = true);
+
+    // Access the getNumBins() bins of the last transform
+    std::complex<float> getBin(int bin) const { return std::complex<float>(m_real[bin], m_imag[bin]); }
+    const float* getReal() const { return m_real.data(); }
+    const float* getImag() const { return m_imag.data(); }
+
+    // Write |X[k]| * scale for every bin
+    void getMagnitudes(float* output, float scale = 1.0f) const;
+
+    // Get properties
+    int getSize() const { return m_size; }
+    int getNumBins() const { return m_size / 2 + 1; }
+    bool isInitialized() const { return m_size > 0; }
+
+    // Window of the full transform size and its coefficient sum
+    const std::vector<float>& getWindow() const;
+    float getWindowSum() const;
+
+private:
+    int m_size;
+
+    // Half-size plan does the transform; full-size plan provides window and untangle twiddles
+    std::shared_ptr<const FFTPlan> m_halfPlan;
+    std::shared_ptr<const FFTPlan> m_fullPlan;
+
+    // Packed input in split layout, untangled in place into N/2+1 bins
+    std::vector<float> m_real;
+    std::vector<float> m_imag;
+};
+
+} // namespace av
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace av {
+
+/**
+ * Wait-free single-producer/single-consumer ring of float samples
+ *
+ * One thread (the capture backend) writes and one thread (analysis) reads.
+ * The read and write indices live on separate cache lines so the two sides
+ * don't false-share. Indices increase monotonically and are masked into the
+ * power-of-two storage, so full and empty states are unambiguous.
+ *
+ * When the producer outruns the consumer the newest samples are dropped and
+ * counted as an overrun; when the consumer asks for more than is buffered
+ * nothing is read and an underrun is counted.
+ */
+class RingBuffer {
+public:
+    RingBuffer() : m_mask(0) {}
+
+    // Allocate storage for at least minCapacity samples (rounded up to a power of 2).
+    // Not thread-safe; call before starting the producer and consumer.
+    void initialize(size_t minCapacity)
+    {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        m_buffer.assign(capacity, 0.0f);
+        m_mask = capacity - 1;
+        reset();
+    }
+
+    // Discard buffered samples and clear the counters (not thread-safe)
+    void reset()
+    {
+        m_writeIndex.value.store(0, std::memory_order_relaxed);
+        m_readIndex.value.store(0, std::memory_order_relaxed);
+        m_overrunSamples.store(0, std::memory_order_relaxed);
+        m_underruns.store(0, std::memory_order_relaxed);
+    }
+
+    // Producer: append up to count samples, returns how many were written
+    size_t write(const float* samples, size_t count)
+    {
+        return writeWith(count, [samples](float* dest, size_t offset, size_t n) {
+            std::copy(samples + offset, samples + offset + n, dest);
+        });
+    }
+
+    // Producer: let fill(dest, offset, n) produce samples [offset, offset + n)
+    // straight into ring storage, so sources can convert without a staging copy.
+    // fill is called at most twice (the free space may wrap). Returns how many
+    // samples were written; the rest are dropped and counted as an overrun.
+    template<typename Fill>
+    size_t writeWith(size_t count, Fill&& fill)
+    {
+        const size_t writeIndex = m_writeIndex.value.load(std::memory_order_relaxed);
+        const size_t readIndex = m_readIndex.value.load(std::memory_order_acquire);
+        const size_t space = getCapacity() - (writeIndex - readIndex);
+
+        const size_t toWrite = std::min(count, space);
+        if (toWrite < count) {
+            m_overrunSamples.fetch_add(count - toWrite, std::memory_order_relaxed);
+        }
+
+        // Fill in up to two pieces around the wrap point
+        const size_t start = writeIndex & m_mask;
+        const size_t firstPart = std::min(toWrite, getCapacity() - start);
+        if (firstPart > 0) {
+            fill(m_buffer.data() + start, size_t(0), firstPart);
+        }
+        if (toWrite > firstPart) {
+            fill(m_buffer.data(), firstPart, toWrite - firstPart);
+        }
+
+        m_writeIndex.value.store(writeIndex + toWrite, std::memory_order_release);
+        return toWrite;
+    }
+
+    // Consumer: read exactly count samples, or nothing (and count an underrun)
+    bool read(float* output, size_t count)
+    {
+        const size_t readIndex = m_readIndex.value.load(std::memory_order_relaxed);
+        const size_t writeIndex = m_writeIndex.value.load(std::memory_order_acquire);
+        if (writeIndex - readIndex < count) {
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const size_t start = readIndex & m_mask;
+        const size_t firstPart = std::min(count, getCapacity() - start);
+        std::copy(m_buffer.begin() + start, m_buffer.begin() + start + firstPart, output);
+        std::copy(m_buffer.begin(), m_buffer.begin() + (count - firstPart), output + firstPart);
+
+        m_readIndex.value.store(readIndex + count, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: number of samples ready to read
+    size_t getReadAvailable() const
+    {
+        return m_writeIndex.value.load(std::memory_order_acquire) -
+               m_readIndex.value.load(std::memory_order_relaxed);
+    }
+
+    size_t getCapacity() const { return m_mask + 1; }
+
+    // Samples dropped because the ring was full
+    uint64_t getOverrunCount() const { return m_overrunSamples.load(std::memory_order_relaxed); }
+
+    // Reads that failed because not enough samples were buffered
+    uint64_t getUnderrunCount() const { return m_underruns.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t CacheLineSize = 64;
+
+    // Index padded out to a full cache line
+    struct alignas(CacheLineSize) PaddedIndex {
+        std::atomic<size_t> value{0};
+    };
+
+    std::vector<float> m_buffer;
+    size_t m_mask;
+
+    PaddedIndex m_writeIndex;   // Written by the producer only
+    PaddedIndex m_readIndex;    // Written by the consumer only
+
+    alignas(CacheLineSize) std::atomic<uint64_t> m_overrunSamples{0};
+    std::atomic<uint64_t> m_underruns{0};
+};
+
+} // namespace av
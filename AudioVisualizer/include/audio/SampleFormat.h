@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Encodings of interleaved little-endian PCM delivered by audio sources
+ */
+enum class SampleFormat {
+    Int16,      // 16-bit signed
+    Int24,      // 24-bit signed, packed in 3 bytes
+    Int32,      // 32-bit signed
+    Float32     // 32-bit IEEE float
+};
+
+// Most interleaved channels a source may deliver (7.1 and beyond fit easily)
+const int MaxSampleChannels = 32;
+
+// Size of one sample of the given format in bytes
+int getBytesPerSample(SampleFormat format);
+
+// Short name used on the command line (s16, s24, s32, f32)
+const char* getSampleFormatName(SampleFormat format);
+bool parseSampleFormat(const std::string& name, SampleFormat& format);
+
+// Convert frames of interleaved samples (at most MaxSampleChannels) to mono float by
+// averaging the channels. Both conversions run on SampleKernels::best().
+void convertToMono(const void* input, SampleFormat format, int channels, size_t frames, float* output);
+
+// Convert frames of interleaved samples to interleaved left/right float frames. Mono goes to
+// both sides; channels after the first two are shared equally between them, so the average
+// of left and right is the channel average convertToMono gives.
+void convertToStereo(const void* input, SampleFormat format, int channels, size_t frames, float* output);
+
+} // namespace av
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "audio/SampleFormat.h"
+
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Kernels that bring source PCM into the analysis ring
+ *
+ * Decoding turns interleaved samples of any SampleFormat into floats in
+ * [-1, 1). Channels are then split into planes, mixed by a coefficient
+ * matrix and interleaved again, so every kernel walks contiguous memory and
+ * the SIMD sets can process four samples or frames per step. Integer decoding
+ * is exact, so all kernel sets produce the same floats; only the matrix mix
+ * may differ from the scalar reference by rounding.
+ */
+struct SampleKernels {
+    // Decode samples of one format (unaligned input) to float
+    using Decode = void (*)(const void* input, size_t samples, float* output);
+
+    // Split interleaved frames into one plane per channel
+    using Deinterleave = void (*)(const float* input, int channels, size_t frames, float* const* planes);
+
+    // Join one plane per channel into interleaved frames
+    using Interleave = void (*)(const float* const* planes, int channels, size_t frames, float* output);
+
+    // outputs[o][f] = sum over c of matrix[o * inputChannels + c] * inputs[c][f]
+    using Downmix = void (*)(const float* const* inputs, int inputChannels, size_t frames,
+                             const float* matrix, int outputChannels, float* const* outputs);
+
+    const char* name;
+    Decode decodeInt16;
+    Decode decodeInt24;
+    Decode decodeInt32;
+    Decode decodeFloat32;
+    Deinterleave deinterleave;
+    Interleave interleave;
+    Downmix downmix;
+
+    // Decoder for the given format
+    Decode getDecoder(SampleFormat format) const;
+
+    // Kernel sets; sse2() returns nullptr when not built for this target
+    static const SampleKernels& scalar();
+    static const SampleKernels* sse2();
+
+    // Fastest kernel set built for this target
+    static const SampleKernels& best();
+};
+
+} // namespace av
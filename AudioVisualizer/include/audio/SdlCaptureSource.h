@@ -0,0 +1,43 @@
+#pragma once
+
+#include "audio/AudioSource.h"
+
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Default SDL2 capture device (microphone / line-in / monitor source)
+ *
+ * The device is opened in its own format and channel layout when the sample
+ * kernels can decode it (SDL converts anything else to stereo float). SDL
+ * calls back on its own audio thread, which converts straight into the
+ * analysis ring.
+ */
+class SdlCaptureSource : public AudioSource {
+public:
+    SdlCaptureSource();
+    ~SdlCaptureSource() override;
+
+    bool initialize(int sampleRate) override;
+    bool start(RingBuffer& ring) override;
+    void stop() override;
+    int getSampleRate() const override { return m_sampleRate; }
+    std::string getName() const override { return "SDL audio capture"; }
+
+private:
+    // Sample format of an SDL_AudioFormat; false if the kernels can't decode it
+    static bool getSampleFormat(uint16_t sdlFormat, SampleFormat& format);
+
+    // SDL audio callback (SDL's audio thread)
+    static void captureCallback(void* userdata, uint8_t* stream, int len);
+
+    uint32_t m_deviceId;        // SDL_AudioDeviceID
+    int m_sampleRate;
+    int m_channels;             // Of the opened device
+    SampleFormat m_format;
+    bool m_sdlAudioInitialized;
+    RingBuffer* m_ring;
+};
+
+} // namespace av
@@ -0,0 +1,44 @@
+#pragma once
+
+// SSE2 is part of the x86-64 baseline, so DSP code can use it without runtime dispatch.
+// Code using it keeps a scalar path under #else for other targets.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AV_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace av {
+
+#ifdef AV_SIMD_SSE2
+// Sum of the four lanes
+inline float horizontalSum(__m128 v)
+{
+    const __m128 high = _mm_movehl_ps(v, v);
+    const __m128 pair = _mm_add_ps(v, high);
+    const __m128 single = _mm_add_ss(pair, _mm_shuffle_ps(pair, pair, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(single);
+}
+#endif
+
+// Dot product of two float arrays
+inline float dotProduct(const float* a, const float* b, int count)
+{
+    int i = 0;
+#ifdef AV_SIMD_SSE2
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float sum = horizontalSum(_mm_add_ps(sum0, sum1));
+#else
+    float sum = 0.0f;
+#endif
+    for (; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+} // namespace av
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace av {
+
+/**
+ * Selected bins of an N-point DFT, updated sample by sample
+ *
+ * Each tracked bin follows the sliding DFT recurrence
+ *     X[n] = r e^(j2pi k/N) (X[n-1] + x[n] - r^N x[n-N])
+ * so every bin is current to the last sample processed, at a cost of one
+ * complex multiply per bin per sample instead of a transform per hop. The
+ * damping factor r (slightly below 1) makes round-off errors decay instead
+ * of accumulating forever, at the price of tilting the window towards
+ * recent samples.
+ *
+ * Bins run side by side in the lanes of SIMD vectors with the input sample
+ * broadcast, two vectors per group so the recurrences of one hide the
+ * latency of the other. With the Hann option each bin is combined with its
+ * two neighbours in the frequency domain (0.5 X[k] - 0.25 (X[k-1] + X[k+1])),
+ * which gives the same leakage as a Hann-windowed FFT frame.
+ */
+class SlidingDFT {
+public:
+    SlidingDFT();
+
+    // Track the given bins (1..windowSize/2-1) of a windowSize-point DFT
+    bool initialize(int windowSize, const std::vector<int>& bins, float damping = 0.9999f,
+                    bool hannWindow = true);
+
+    // Forget the input history
+    void reset();
+
+    // Slide every tracked bin across the samples
+    void process(const float* samples, size_t count);
+
+    // Amplitude of each requested bin, in request order (a full-scale sine in the bin reads 1.0)
+    void getMagnitudes(float* output) const;
+    float getMagnitude(int index) const;
+
+    // Get properties
+    int getWindowSize() const { return m_windowSize; }
+    int getNumBins() const { return static_cast<int>(m_bins.size()); }
+    int getNumTrackedBins() const { return m_numTracked; }
+    const std::vector<int>& getBins() const { return m_bins; }
+
+private:
+    static const int Lanes = 8;
+
+    void processGroup(int group, const float* deltas, size_t count);
+
+    int m_windowSize;
+    float m_dampingN;               // r^N, applied to the sample leaving the window
+    bool m_hannWindow;
+    float m_scale;                  // 2 / effective window sum
+
+    // Requested bins and the lanes holding each one and its neighbours
+    std::vector<int> m_bins;
+    std::vector<int> m_lowerLane;
+    std::vector<int> m_centreLane;
+    std::vector<int> m_upperLane;
+
+    // Tracked bins in groups of eight lanes: rotation r e^(j2pi k/N) and running sums
+    int m_numTracked;
+    int m_numGroups;
+    std::vector<float> m_rotationRe;
+    std::vector<float> m_rotationIm;
+    std::vector<float> m_sumRe;
+    std::vector<float> m_sumIm;
+
+    // Last N input samples, and x[n] - r^N x[n-N] for the current block
+    std::vector<float> m_history;
+    int m_historyPosition;
+    std::vector<float> m_deltas;
+};
+
+} // namespace av
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace av {
+
+/**
+ * The most recent N samples of a stream, always readable as one contiguous block
+ *
+ * Samples are stored twice, at i and i + N, so the window starting at the
+ * write position runs oldest to newest without wrapping and can be handed
+ * straight to a transform without copying.
+ */
+class SlidingWindow {
+public:
+    SlidingWindow() : m_size(0), m_writePosition(0) {}
+
+    // Allocate a window of size samples (not thread-safe)
+    void initialize(size_t size)
+    {
+        m_size = size;
+        m_buffer.assign(2 * size, 0.0f);
+        m_writePosition = 0;
+    }
+
+    // Fill the window with silence
+    void reset()
+    {
+        std::fill(m_buffer.begin(), m_buffer.end(), 0.0f);
+        m_writePosition = 0;
+    }
+
+    // Append samples, dropping the oldest
+    void push(const float* samples, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            m_buffer[m_writePosition] = samples[i];
+            m_buffer[m_writePosition + m_size] = samples[i];
+            if (++m_writePosition == m_size) {
+                m_writePosition = 0;
+            }
+        }
+    }
+
+    // The window, oldest sample first
+    const float* data() const { return m_buffer.data() + m_writePosition; }
+    size_t size() const { return m_size; }
+
+private:
+    std::vector<float> m_buffer;
+    size_t m_size;
+    size_t m_writePosition;
+};
+
+} // namespace av
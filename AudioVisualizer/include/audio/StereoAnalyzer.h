@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+namespace av {
+
+class FFTPlan;
+
+enum class StereoChannel {
+    Left,
+    Right,
+    Mid,        // (L + R) / 2
+    Side        // (L - R) / 2
+};
+
+/**
+ * Stereo image of interleaved left/right frames
+ *
+ * The left and right analysis frames are transformed together: the windowed
+ * left channel goes in the real part and the right channel in the imaginary
+ * part of one N-point complex FFT. Both are real, so their spectra separate
+ * again from the symmetry of the result,
+ *   L[k] = (Z[k] + conj(Z[N-k])) / 2,  R[k] = (Z[k] - conj(Z[N-k])) / 2i
+ * and mid and side follow by linearity. Four spectra thus cost one complex
+ * transform and one untangling pass, under twice the real FFT of a mono frame.
+ *
+ * Each hop also updates the left/right correlation (smoothed sums of L*R,
+ * L*L and R*R) and takes a decimated set of goniometer points.
+ */
+class StereoAnalyzer {
+public:
+    StereoAnalyzer();
+
+    // frameSize must be a power of 2; correlation is smoothed over correlationSeconds
+    bool initialize(int frameSize, int hopSize, int sampleRate, int goniometerPoints,
+                    float correlationSeconds = 0.2f);
+
+    // Clear the frames, the correlation and the goniometer
+    void reset();
+
+    // Append one hop of interleaved left/right frames
+    void processHop(const float* frames);
+
+    // Transform the current left and right frames (windowed) with the packed FFT and
+    // separate the four magnitude spectra in one pass
+    void transform();
+
+    // |X[k]| of one channel for the getNumBins() bins of the last transform
+    const std::vector<float>& getMagnitudes(StereoChannel channel) const
+    {
+        return m_magnitudes[static_cast<int>(channel)];
+    }
+
+    // Correlation coefficient of left and right: 1 for mono, 0 for unrelated channels,
+    // -1 for opposite polarity (0 while silent)
+    float getCorrelation() const { return m_correlation; }
+
+    // Points of the newest hop, interleaved x, y: x = (L - R) / sqrt(2), y = (L + R) / sqrt(2),
+    // so mono lies on the vertical axis and out-of-phase content on the horizontal one
+    const std::vector<float>& getGoniometer() const { return m_goniometer; }
+
+    // Get properties
+    int getNumBins() const { return m_frameSize / 2 + 1; }
+    float getWindowSum() const;
+
+private:
+    int m_frameSize;
+    int m_hopSize;
+    std::shared_ptr<const FFTPlan> m_plan;
+
+    // Latest frame of each channel
+    std::vector<float> m_left;
+    std::vector<float> m_right;
+
+    // Packed transform: windowed left in the real part, windowed right in the imaginary part
+    std::vector<float> m_real;
+    std::vector<float> m_imag;
+    std::vector<float> m_magnitudes[4];     // Indexed by StereoChannel
+
+    // Exponentially smoothed products and the coefficient they give
+    float m_smoothing;          // Per-hop decay of the sums
+    float m_sumLR;
+    float m_sumLL;
+    float m_sumRR;
+    float m_correlation;
+
+    std::vector<float> m_goniometer;
+    int m_goniometerStep;       // Frames between points
+};
+
+} // namespace av
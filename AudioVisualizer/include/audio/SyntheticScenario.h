@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+namespace av {
+
+/**
+ * Test signals the synthetic source can generate
+ */
+enum class SyntheticScenario {
+    Tones,          // Fixed bass, mid and treble tones and a slowly sweeping one
+    Silence,        // Digital silence
+    PinkNoise,      // Pink noise at about -18 dBFS RMS
+    LogSweep,       // Exponential sine sweep from 20 Hz to 20 kHz, repeating every 10 s
+    Kick,           // Kick drum at 120 BPM
+    DenseMix,       // Kick, bass line, chord pad, off-beat hats and a noise bed at 120 BPM
+    Clipping        // The dense mix driven 12 dB into hard clipping
+};
+
+// Name used on the command line (tones, silence, pink-noise, log-sweep, kick-120, dense-mix, clipping)
+const char* getSyntheticScenarioName(SyntheticScenario scenario);
+bool parseSyntheticScenario(const std::string& name, SyntheticScenario& scenario);
+
+// Every scenario, for benchmarks that run them all
+const SyntheticScenario AllSyntheticScenarios[] = {
+    SyntheticScenario::Tones, SyntheticScenario::Silence, SyntheticScenario::PinkNoise,
+    SyntheticScenario::LogSweep, SyntheticScenario::Kick, SyntheticScenario::DenseMix,
+    SyntheticScenario::Clipping
+};
+
+} // namespace av
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "audio/AudioSource.h"
+#include "audio/SyntheticScenario.h"
+#include "audio/Oscillators.h"
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Test signal generator used when no real audio is available
+ *
+ * Synthesizes one of the SyntheticScenario signals from wavetable
+ * oscillators and seeded noise and delivers it in real time, so the regular
+ * analysis path sees it like any captured input. The output is a function of
+ * the scenario, the seed and the sample rate alone: two sources set up the
+ * same way produce identical samples, which makes runs over them comparable.
+ */
+class SyntheticSource : public AudioSource {
+public:
+    explicit SyntheticSource(SyntheticScenario scenario = SyntheticScenario::Tones, uint32_t seed = 1);
+    ~SyntheticSource() override;
+
+    bool initialize(int sampleRate) override;
+    bool start(RingBuffer& ring) override;
+    void stop() override;
+    int getSampleRate() const override { return m_sampleRate; }
+    std::string getName() const override;
+
+    // Generate the next count samples
+    void generate(float* output, size_t count);
+
+    // Restart the signal from its first sample
+    void reset();
+
+private:
+    // Generator thread: deliver blocks paced to the sample rate
+    void generateLoop(RingBuffer* ring);
+
+    // Per-scenario generators
+    void generateTones(float* output, size_t count);
+    void generateSweep(float* output, size_t count);
+    void generateMix(float* output, size_t count, bool kickOnly, float drive);
+
+    // Drum voices: retrigger on the beat, then decay
+    float nextKick();
+    float nextHat();
+
+    SyntheticScenario m_scenario;
+    uint32_t m_seed;
+    int m_sampleRate;
+    uint64_t m_position;            // Samples generated since reset
+
+    // Tones
+    WavetableOscillator m_bass;
+    WavetableOscillator m_mid;
+    WavetableOscillator m_treble;
+    WavetableOscillator m_sweep;
+    WavetableOscillator m_sweepLfo;
+
+    // Log sweep: per-sample frequency ratio and samples per sweep
+    double m_sweepRatio;
+    uint64_t m_sweepLength;
+
+    // Mix voices
+    NoiseGenerator m_noise;
+    WavetableOscillator m_kick;
+    float m_kickLevel;
+    float m_kickPitch;              // Frequency above the kick's base, in Hz
+    float m_clickLevel;
+    float m_hatLevel;
+    float m_hatPrevious;            // Last noise sample, for the hats' first-difference highpass
+    WavetableOscillator m_bassLine;
+    float m_bassLineLevel;
+    WavetableOscillator m_pad[3];
+    uint64_t m_beatLength;          // Samples per beat at 120 BPM
+
+    // Per-sample envelope decay factors
+    float m_kickDecay;
+    float m_kickPitchDecay;
+    float m_clickDecay;
+    float m_hatDecay;
+    float m_bassLineDecay;
+
+    // Generator thread
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
+
+} // namespace av
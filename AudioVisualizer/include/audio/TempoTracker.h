@@ -0,0 +1,68 @@
+#pragma once
+
+#include "audio/RealFFT.h"
+
+#include <vector>
+
+namespace av {
+
+/**
+ * Streaming tempo and beat-phase tracker driven by an onset novelty curve
+ *
+ * The last few seconds of novelty are kept in a ring. Every few frames the
+ * ring's autocorrelation is computed with the FFT engine (power spectrum,
+ * then a second forward transform of the symmetric power sequence). The
+ * strongest lag in the tempo range, weighted towards 120 BPM, gives the
+ * tempo. Beat phase advances at that tempo and is pulled towards detected
+ * onsets that land near an expected beat.
+ */
+class TempoTracker {
+public:
+    TempoTracker();
+
+    // Novelty arrives at frameRate frames per second
+    bool initialize(float frameRate, float windowSeconds = 6.0f, float minBpm = 60.0f, float maxBpm = 200.0f);
+    void reset();
+
+    // Feed one novelty value and whether an onset was detected in this frame
+    void process(float novelty, bool onset);
+
+    // Tempo estimate in BPM (0 until enough novelty has been seen)
+    float getBpm() const { return m_bpm; }
+
+    // Position within the current beat (0.0-1.0, beats fall on 0)
+    float getBeatPhase() const { return m_phase; }
+
+    // Normalized autocorrelation at the chosen lag (0.0-1.0)
+    float getConfidence() const { return m_confidence; }
+
+private:
+    // Recompute the tempo from the novelty ring
+    void estimateTempo();
+
+    float m_frameRate;
+
+    // Novelty ring (power-of-two length)
+    std::vector<float> m_novelty;
+    int m_writePosition;
+    int m_framesSeen;
+
+    // Autocorrelation via two real FFTs of twice the ring length
+    RealFFT m_fft;
+    std::vector<float> m_fftInput;
+    std::vector<float> m_autocorrelation;
+
+    // Lag search range and tempo prior
+    int m_minLag;
+    int m_maxLag;
+    std::vector<float> m_lagWeights;
+
+    int m_updateInterval;
+    int m_framesUntilUpdate;
+
+    float m_bpm;
+    float m_phase;
+    float m_confidence;
+};
+
+} // namespace av
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace av {
+
+/**
+ * Lock-free triple buffer for handing the latest value from one thread to another
+ *
+ * The producer fills its private back slot and publishes it by swapping it
+ * with the shared middle slot; the consumer swaps the middle slot with its
+ * private front slot when a newer value is waiting. Neither side ever waits,
+ * the consumer always sees the most recent complete value, and values the
+ * consumer never picked up are simply overwritten.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : m_middle(1)
+        , m_backIndex(0)
+        , m_frontIndex(2)
+    {
+    }
+
+    // Apply fn to every slot, e.g. to preallocate (not thread-safe; call before sharing)
+    template<typename Fn>
+    void forEach(Fn&& fn)
+    {
+        for (T& slot : m_slots) {
+            fn(slot);
+        }
+    }
+
+    // Producer: slot to fill for the next publish()
+    T& getWriteBuffer() { return m_slots[m_backIndex]; }
+
+    // Producer: make the write buffer the newest value
+    void publish()
+    {
+        const uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_backIndex | FreshBit),
+                                                   std::memory_order_acq_rel);
+        m_backIndex = previous & IndexMask;
+    }
+
+    // Consumer: switch to the newest published value, returns false if nothing new arrived
+    bool acquire()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FreshBit) == 0) {
+            return false;
+        }
+        const uint8_t previous = m_middle.exchange(m_frontIndex, std::memory_order_acq_rel);
+        m_frontIndex = previous & IndexMask;
+        return true;
+    }
+
+    // Consumer: value from the last acquire(), stable until the next acquire()
+    const T& getReadBuffer() const { return m_slots[m_frontIndex]; }
+
+private:
+    static constexpr uint8_t IndexMask = 0x3;
+    static constexpr uint8_t FreshBit = 0x4;
+    static constexpr size_t CacheLineSize = 64;
+
+    T m_slots[3];
+
+    // Index of the shared slot plus a flag for "published but not yet acquired"
+    alignas(CacheLineSize) std::atomic<uint8_t> m_middle;
+
+    alignas(CacheLineSize) uint8_t m_backIndex;     // Producer only
+    alignas(CacheLineSize) uint8_t m_frontIndex;    // Consumer only
+};
+
+} // namespace av
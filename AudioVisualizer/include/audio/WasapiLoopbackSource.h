@@ -0,0 +1,66 @@
+#pragma once
+
+#include "audio/AudioSource.h"
+
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+
+// Fix potential std::min/max conflicts with Windows macros
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <mmdeviceapi.h>
+#include <Audioclient.h>
+
+namespace av {
+
+/**
+ * WASAPI loopback capture of the default render device (what you hear)
+ *
+ * A capture thread drains every packet, converting to stereo float straight
+ * into the analysis ring.
+ */
+class WasapiLoopbackSource : public AudioSource {
+public:
+    WasapiLoopbackSource();
+    ~WasapiLoopbackSource() override;
+
+    bool initialize(int sampleRate) override;
+    bool start(RingBuffer& ring) override;
+    void stop() override;
+    int getSampleRate() const override { return m_sampleRate; }
+    std::string getName() const override { return "WASAPI loopback"; }
+
+private:
+    // Capture thread: wait for packets and push them into the ring
+    void captureLoop(RingBuffer* ring);
+
+    // Release all WASAPI resources
+    void release();
+
+    // WASAPI interfaces for loopback capture
+    IMMDeviceEnumerator* m_enumerator;
+    IMMDevice* m_device;
+    IAudioClient* m_audioClient;
+    IAudioCaptureClient* m_captureClient;
+    WAVEFORMATEX* m_waveFormat;
+    HANDLE m_captureEvent;
+    bool m_comInitialized;
+    bool m_started;
+
+    // Mix format as a sample format
+    int m_sampleRate;
+    int m_channels;
+    SampleFormat m_format;
+
+    // Capture thread
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
+
+} // namespace av
+
+#endif // _WIN32
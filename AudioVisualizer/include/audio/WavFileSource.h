@@ -0,0 +1,63 @@
+#pragma once
+
+#include "audio/AudioSource.h"
+#include "audio/MappedFile.h"
+
+#include <atomic>
+#include <thread>
+
+namespace av {
+
+/**
+ * Plays a memory-mapped WAV file into the analysis ring in real time
+ *
+ * Supports 16-bit, 24-bit and 32-bit integer PCM and 32-bit float, including
+ * WAVE_FORMAT_EXTENSIBLE headers. Samples are decoded from the mapping
+ * straight into ring storage, and playback loops at the end of the file.
+ */
+class WavFileSource : public AudioSource {
+public:
+    explicit WavFileSource(const std::string& path, bool loop = true);
+    ~WavFileSource() override;
+
+    bool initialize(int sampleRate) override;
+    bool start(RingBuffer& ring) override;
+    void stop() override;
+    int getSampleRate() const override { return m_sampleRate; }
+    std::string getName() const override;
+
+    // Parsed stream properties (valid after initialize)
+    int getChannels() const { return m_channels; }
+    SampleFormat getFormat() const { return m_format; }
+    size_t getFrameCount() const { return m_frameCount; }
+
+    // Decode frames [firstFrame, firstFrame + count) to mono float (clamped to the file)
+    size_t readMono(size_t firstFrame, size_t count, float* output) const;
+
+    // The same as interleaved left/right float frames
+    size_t readStereo(size_t firstFrame, size_t count, float* output) const;
+
+private:
+    // Locate the fmt and data chunks
+    bool parseHeader();
+
+    // Playback thread: deliver blocks paced to the sample rate
+    void playbackLoop(RingBuffer* ring);
+
+    std::string m_path;
+    bool m_loop;
+    MappedFile m_file;
+
+    // Stream properties
+    int m_sampleRate;
+    int m_channels;
+    SampleFormat m_format;
+    const uint8_t* m_samples;       // Start of the data chunk inside the mapping
+    size_t m_frameCount;
+
+    // Playback thread
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
+
+} // namespace av
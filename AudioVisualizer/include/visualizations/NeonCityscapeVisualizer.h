@@ -58,9 +58,15 @@ private:
     void initRain();
     void initVehicles();
     
-    // Generate a random neon color
+    // Generate a random neon color (from the key's palette once a key is known)
     Color randomNeonColor();
     
+    // Palette derived from the current key: entry index of a fixed set of hues around the tonic
+    Color keyNeonColor(int index) const;
+    
+    // Recolor buildings and vehicles when the estimated key changes
+    void updateKeyPalette(const AudioData& audioData);
+    
     // Render elements
     void renderSkyline(Renderer* renderer);
     void renderBuilding(Renderer* renderer, const Building& building);
@@ -98,6 +104,7 @@ private:
     float m_trebleResponse; // High frequency response
     float m_beatIntensity;  // Beat detection intensity
     bool m_beatActive;      // Beat detection state
+    int m_paletteKey;       // Key the palette follows (tonic + 12 for minor, -1 for random colors)
     
     // Random number generator
     std::mt19937 m_rng;
@@ -21,6 +21,7 @@ public:
 
 private:
     // Audio processing methods
+    void processEnvelopeData(const AudioData& audioData);
     void processWaveformData(const AudioData& audioData);
     void processFrequencyData(const AudioData& audioData);
     float compressDynamics(float input, float threshold, float ratio, float makeupGain);
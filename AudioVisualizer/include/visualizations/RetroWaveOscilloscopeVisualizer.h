@@ -16,6 +16,7 @@ public:
 
     virtual void render(Renderer* renderer, const AudioData& audioData) override;
     virtual std::string getDescription() const override;
+    virtual void registerProbes(AudioProcessor& audioProcessor) override;
     void cleanup();
     void onResize(int width, int height);
     
@@ -96,6 +97,8 @@ private:
     // Animation state
     float m_time;
     float m_bassResponse;
+    int m_kickProbe;         // Goertzel probe on the kick drum fundamental (-1 if none)
+    float m_kickResponse;
     float m_midResponse;
     float m_trebleResponse;
     
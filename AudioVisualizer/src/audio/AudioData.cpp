@@ -1,4 +1,5 @@
 #include "AudioData.h"
+#include "audio/FFTPlan.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -18,8 +19,8 @@ AudioData::AudioData()
     frequencyData.resize(512, 0.0f);
     previousFrequencyData.resize(512, 0.0f);
     
-    // Generate Hann window for FFT processing
-    generateHannWindow(1024);
+    // Get the FFT plan for the default waveform size
+    preparePlan(1024);
 }
 
 AudioData::~AudioData() {
@@ -36,8 +37,8 @@ void AudioData::update(const float* samples, size_t sampleCount, int channels, i
         frequencyData.resize(sampleCount / 2, 0.0f);
         previousFrequencyData.resize(sampleCount / 2, 0.0f);
         
-        // Window size needs to match the waveform size
-        generateHannWindow(sampleCount);
+        // FFT size needs to match the waveform size
+        preparePlan(sampleCount);
     }
     
     // Copy samples to waveform data, averaging multiple channels if needed
@@ -103,41 +104,24 @@ void AudioData::update(const float* samples, size_t sampleCount, int channels, i
 }
 
 void AudioData::processFFT() {
-    // This is a simplified placeholder FFT implementation
-    // In a real implementation, you would use a proper FFT library like FFTW or DSP libraries
+    const size_t fftSize = m_fftInput.size();
+    const std::vector<float>& window = m_realFFT.getWindow();
     
-    // For now, we'll generate simulated frequency data from the waveform
-    // Note: This does not perform a real FFT, but gives a basic frequency response
-    
-    const size_t freqSize = waveformData.size() / 2;
-    std::vector<float> tempFreq(freqSize, 0.0f);
-    
-    // Apply window function to reduce spectral leakage
-    std::vector<float> windowedData(waveformData.size());
-    for (size_t i = 0; i < waveformData.size(); i++) {
-        windowedData[i] = waveformData[i] * m_window[i];
+    // Apply window function to reduce spectral leakage, zero-padding up to the FFT size
+    const size_t sampleCount = std::min(waveformData.size(), fftSize);
+    for (size_t i = 0; i < sampleCount; i++) {
+        m_fftInput[i] = waveformData[i] * window[i];
     }
+    std::fill(m_fftInput.begin() + sampleCount, m_fftInput.end(), 0.0f);
     
-    // Simulate frequency bands with simple filters
-    for (size_t i = 0; i < freqSize; i++) {
-        float amplitude = 0.0f;
-        
-        // Simple approximation - use different sample ranges for different frequency bands
-        // Lower frequencies capture more samples, higher frequencies use fewer samples
-        size_t range = waveformData.size() / (i + 1);
-        range = std::min(range, waveformData.size() / 4);
-        range = std::max(range, size_t(4));
-        
-        for (size_t j = 0; j < range; j++) {
-            size_t index = (i * j) % waveformData.size();
-            amplitude += std::abs(windowedData[index]);
-        }
-        
-        tempFreq[i] = amplitude / static_cast<float>(range);
-    }
+    // Real-input radix-2 FFT
+    m_realFFT.forward(m_fftInput.data(), false);
     
-    // Copy to the frequency data buffer
-    std::swap(frequencyData, tempFreq);
+    // Magnitude of each bin, scaled so a full-scale sine reads 1.0
+    const float scale = 2.0f / m_realFFT.getWindowSum();
+    for (size_t i = 0; i < frequencyData.size() && i < fftSize / 2; i++) {
+        frequencyData[i] = std::abs(m_realFFT.getBin(static_cast<int>(i))) * scale;
+    }
     
     // Normalize and smooth the frequency data
     normalizeFrequencyData();
@@ -170,14 +154,10 @@ void AudioData::normalizeFrequencyData(float smoothingFactor) {
     previousFrequencyData = frequencyData;
 }
 
-void AudioData::generateHannWindow(size_t size) {
-    m_window.resize(size);
-    
-    for (size_t i = 0; i < size; i++) {
-        // Hann window function: 0.5 * (1 - cos(2π*n/(N-1)))
-        m_window[i] = 0.5f * (1.0f - std::cos(2.0f * 3.14159f * static_cast<float>(i) / 
-                                           static_cast<float>(size - 1)));
-    }
+void AudioData::preparePlan(size_t size) {
+    const int fftSize = FFTPlan::nextPowerOfTwo(static_cast<int>(std::max<size_t>(size, 2)));
+    m_realFFT.initialize(fftSize);
+    m_fftInput.resize(fftSize, 0.0f);
 }
 
 float AudioData::getBassLevel() const {
@@ -0,0 +1,324 @@
+#include "audio/AudioDataLog.h"
+#include "AudioProcessor.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const char HeaderMagic[4] = { 'A', 'V', 'D', 'L' };
+const char FooterMagic[4] = { 'A', 'V', 'D', 'I' };
+const uint32_t Version = 2;
+
+static_assert(sizeof(AudioDataLogHeader) == 16, "log header must have no padding");
+static_assert(sizeof(AudioDataLogRecord) == 16, "log records must have no padding");
+static_assert(sizeof(AudioDataLogIndexEntry) == 16, "log index entries must have no padding");
+static_assert(sizeof(AudioDataLogFooter) == 16, "log footer must have no padding");
+
+template <typename T>
+void put(std::vector<uint8_t>& payload, const T& value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    payload.insert(payload.end(), bytes, bytes + sizeof(T));
+}
+
+void putVector(std::vector<uint8_t>& payload, const std::vector<float>& values)
+{
+    put(payload, static_cast<uint32_t>(values.size()));
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+    payload.insert(payload.end(), bytes, bytes + values.size() * sizeof(float));
+}
+
+// Bounds-checked walk through one record's payload
+class PayloadReader {
+public:
+    PayloadReader(const uint8_t* data, size_t size) : m_data(data), m_end(data + size) {}
+
+    template <typename T>
+    bool get(T& value)
+    {
+        if (static_cast<size_t>(m_end - m_data) < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, m_data, sizeof(T));
+        m_data += sizeof(T);
+        return true;
+    }
+
+    bool getVector(std::vector<float>& values)
+    {
+        uint32_t count = 0;
+        if (!get(count) || static_cast<size_t>(m_end - m_data) / sizeof(float) < count) {
+            return false;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), m_data, count * sizeof(float));
+        m_data += count * sizeof(float);
+        return true;
+    }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+};
+
+} // namespace
+
+AudioDataLogWriter::AudioDataLogWriter()
+    : m_offset(0)
+{
+}
+
+AudioDataLogWriter::~AudioDataLogWriter()
+{
+    close();
+}
+
+bool AudioDataLogWriter::open(const std::string& path, int sampleRate, int hopSize)
+{
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        std::cerr << "Failed to create AudioData log " << path << std::endl;
+        return false;
+    }
+
+    AudioDataLogHeader header;
+    std::memcpy(header.magic, HeaderMagic, sizeof(HeaderMagic));
+    header.version = Version;
+    header.sampleRate = static_cast<uint32_t>(sampleRate);
+    header.hopSize = static_cast<uint32_t>(hopSize);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_offset = sizeof(header);
+    m_index.clear();
+    return static_cast<bool>(m_file);
+}
+
+bool AudioDataLogWriter::append(const AudioData& frame, double timestamp)
+{
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    // Every field, in declaration order; the reader mirrors this exactly
+    std::vector<uint8_t>& payload = m_payload;
+    payload.clear();
+    put(payload, frame.energy);
+    put(payload, frame.bass);
+    put(payload, frame.mid);
+    put(payload, frame.treble);
+    put(payload, frame.transient);
+    put(payload, frame.onset);
+    put(payload, frame.bpm);
+    put(payload, frame.beatPhase);
+    put(payload, frame.pitchHz);
+    put(payload, frame.pitchConfidence);
+    put(payload, static_cast<int32_t>(frame.key));
+    put(payload, static_cast<int32_t>(frame.keyMinor ? 1 : 0));
+    put(payload, frame.keyConfidence);
+    put(payload, frame.loudnessMomentary);
+    put(payload, frame.loudnessShortTerm);
+    put(payload, frame.loudnessIntegrated);
+    putVector(payload, frame.spectrum);
+    putVector(payload, frame.bands);
+    putVector(payload, frame.chroma);
+    putVector(payload, frame.envelopes);
+    putVector(payload, frame.envelopeBlocks);
+    putVector(payload, frame.probes);
+    put(payload, frame.features);
+    putVector(payload, frame.waveform);
+    putVector(payload, frame.spectrumLeft);
+    putVector(payload, frame.spectrumRight);
+    putVector(payload, frame.spectrumMid);
+    putVector(payload, frame.spectrumSide);
+    put(payload, frame.stereoCorrelation);
+    putVector(payload, frame.goniometer);
+
+    AudioDataLogRecord record;
+    record.payloadBytes = static_cast<uint32_t>(payload.size());
+    record.reserved = 0;
+    record.timestamp = timestamp;
+    m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    m_file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    if (!m_file) {
+        std::cerr << "Failed to write to the AudioData log" << std::endl;
+        return false;
+    }
+
+    m_index.push_back({ timestamp, m_offset });
+    m_offset += sizeof(record) + payload.size();
+    return true;
+}
+
+void AudioDataLogWriter::close()
+{
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    AudioDataLogFooter footer;
+    footer.indexOffset = m_offset;
+    footer.frameCount = static_cast<uint32_t>(m_index.size());
+    std::memcpy(footer.magic, FooterMagic, sizeof(FooterMagic));
+    m_file.write(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(AudioDataLogIndexEntry));
+    m_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    m_file.close();
+}
+
+AudioDataLogReader::AudioDataLogReader()
+    : m_sampleRate(0)
+    , m_hopSize(0)
+{
+}
+
+bool AudioDataLogReader::open(const std::string& path)
+{
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = m_file.getData();
+    const size_t size = m_file.getSize();
+    AudioDataLogHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << path << " is not an AudioData log" << std::endl;
+        m_file.close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, HeaderMagic, sizeof(HeaderMagic)) != 0 || header.version != Version) {
+        std::cerr << path << " is not a version " << Version << " AudioData log" << std::endl;
+        m_file.close();
+        return false;
+    }
+    m_sampleRate = static_cast<int>(header.sampleRate);
+    m_hopSize = static_cast<int>(header.hopSize);
+
+    // Use the stored index when the log was closed cleanly, otherwise walk the records
+    AudioDataLogFooter footer;
+    bool indexed = false;
+    if (size >= sizeof(header) + sizeof(footer)) {
+        std::memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+        const uint64_t indexBytes = uint64_t(footer.frameCount) * sizeof(AudioDataLogIndexEntry);
+        indexed = std::memcmp(footer.magic, FooterMagic, sizeof(FooterMagic)) == 0 &&
+                  footer.indexOffset >= sizeof(header) &&
+                  footer.indexOffset + indexBytes + sizeof(footer) == size;
+        if (indexed) {
+            m_index.resize(footer.frameCount);
+            std::memcpy(m_index.data(), data + footer.indexOffset, indexBytes);
+            for (const AudioDataLogIndexEntry& entry : m_index) {
+                if (entry.offset + sizeof(AudioDataLogRecord) > footer.indexOffset) {
+                    indexed = false;
+                    break;
+                }
+            }
+        }
+    }
+    if (!indexed) {
+        std::cout << path << " was not closed cleanly, rebuilding its index" << std::endl;
+        rebuildIndex();
+    }
+    if (m_index.empty()) {
+        std::cerr << path << " holds no frames" << std::endl;
+        close();
+        return false;
+    }
+
+    std::cout << "AudioData log " << path << ": " << m_index.size() << " frames, " << getDuration() << " s"
+              << std::endl;
+    return true;
+}
+
+void AudioDataLogReader::rebuildIndex()
+{
+    const uint8_t* data = m_file.getData();
+    const size_t size = m_file.getSize();
+    m_index.clear();
+
+    // Stop at the first record that doesn't fit: the one being written when recording stopped
+    size_t offset = sizeof(AudioDataLogHeader);
+    while (offset + sizeof(AudioDataLogRecord) <= size) {
+        AudioDataLogRecord record;
+        std::memcpy(&record, data + offset, sizeof(record));
+        const size_t end = offset + sizeof(record) + record.payloadBytes;
+        if (end > size) {
+            break;
+        }
+        m_index.push_back({ record.timestamp, offset });
+        offset = end;
+    }
+}
+
+void AudioDataLogReader::close()
+{
+    m_file.close();
+    m_index.clear();
+}
+
+double AudioDataLogReader::getDuration() const
+{
+    // The last frame lasts as long as the one before it
+    const size_t count = m_index.size();
+    const double last = m_index.back().timestamp;
+    return (count > 1) ? last + (last - m_index[count - 2].timestamp) : last;
+}
+
+int AudioDataLogReader::findFrame(double seconds) const
+{
+    auto next = std::upper_bound(m_index.begin(), m_index.end(), seconds,
+        [](double time, const AudioDataLogIndexEntry& entry) { return time < entry.timestamp; });
+    return static_cast<int>(next - m_index.begin()) - 1;
+}
+
+bool AudioDataLogReader::decode(int frame, AudioData& data) const
+{
+    const uint8_t* base = m_file.getData() + m_index[frame].offset;
+    AudioDataLogRecord record;
+    std::memcpy(&record, base, sizeof(record));
+    if (m_index[frame].offset + sizeof(record) + record.payloadBytes > m_file.getSize()) {
+        return false;
+    }
+
+    PayloadReader payload(base + sizeof(record), record.payloadBytes);
+    int32_t key = -1;
+    int32_t keyMinor = 0;
+    const bool ok =
+        payload.get(data.energy) &&
+        payload.get(data.bass) &&
+        payload.get(data.mid) &&
+        payload.get(data.treble) &&
+        payload.get(data.transient) &&
+        payload.get(data.onset) &&
+        payload.get(data.bpm) &&
+        payload.get(data.beatPhase) &&
+        payload.get(data.pitchHz) &&
+        payload.get(data.pitchConfidence) &&
+        payload.get(key) &&
+        payload.get(keyMinor) &&
+        payload.get(data.keyConfidence) &&
+        payload.get(data.loudnessMomentary) &&
+        payload.get(data.loudnessShortTerm) &&
+        payload.get(data.loudnessIntegrated) &&
+        payload.getVector(data.spectrum) &&
+        payload.getVector(data.bands) &&
+        payload.getVector(data.chroma) &&
+        payload.getVector(data.envelopes) &&
+        payload.getVector(data.envelopeBlocks) &&
+        payload.getVector(data.probes) &&
+        payload.get(data.features) &&
+        payload.getVector(data.waveform) &&
+        payload.getVector(data.spectrumLeft) &&
+        payload.getVector(data.spectrumRight) &&
+        payload.getVector(data.spectrumMid) &&
+        payload.getVector(data.spectrumSide) &&
+        payload.get(data.stereoCorrelation) &&
+        payload.getVector(data.goniometer);
+    data.key = key;
+    data.keyMinor = keyMinor != 0;
+    return ok;
+}
+
+} // namespace av
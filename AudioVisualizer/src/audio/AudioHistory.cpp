@@ -0,0 +1,81 @@
+#include "audio/AudioHistory.h"
+#include "AudioProcessor.h"
+#include <algorithm>
+
+namespace av {
+
+AudioHistory::AudioHistory()
+    : m_capacity(0)
+    , m_spectrumSize(0)
+    , m_waveformSize(0)
+    , m_newest(0)
+    , m_count(0)
+{
+}
+
+void AudioHistory::initialize(size_t capacity, size_t spectrumSize, size_t waveformSize)
+{
+    m_capacity = std::max<size_t>(capacity, 1);
+    m_spectrumSize = spectrumSize;
+    m_waveformSize = waveformSize;
+
+    m_energy.assign(m_capacity, 0.0f);
+    m_bass.assign(m_capacity, 0.0f);
+    m_mid.assign(m_capacity, 0.0f);
+    m_treble.assign(m_capacity, 0.0f);
+    m_transient.assign(m_capacity, 0.0f);
+    m_spectra.assign(m_capacity * m_spectrumSize, 0.0f);
+    m_waveforms.assign(m_capacity * m_waveformSize, 0.0f);
+
+    clear();
+}
+
+void AudioHistory::clear()
+{
+    m_newest = m_capacity - 1;
+    m_count = 0;
+}
+
+// Copy up to `size` values into a row, zero-filling whatever the source lacks
+static void copyRow(const std::vector<float>& source, float* row, size_t size)
+{
+    const size_t copied = std::min(source.size(), size);
+    std::copy(source.begin(), source.begin() + copied, row);
+    std::fill(row + copied, row + size, 0.0f);
+}
+
+void AudioHistory::push(const AudioData& data)
+{
+    if (m_capacity == 0) {
+        return;
+    }
+
+    m_newest = (m_newest + 1) % m_capacity;
+    m_count = std::min(m_count + 1, m_capacity);
+
+    m_energy[m_newest] = data.energy;
+    m_bass[m_newest] = data.bass;
+    m_mid[m_newest] = data.mid;
+    m_treble[m_newest] = data.treble;
+    m_transient[m_newest] = data.transient;
+    copyRow(data.spectrum, m_spectra.data() + m_newest * m_spectrumSize, m_spectrumSize);
+    copyRow(data.waveform, m_waveforms.data() + m_newest * m_waveformSize, m_waveformSize);
+}
+
+FloatView AudioHistory::getSpectrum(size_t age) const
+{
+    FloatView view;
+    view.data = m_spectra.data() + slot(age) * m_spectrumSize;
+    view.size = m_spectrumSize;
+    return view;
+}
+
+FloatView AudioHistory::getWaveform(size_t age) const
+{
+    FloatView view;
+    view.data = m_waveforms.data() + slot(age) * m_waveformSize;
+    view.size = m_waveformSize;
+    return view;
+}
+
+} // namespace av
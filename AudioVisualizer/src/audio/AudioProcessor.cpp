@@ -1,57 +1,193 @@
 #include "AudioProcessor.h"
+#include "audio/RealFFT.h"
+#include "audio/FFTPlan.h"
+#include "audio/FFTKernels.h"
+#include "audio/RingBuffer.h"
+#include "audio/SyntheticSource.h"
+#include "audio/Filterbank.h"
+#include "audio/MultiResolutionSpectrum.h"
+#include "audio/DecimationChain.h"
+#include "audio/SlidingWindow.h"
+#include "audio/CrossoverFilterBank.h"
+#include "audio/GoertzelBank.h"
+#include "audio/SlidingDFT.h"
+#include "audio/FeatureExtractor.h"
+#include "audio/PitchDetector.h"
+#include "audio/Chromagram.h"
+#include "audio/KeyEstimator.h"
+#include "audio/LoudnessMeter.h"
+#include "audio/QuantileSketch.h"
+#include "audio/StereoAnalyzer.h"
+#include "audio/FastMath.h"
+#include "audio/SampleKernels.h"
+#include "audio/FeatureTrack.h"
+#include "audio/AudioDataLog.h"
+#include "audio/OnsetDetector.h"
+#include "audio/TempoTracker.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
-
-// SDL for audio capture
-#include <SDL.h>
-
-// Define M_PI if not available
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-// Fix potential std::min/max conflicts with Windows macros
-#ifdef _WIN32
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#endif
-
-// Windows-specific headers for audio loopback capture
-#ifdef _WIN32
-#include <Windows.h>
-#include <mmdeviceapi.h>
-#include <Audioclient.h>
-#include <Functiondiscoverykeys_devpkey.h>
-#endif
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <utility>
+#include <chrono>
 
 namespace av {
 
+namespace {
+
+// Decimated streams go down to 1/8 rate
+const int DecimationStages = 3;
+
+// The bass level comes from the 1/8-rate stream: 128 samples there cover the
+// same time and bins as the 1024-sample frame (23 ms, 43 Hz bins at 44.1 kHz)
+const int BassDecimation = 8;
+const int BassWindowSize = 128;
+
+// Crossover envelopes: bass, mid, presence and air, published four times per hop
+// (every ~3 ms for 512-sample hops at 44.1 kHz)
+const std::vector<float> EnvelopeCrossovers = { 250.0f, 2000.0f, 6000.0f };
+const int EnvelopeBlocksPerHop = 4;
+
+// Pitch windows of 46 ms at 44.1 kHz reach down to 50 Hz; higher rates get a
+// longer window so half of it still spans the 50 Hz period
+const int PitchWindowSize = 2048;
+const float PitchMinFrequency = 50.0f;
+
+// Chroma needs semitone resolution down to C2: 2048 samples of the 1/8-rate
+// stream give 2.7 Hz bins (a 370 ms window) and reach up to B6. Lower rates
+// take a less decimated stream (and a longer window, for the same bins) so
+// C7 stays inside the decimators' passband.
+const int ChromaDecimation = 8;
+const int ChromaWindowSize = 2048;
+const float ChromaTopFrequency = 2093.0f;       // C7, the upper edge of B6
+const float ChromaMaxBandwidth = 0.4f;          // Of the decimated rate
+
+// Auto gain: momentary loudness at the programme's loudness maps to this
+// energy, so +6 LU is full scale
+const float ReferenceEnergy = 0.5f;
+
+// The programme reference (integrated loudness) is kept within this many LU
+// of the short-term loudness, so a change of material pulls it along
+const float MaxReferenceDrift = 12.0f;
+
+// Adaptive bands: levels in dB are ranked against the band's last ~10 s,
+// in half-dB bins; 0.0 is the 10th percentile and 1.0 the 95th
+const float BandFloorDb = -90.0f;
+const float BandCeilingDb = 6.0f;
+const int BandBinsPerDb = 2;
+const float BandMemorySeconds = 10.0f;
+const float BandLowQuantile = 0.10f;
+const float BandHighQuantile = 0.95f;
+
+// A band that barely varies still spans this many dB, so noise isn't blown up to full scale
+const float MinBandRangeDb = 12.0f;
+
+// Goniometer points per hop (every 4th frame of a 512-sample hop)
+const int GoniometerPoints = 128;
+
+// Mid of the left and right planes
+const float MidMix[2] = { 0.5f, 0.5f };
+
+} // namespace
+
 // Implementation-specific data
 struct AudioProcessor::Impl {
-    SDL_AudioDeviceID deviceId;
-    SDL_AudioSpec wantedSpec;
-    SDL_AudioSpec obtainedSpec;
-    std::vector<float> buffer;
-    
-#ifdef _WIN32
-    // WASAPI-specific members for loopback capture
-    IMMDeviceEnumerator* pEnumerator = nullptr;
-    IMMDevice* pDevice = nullptr;
-    IAudioClient* pAudioClient = nullptr;
-    IAudioCaptureClient* pCaptureClient = nullptr;
-    WAVEFORMATEX* pWaveFormat = nullptr;
-    HANDLE captureEvent = nullptr;
-    bool wasapiInitialized = false;
-    UINT32 bufferFrameCount = 0;
-#endif
+    // Where samples come from, chosen at startup
+    AudioSourceConfig sourceConfig;
+    std::unique_ptr<AudioSource> source;
+    
+    // Source thread -> analysis ring
+    RingBuffer ring;                        // Interleaved left/right frames
+    std::vector<float> stereoBuffer;        // One hop of frames read from the ring
+    std::vector<float> channelPlanes;       // The hop split into left and right planes
+    std::vector<float> buffer;              // The hop mixed to mono (mid)
+    
+    // Decimated copies of the input for analysis that only needs low frequencies
+    DecimationChain decimation;
+    SlidingWindow bassWindow;
+    RealFFT bassFFT;
+    std::vector<float> bassSpectrum;
+    
+    // Per-sample band envelopes, fed from the full-rate stream
+    CrossoverFilterBank crossover;
+    size_t envelopeBlockCount = 0;          // Blocks recorded since the last hop was read
+    
+    // Goertzel probes: registrations queue up under the mutex and the analysis thread adopts them
+    GoertzelBank probes;
+    std::mutex probeMutex;
+    std::vector<std::pair<float, float>> probeRequests;    // Frequency and bandwidth in Hz
+    std::atomic<bool> probesPending{false};
+    std::vector<int> probeSlots;            // Bank index of each request (-1 if rejected)
+    
+    // Spectrum analysis
+    RealFFT realFFT;
+    Filterbank filterbank;
+    MultiResolutionSpectrum multiResolution;    // Replaces the filterbank when enabled
+    SlidingDFT slidingBands;                // Or this, one bin per band
+    std::vector<float> bandMagnitudes;      // Band amplitudes before level processing
+    
+    // Frame features: time-domain ones per hop, spectral ones from the raw spectrum
+    FeatureExtractor featureExtractor;
+    
+    // Pitch from a longer window of the full-rate stream
+    SlidingWindow pitchWindow;
+    PitchDetector pitchDetector;
+    bool pitchEnabled = false;              // Off when the detector can't run at this rate
+    
+    // Chroma and key from a long window of the decimated stream
+    SlidingWindow chromaWindow;
+    RealFFT chromaFFT;
+    std::vector<float> chromaSpectrum;
+    Chromagram chromagram;
+    KeyEstimator keyEstimator;
+    bool harmonyEnabled = false;            // Off (key -1) when chroma can't run at this rate
+    
+    // K-weighted loudness of the full-rate stream, driving the energy level
+    LoudnessMeter loudness;
+    
+    // Recent level distribution of each band, for adaptive normalization
+    std::vector<QuantileSketch> bandQuantiles;
+    
+    // Stereo image of live sources (AudioAnalysisConfig::stereo)
+    StereoAnalyzer stereo;
+    bool stereoEnabled = false;
+    int inputChannels = 1;                  // Of the hops read: 2 (L/R) from the ring, 1 offline
+    
+    // Onsets and tempo from the band magnitudes
+    OnsetDetector onsetDetector;
+    TempoTracker tempoTracker;
+    bool hasPreviousFrame = false;          // Smoothing needs a previous frame
+    int debugFrameCount = 0;                // Frames since the last level printout
+    int statsFrameCount = 0;                // Frames since the last ring health report
+    
+    // Offline analysis: samples of the hop being gathered in buffer
+    bool offline = false;
+    size_t offlineFill = 0;
+    
+    // Feature track or AudioData log replay, which replaces the source and the analysis
+    FeatureTrackReader track;
+    AudioDataLogReader log;
+    std::chrono::steady_clock::time_point playbackStart;
+    int replayFrame = -1;                   // Frame last published
+    
+    // Recording of published frames; the publishing thread appends under the mutex
+    std::mutex recordMutex;
+    std::unique_ptr<AudioDataLogWriter> recorder;
+    std::atomic<bool> recording{false};
+    std::chrono::steady_clock::time_point recordStart;
+    
+    // Analysis thread running at the hop rate
+    std::thread analysisThread;
+    std::atomic<bool> analysisRunning{false};
 };
 
 AudioProcessor::AudioProcessor()
     : m_impl(new Impl())
     , m_sampleRate(44100)
     , m_frameSize(1024)
+    , m_hopSize(512)
     , m_historySize(60)
     , m_audioAvailable(false)
     , m_bassFrequencyLimit(250.0f)
@@ -64,8 +200,21 @@ AudioProcessor::AudioProcessor()
     m_currentAudioData.mid = 0.0f;
     m_currentAudioData.treble = 0.0f;
     m_currentAudioData.transient = 0.0f;
+    m_currentAudioData.onset = 0.0f;
+    m_currentAudioData.bpm = 0.0f;
+    m_currentAudioData.beatPhase = 0.0f;
+    m_currentAudioData.pitchHz = 0.0f;
+    m_currentAudioData.pitchConfidence = 0.0f;
+    m_currentAudioData.key = -1;
+    m_currentAudioData.keyMinor = false;
+    m_currentAudioData.keyConfidence = 0.0f;
+    m_currentAudioData.loudnessMomentary = LoudnessMeter::SilenceLoudness;
+    m_currentAudioData.loudnessShortTerm = LoudnessMeter::SilenceLoudness;
+    m_currentAudioData.loudnessIntegrated = LoudnessMeter::SilenceLoudness;
+    m_currentAudioData.stereoCorrelation = 0.0f;
     m_currentAudioData.spectrum.resize(m_frameSize / 2 + 1, 0.0f);
     m_currentAudioData.waveform.resize(m_frameSize, 0.0f);
+    m_snapshots.forEach([this](AudioData& snapshot) { snapshot = m_currentAudioData; });
 }
 
 AudioProcessor::~AudioProcessor()
@@ -73,173 +222,419 @@ AudioProcessor::~AudioProcessor()
     shutdown();
 }
 
-bool AudioProcessor::initialize(int sampleRate, int frameSize)
+void AudioProcessor::setSourceConfig(const AudioSourceConfig& config)
 {
-    std::cout << "Initializing audio processor..." << std::endl;
+    m_impl->sourceConfig = config;
+}
+
+void AudioProcessor::setAnalysisConfig(const AudioAnalysisConfig& config)
+{
+    m_analysisConfig = config;
+}
+
+int AudioProcessor::registerProbe(float frequencyHz, float bandwidthHz)
+{
+    if (frequencyHz <= 0.0f || bandwidthHz <= 0.0f) {
+        std::cerr << "Invalid probe: " << frequencyHz << " Hz, " << bandwidthHz << " Hz wide" << std::endl;
+        return -1;
+    }
     
+    std::lock_guard<std::mutex> lock(m_impl->probeMutex);
+    m_impl->probeRequests.emplace_back(frequencyHz, bandwidthHz);
+    m_impl->probesPending.store(true, std::memory_order_release);
+    return static_cast<int>(m_impl->probeRequests.size()) - 1;
+}
+
+const std::vector<float>& AudioProcessor::getBandFrequencies() const
+{
+    return m_impl->filterbank.getCenterFrequencies();
+}
+
+bool AudioProcessor::initialize(int sampleRate, int frameSize)
+{
     m_sampleRate = sampleRate;
     m_frameSize = frameSize;
+    m_hopSize = frameSize / 2;    // 50% overlap between analysis frames
     
-    // Initialize SDL Audio subsystem
-    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
-        std::cerr << "SDL audio could not initialize! SDL Error: " << SDL_GetError() << std::endl;
+    // The spectrum comes from a real-input radix-2 FFT over one frame
+    if (!m_impl->realFFT.initialize(m_frameSize)) {
+        std::cerr << "Audio frame size must be a power of 2, got " << m_frameSize << std::endl;
         return false;
     }
+    std::cout << "FFT kernels: " << FFTKernels::best().name << std::endl;
     
-    // Resize buffers
-    m_impl->buffer.resize(m_frameSize, 0.0f);
-    m_currentAudioData.spectrum.resize(m_frameSize / 2 + 1, 0.0f);
-    m_currentAudioData.waveform.resize(m_frameSize, 0.0f);
+    // A feature track or AudioData log replaces both the source and the analysis
+    if (m_impl->sourceConfig.type == "track" || m_impl->sourceConfig.type == "replay") {
+        return initializeReplay();
+    }
     
-#ifdef _WIN32
-    // Initialize WASAPI for loopback capture
-    HRESULT hr = CoInitialize(nullptr);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to initialize COM library" << std::endl;
-        return false;
+    // Open the configured source
+    const AudioSourceConfig& config = m_impl->sourceConfig;
+    m_impl->source = AudioSource::create(config);
+    if (!m_impl->source || !m_impl->source->initialize(m_sampleRate)) {
+        if (config.type != "auto") {
+            std::cerr << "Failed to open audio source '" << config.type << "'" << std::endl;
+            m_impl->source.reset();
+            return false;
+        }
+        
+        // No capture backend available, fall back to test data
+        std::cout << "System audio capture not available, using test audio data instead." << std::endl;
+        m_impl->source = std::make_unique<SyntheticSource>(config.scenario, config.seed);
+        m_impl->source->initialize(m_sampleRate);
     }
     
-    // Create device enumerator
-    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
-                          __uuidof(IMMDeviceEnumerator), 
-                          reinterpret_cast<void**>(&m_impl->pEnumerator));
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create device enumerator" << std::endl;
+    // Analysis runs at the rate the source delivers
+    m_sampleRate = m_impl->source->getSampleRate();
+    
+    m_impl->stereoEnabled = m_analysisConfig.stereo;
+    m_impl->inputChannels = 2;
+    m_impl->offline = false;
+    if (!initializeAnalysis()) {
+        m_impl->source.reset();
         return false;
     }
     
-    // Get default audio render device (speakers/headphones)
-    hr = m_impl->pEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &m_impl->pDevice);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to get default audio endpoint" << std::endl;
+    // Half a second of left/right frames as headroom between the source thread and analysis
+    m_impl->ring.initialize(2 * std::max(m_sampleRate / 2, m_frameSize * 4));
+    
+    if (!m_impl->source->start(m_impl->ring)) {
+        std::cerr << "Failed to start audio source: " << m_impl->source->getName() << std::endl;
+        m_impl->source.reset();
         return false;
     }
+    m_audioAvailable = true;
+    
+    // Analysis follows the audio clock on its own thread
+    m_impl->analysisRunning = true;
+    m_impl->analysisThread = std::thread(&AudioProcessor::analysisLoop, this);
     
-    // Get audio client
-    hr = m_impl->pDevice->Activate(__uuidof(IAudioClient), CLSCTX_ALL,
-                                   nullptr, reinterpret_cast<void**>(&m_impl->pAudioClient));
-    if (FAILED(hr)) {
-        std::cerr << "Failed to activate audio client" << std::endl;
+    std::cout << "Audio processor initialized with " << m_impl->source->getName()
+              << " at " << m_sampleRate << " Hz" << std::endl;
+    return true;
+}
+
+bool AudioProcessor::initializeOffline(int sampleRate, int frameSize)
+{
+    m_sampleRate = sampleRate;
+    m_frameSize = frameSize;
+    m_hopSize = frameSize / 2;
+    
+    if (!m_impl->realFFT.initialize(m_frameSize)) {
+        std::cerr << "Audio frame size must be a power of 2, got " << m_frameSize << std::endl;
         return false;
     }
-    
-    // Get the mix format
-    hr = m_impl->pAudioClient->GetMixFormat(&m_impl->pWaveFormat);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to get mix format" << std::endl;
+    m_impl->offline = true;
+    m_impl->offlineFill = 0;
+    m_impl->stereoEnabled = false;
+    m_impl->inputChannels = 1;
+    return initializeAnalysis();
+}
+
+bool AudioProcessor::initializeAnalysis()
+{
+    // Perceptual bands over the audible range
+    const AudioAnalysisConfig& analysis = m_analysisConfig;
+    if (!m_impl->filterbank.initialize(analysis.bandScale, analysis.numBands, m_frameSize, m_sampleRate,
+                                       20.0f, m_maxFrequency)) {
         return false;
     }
     
-    // Create event for audio capture
-    m_impl->captureEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-    if (m_impl->captureEvent == nullptr) {
-        std::cerr << "Failed to create capture event" << std::endl;
+    // Low-rate streams, fed one hop at a time
+    Impl* impl = m_impl.get();
+    if (!impl->decimation.initialize(m_sampleRate, DecimationStages, m_hopSize) ||
+        !impl->bassFFT.initialize(BassWindowSize)) {
         return false;
     }
+    impl->bassWindow.initialize(BassWindowSize);
+    impl->bassSpectrum.assign(impl->bassFFT.getNumBins(), 0.0f);
+    impl->decimation.subscribe(BassDecimation, [impl](const float* samples, size_t count) {
+        impl->bassWindow.push(samples, count);
+    });
     
-    // Initialize the audio client for loopback capture
-    hr = m_impl->pAudioClient->Initialize(
-        AUDCLNT_SHAREMODE_SHARED,
-        AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
-        0, 0, m_impl->pWaveFormat, nullptr);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to initialize audio client for loopback" << std::endl;
+    // Band envelopes follow the audio sample by sample and are recorded at each block
+    if (!impl->crossover.initialize(m_sampleRate, EnvelopeCrossovers, 0.002f, 0.12f,
+                                    std::max(1, m_hopSize / EnvelopeBlocksPerHop))) {
         return false;
     }
+    const int numEnvelopes = impl->crossover.getNumBands();
+    impl->crossover.setBlockCallback([this](const float* levels, int numBands) {
+        recordEnvelopeBlock(levels, numBands);
+    });
+    impl->decimation.subscribe(1, [impl](const float* samples, size_t count) {
+        impl->crossover.process(samples, count);
+    });
     
-    // Set the event handle
-    hr = m_impl->pAudioClient->SetEventHandle(m_impl->captureEvent);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to set event handle" << std::endl;
+    // Probes read whichever stream holds their frequency
+    if (!impl->probes.initialize(impl->decimation)) {
         return false;
     }
+    impl->probeSlots.clear();
+    impl->probesPending = !impl->probeRequests.empty();
+    
+    // Same bands, each measured at the resolution that suits it
+    if (analysis.multiResolution) {
+        if (!m_impl->multiResolution.initialize(m_impl->decimation, analysis.bandScale, analysis.numBands,
+                                                20.0f, m_maxFrequency)) {
+            return false;
+        }
+        std::cout << "Multi-resolution bands:";
+        for (int tier = 0; tier < m_impl->multiResolution.getNumTiers(); tier++) {
+            const ResolutionTier& config = m_impl->multiResolution.getTier(tier);
+            std::cout << " " << m_impl->multiResolution.getTierNumBands(tier) << " x "
+                      << config.fftSize << "@" << (m_sampleRate / config.decimation) << " Hz";
+        }
+        std::cout << std::endl;
+    }
+    
+    // Or the bin nearest each band centre, slid along the full-rate stream
+    if (analysis.slidingBands) {
+        const float binWidth = static_cast<float>(m_sampleRate) / m_frameSize;
+        std::vector<int> bins;
+        for (float frequency : m_impl->filterbank.getCenterFrequencies()) {
+            bins.push_back(std::min(std::max(1, static_cast<int>(std::lround(frequency / binWidth))), m_frameSize / 2 - 1));
+        }
+        if (!impl->slidingBands.initialize(m_frameSize, bins)) {
+            return false;
+        }
+        impl->decimation.subscribe(1, [impl](const float* samples, size_t count) {
+            impl->slidingBands.process(samples, count);
+        });
+        std::cout << "Sliding DFT bands: " << impl->slidingBands.getNumTrackedBins() << " bins tracked" << std::endl;
+    }
     
-    // Get the buffer size
-    hr = m_impl->pAudioClient->GetBufferSize(&m_impl->bufferFrameCount);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to get buffer size" << std::endl;
+    // Features cover the same frame as the spectrum
+    if (!m_impl->featureExtractor.initialize(m_sampleRate, m_frameSize, m_hopSize)) {
         return false;
     }
     
-    // Get the capture client
-    hr = m_impl->pAudioClient->GetService(__uuidof(IAudioCaptureClient),
-                                         reinterpret_cast<void**>(&m_impl->pCaptureClient));
-    if (FAILED(hr)) {
-        std::cerr << "Failed to get capture client" << std::endl;
+    // Pitch over the last pitchWindowSize samples; the pipeline runs on without it if it can't start
+    const int pitchWindowSize = FFTPlan::nextPowerOfTwo(
+        std::max(PitchWindowSize, 2 * static_cast<int>(std::ceil(m_sampleRate / PitchMinFrequency))));
+    impl->pitchEnabled = impl->pitchDetector.initialize(m_sampleRate, pitchWindowSize, PitchMinFrequency);
+    if (impl->pitchEnabled) {
+        impl->pitchWindow.initialize(pitchWindowSize);
+        impl->decimation.subscribe(1, [impl](const float* samples, size_t count) {
+            impl->pitchWindow.push(samples, count);
+        });
+    } else {
+        std::cerr << "Pitch detection disabled at " << m_sampleRate << " Hz" << std::endl;
+        m_currentAudioData.pitchHz = 0.0f;
+        m_currentAudioData.pitchConfidence = 0.0f;
+    }
+    
+    // Loudness follows every sample, whatever the analysis mode: both channels of the
+    // ring's frames (fed by readHop), or the one channel offline analysis is given
+    if (!impl->loudness.initialize(m_sampleRate, impl->inputChannels)) {
         return false;
     }
+    if (impl->inputChannels == 1) {
+        impl->decimation.subscribe(1, [impl](const float* samples, size_t count) {
+            impl->loudness.process(samples, count);
+        });
+    }
     
-    // Start the capture
-    hr = m_impl->pAudioClient->Start();
-    if (FAILED(hr)) {
-        std::cerr << "Failed to start audio capture" << std::endl;
+    // Onset and tempo tracking run once per hop
+    const float frameRate = static_cast<float>(m_sampleRate) / m_hopSize;
+    if (!m_impl->onsetDetector.initialize(m_impl->filterbank.getNumBands(), frameRate) ||
+        !m_impl->tempoTracker.initialize(frameRate)) {
         return false;
     }
     
-    m_impl->wasapiInitialized = true;
-    m_audioAvailable = true;
+    // One sketch per band, fed once per hop
+    impl->bandQuantiles.assign(m_impl->filterbank.getNumBands(), QuantileSketch());
+    for (QuantileSketch& sketch : impl->bandQuantiles) {
+        if (!sketch.initialize({ BandLowQuantile, BandHighQuantile }, BandFloorDb, BandCeilingDb,
+                               static_cast<int>(BandCeilingDb - BandFloorDb) * BandBinsPerDb,
+                               BandMemorySeconds * frameRate)) {
+            return false;
+        }
+    }
     
-    std::cout << "WASAPI loopback capture initialized successfully" << std::endl;
-    std::cout << "Capturing at sample rate: " << m_impl->pWaveFormat->nSamplesPerSec << " Hz" << std::endl;
-    std::cout << "Channels: " << m_impl->pWaveFormat->nChannels << std::endl;
-    std::cout << "Bits per sample: " << m_impl->pWaveFormat->wBitsPerSample << std::endl;
+    // Chroma every hop too, with the key averaged over several seconds. Without it
+    // (a rate too low for the range even undecimated) key stays -1 for the session.
+    int chromaDecimation = ChromaDecimation;
+    while (chromaDecimation > 1 &&
+           ChromaTopFrequency > ChromaMaxBandwidth * m_sampleRate / chromaDecimation) {
+        chromaDecimation /= 2;
+    }
+    const int chromaWindowSize = ChromaWindowSize * (ChromaDecimation / chromaDecimation);
+    impl->harmonyEnabled = impl->chromaFFT.initialize(chromaWindowSize) &&
+                           impl->chromagram.initialize(chromaWindowSize, m_sampleRate / chromaDecimation) &&
+                           impl->keyEstimator.initialize(frameRate);
+    if (impl->harmonyEnabled) {
+        impl->chromaWindow.initialize(chromaWindowSize);
+        impl->chromaSpectrum.assign(impl->chromaFFT.getNumBins(), 0.0f);
+        impl->decimation.subscribe(chromaDecimation, [impl](const float* samples, size_t count) {
+            impl->chromaWindow.push(samples, count);
+        });
+    } else {
+        std::cerr << "Chroma and key detection disabled at " << m_sampleRate << " Hz" << std::endl;
+        m_currentAudioData.key = -1;
+        m_currentAudioData.keyMinor = false;
+        m_currentAudioData.keyConfidence = 0.0f;
+    }
     
-#else
-    // On non-Windows platforms, fall back to test data
-    std::cout << "System audio capture not implemented for this platform." << std::endl;
-    std::cout << "Using test audio data instead." << std::endl;
-    m_audioAvailable = true;
-#endif
+    // Resize buffers (snapshots are sized up front so publishing never allocates)
+    m_impl->buffer.resize(m_hopSize, 0.0f);
+    m_impl->bandMagnitudes.assign(m_impl->filterbank.getNumBands(), 0.0f);
+    m_currentAudioData.spectrum.resize(m_frameSize / 2 + 1, 0.0f);
+    m_currentAudioData.waveform.resize(m_frameSize, 0.0f);
+    m_currentAudioData.bands.assign(m_impl->filterbank.getNumBands(), 0.0f);
+    m_currentAudioData.chroma.assign(Chromagram::NumPitchClasses, 0.0f);
+    m_currentAudioData.envelopes.assign(numEnvelopes, 0.0f);
+    m_currentAudioData.envelopeBlocks.assign(EnvelopeBlocksPerHop * numEnvelopes, 0.0f);
     
-    std::cout << "Audio processor initialized" << std::endl;
+    // Stereo image: the goniometer every hop, spectra with the FFT stage
+    m_impl->stereoBuffer.resize(2 * m_hopSize, 0.0f);
+    m_impl->channelPlanes.resize(2 * m_hopSize, 0.0f);
+    size_t stereoBins = 0;
+    size_t goniometerSize = 0;
+    if (m_impl->stereoEnabled) {
+        if (!m_impl->stereo.initialize(m_frameSize, m_hopSize, m_sampleRate, GoniometerPoints)) {
+            return false;
+        }
+        stereoBins = analysis.spectrum ? m_impl->stereo.getNumBins() : 0;
+        goniometerSize = m_impl->stereo.getGoniometer().size();
+    }
+    m_currentAudioData.spectrumLeft.assign(stereoBins, 0.0f);
+    m_currentAudioData.spectrumRight.assign(stereoBins, 0.0f);
+    m_currentAudioData.spectrumMid.assign(stereoBins, 0.0f);
+    m_currentAudioData.spectrumSide.assign(stereoBins, 0.0f);
+    m_currentAudioData.goniometer.assign(goniometerSize, 0.0f);
+    m_snapshots.forEach([this](AudioData& snapshot) { snapshot = m_currentAudioData; });
+    m_impl->hasPreviousFrame = false;
+    m_history.initialize(m_historySize, m_currentAudioData.spectrum.size(), m_currentAudioData.waveform.size());
     return true;
 }
 
-void AudioProcessor::shutdown()
+bool AudioProcessor::initializeReplay()
 {
-#ifdef _WIN32
-    if (m_impl->wasapiInitialized) {
-        // Stop audio capture
-        if (m_impl->pAudioClient) {
-            m_impl->pAudioClient->Stop();
+    const std::string& path = m_impl->sourceConfig.path;
+    if (m_impl->sourceConfig.type == "replay") {
+        // A log holds whole frames, so the first one sizes every vector
+        AudioDataLogReader& log = m_impl->log;
+        if (!log.open(path)) {
+            return false;
         }
-        
-        // Release WASAPI resources
-        if (m_impl->pCaptureClient) {
-            m_impl->pCaptureClient->Release();
-            m_impl->pCaptureClient = nullptr;
+        if (!log.decode(0, m_currentAudioData)) {
+            std::cerr << "AudioData log " << path << " has a corrupt first frame" << std::endl;
+            log.close();
+            return false;
         }
-        
-        if (m_impl->pAudioClient) {
-            m_impl->pAudioClient->Release();
-            m_impl->pAudioClient = nullptr;
-        }
-        
-        if (m_impl->pWaveFormat) {
-            CoTaskMemFree(m_impl->pWaveFormat);
-            m_impl->pWaveFormat = nullptr;
-        }
-        
-        if (m_impl->pDevice) {
-            m_impl->pDevice->Release();
-            m_impl->pDevice = nullptr;
-        }
-        
-        if (m_impl->pEnumerator) {
-            m_impl->pEnumerator->Release();
-            m_impl->pEnumerator = nullptr;
+        m_sampleRate = log.getSampleRate();
+        m_hopSize = log.getHopSize();
+    } else {
+        // Frames come out of the file at the track's own rate and sizes
+        FeatureTrackReader& track = m_impl->track;
+        if (!track.open(path)) {
+            return false;
         }
+        m_sampleRate = track.getSampleRate();
+        m_hopSize = track.getHopSize();
+        m_currentAudioData.spectrum.assign(track.getSpectrumBins(), 0.0f);
+        m_currentAudioData.bands.assign(track.getNumBands(), 0.0f);
+    }
+    m_snapshots.forEach([this](AudioData& snapshot) { snapshot = m_currentAudioData; });
+    m_history.initialize(m_historySize, m_currentAudioData.spectrum.size(), m_currentAudioData.waveform.size());
+    
+    m_impl->replayFrame = -1;
+    setPlaybackPosition(0.0);
+    m_audioAvailable = true;
+    
+    std::cout << "Audio processor replaying " << (m_impl->log.isOpen() ? "AudioData log " : "feature track ")
+              << path << std::endl;
+    return true;
+}
+
+void AudioProcessor::setPlaybackPosition(double seconds)
+{
+    // The clock runs at wall-clock rate; replayFrame() scales it by the replay speed
+    const float speed = m_impl->sourceConfig.replaySpeed;
+    const double wallSeconds = (speed > 0.0f) ? seconds / speed : 0.0;
+    m_impl->playbackStart = std::chrono::steady_clock::now() -
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(wallSeconds));
+    
+    // Stepping frame by frame continues from the frame current at that position
+    if (speed <= 0.0f) {
+        const int frame = m_impl->log.isOpen() ? m_impl->log.findFrame(seconds + m_impl->log.getTimestamp(0))
+                                               : m_impl->track.findFrame(seconds);
+        m_impl->replayFrame = std::max(0, frame) - 1;
+    }
+}
+
+bool AudioProcessor::startRecording(const std::string& path)
+{
+    auto recorder = std::make_unique<AudioDataLogWriter>();
+    if (!recorder->open(path, m_sampleRate, m_hopSize)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_impl->recordMutex);
+    m_impl->recorder = std::move(recorder);
+    m_impl->recordStart = std::chrono::steady_clock::now();
+    m_impl->recording = true;
+    std::cout << "Recording AudioData to " << path << std::endl;
+    return true;
+}
+
+void AudioProcessor::stopRecording()
+{
+    std::lock_guard<std::mutex> lock(m_impl->recordMutex);
+    m_impl->recording = false;
+    if (m_impl->recorder) {
+        std::cout << "Recorded " << m_impl->recorder->getFrameCount() << " AudioData frames" << std::endl;
+        m_impl->recorder.reset();
+    }
+}
+
+bool AudioProcessor::isRecording() const
+{
+    return m_impl->recording;
+}
+
+void AudioProcessor::analyzeOffline(const float* samples, size_t count,
+                                    const std::function<void(const AudioData&)>& onFrame)
+{
+    // Gather whole hops; a partial one waits for the next call
+    std::vector<float>& buffer = m_impl->buffer;
+    while (count > 0) {
+        const size_t take = std::min(count, buffer.size() - m_impl->offlineFill);
+        std::copy(samples, samples + take, buffer.begin() + m_impl->offlineFill);
+        m_impl->offlineFill += take;
+        samples += take;
+        count -= take;
         
-        if (m_impl->captureEvent) {
-            CloseHandle(m_impl->captureEvent);
-            m_impl->captureEvent = nullptr;
+        if (m_impl->offlineFill == buffer.size()) {
+            m_impl->offlineFill = 0;
+            processHop();
+            analyzeFrame();
+            onFrame(m_currentAudioData);
         }
+    }
+}
+
+void AudioProcessor::shutdown()
+{
+    // Stop analysis before its source
+    m_impl->analysisRunning = false;
+    if (m_impl->analysisThread.joinable()) {
+        m_impl->analysisThread.join();
+    }
+    
+    if (m_impl->source) {
+        // Stop the source before anything it writes to goes away
+        m_impl->source->stop();
+        m_impl->source.reset();
         
-        CoUninitialize();
-        m_impl->wasapiInitialized = false;
+        std::cout << "Capture ring overruns: " << getOverrunCount()
+                  << " frames, underruns: " << getUnderrunCount() << std::endl;
     }
-#endif
     
+    stopRecording();
+    m_impl->track.close();
+    m_impl->log.close();
+    m_impl->stereoEnabled = false;
     m_audioAvailable = false;
     std::cout << "Audio processor shutdown" << std::endl;
 }
@@ -271,342 +666,530 @@ void AudioProcessor::update()
         return;
     }
     
-#ifdef _WIN32
-    if (m_impl->wasapiInitialized) {
-        // Wait for capture event (with a timeout)
-        DWORD waitResult = WaitForSingleObject(m_impl->captureEvent, 10); // 10ms timeout
-        
-        // Capture audio data
-        UINT32 packetLength = 0;
-        HRESULT hr = m_impl->pCaptureClient->GetNextPacketSize(&packetLength);
-        if (SUCCEEDED(hr) && packetLength > 0) {
-            // Get the available data
-            BYTE* pData;
-            UINT32 numFramesAvailable;
-            DWORD flags;
-            
-            hr = m_impl->pCaptureClient->GetBuffer(&pData, &numFramesAvailable, &flags, nullptr, nullptr);
-            if (SUCCEEDED(hr)) {
-                // Copy the data to our buffer (converting to float)
-                UINT32 framesToProcess = std::min(numFramesAvailable, static_cast<UINT32>(m_frameSize));
-                UINT32 bytesPerSample = m_impl->pWaveFormat->wBitsPerSample / 8;
-                UINT32 numChannels = m_impl->pWaveFormat->nChannels;
-                
-                // Clear the waveform buffer
-                std::fill(m_currentAudioData.waveform.begin(), m_currentAudioData.waveform.end(), 0.0f);
-                
-                // Convert the captured audio data to float
-                for (UINT32 i = 0; i < framesToProcess; i++) {
-                    float sampleSum = 0.0f;
-                    
-                    // Mix all channels to mono
-                    for (UINT32 channel = 0; channel < numChannels; channel++) {
-                        float sample = 0.0f;
-                        
-                        // Convert based on bit depth
-                        if (bytesPerSample == 2) { // 16-bit
-                            int16_t* samples = reinterpret_cast<int16_t*>(pData);
-                            sample = static_cast<float>(samples[i * numChannels + channel]) / 32768.0f;
-                        } else if (bytesPerSample == 4) { // 32-bit or float
-                            if (m_impl->pWaveFormat->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) {
-                                float* samples = reinterpret_cast<float*>(pData);
-                                sample = samples[i * numChannels + channel];
-                            } else {
-                                int32_t* samples = reinterpret_cast<int32_t*>(pData);
-                                sample = static_cast<float>(samples[i * numChannels + channel]) / 2147483648.0f;
-                            }
-                        }
-                        
-                        sampleSum += sample;
-                    }
-                    
-                    // Average the channels
-                    float monoSample = sampleSum / static_cast<float>(numChannels);
-                    
-                    // Store in waveform buffer (if within range)
-                    if (i < m_currentAudioData.waveform.size()) {
-                        m_currentAudioData.waveform[i] = monoSample;
-                    }
-                }
-                
-                // Release the buffer
-                m_impl->pCaptureClient->ReleaseBuffer(numFramesAvailable);
-                
-                // Calculate RMS energy of the signal for better detection
-                float rmsEnergy = 0.0f;
-                for (size_t i = 0; i < m_currentAudioData.waveform.size(); i++) {
-                    rmsEnergy += m_currentAudioData.waveform[i] * m_currentAudioData.waveform[i];
-                }
-                rmsEnergy = sqrt(rmsEnergy / m_currentAudioData.waveform.size());
-                
-                // Apply improved dynamic range processing
-                
-                // 1. Apply logarithmic scaling for better responsiveness at high volumes
-                float logRmsEnergy = logScale(rmsEnergy);
-                
-                // 2. Apply dynamic range compression to control peaks
-                float compressedRmsEnergy = dynamicRangeCompression(logRmsEnergy, 0.3f, 0.6f);
-                
-                // 3. Apply a moderate boost to increase sensitivity for quieter sounds
-                const float sensitivityBoost = 1.0f; // Reduced from 2.0f to prevent maxing out
-                float processedEnergy = compressedRmsEnergy * sensitivityBoost;
-                
-                // 4. Ensure the value stays in 0-1 range
-                processedEnergy = std::min(1.0f, processedEnergy);
-                
-                // Debug output occasionally to see actual levels
-                static int frameCount = 0;
-                if (frameCount++ % 500 == 0) {
-                    std::cout << "Raw audio RMS energy: " << rmsEnergy 
-                              << " | Log-scaled: " << logRmsEnergy
-                              << " | Compressed: " << compressedRmsEnergy
-                              << " | Final: " << processedEnergy << std::endl;
-                }
-                
-                // Perform FFT on the captured data to get the spectrum
-                // In a real implementation, you would use a proper FFT library here
-                // For now, we'll use a simplified approximation of frequency bands
-                
-                // Clear spectrum first
-                std::fill(m_currentAudioData.spectrum.begin(), m_currentAudioData.spectrum.end(), 0.0f);
-                
-                // Very basic frequency analysis by checking different parts of the waveform
-                // This is not a real FFT but gives us some approximation to work with
-                
-                // For a real application, you should implement a proper FFT here
-                // This simple approach just divides the audio buffer into segments
-                const int numBands = m_currentAudioData.spectrum.size();
-                const int samplesPerBand = m_currentAudioData.waveform.size() / numBands;
-                
-                for (int band = 0; band < numBands; band++) {
-                    float bandEnergy = 0.0f;
-                    
-                    // Calculate energy in this band's segment of the waveform
-                    for (int i = 0; i < samplesPerBand; i++) {
-                        int sampleIndex = band * samplesPerBand + i;
-                        if (sampleIndex < m_currentAudioData.waveform.size()) {
-                            float sample = m_currentAudioData.waveform[sampleIndex];
-                            bandEnergy += sample * sample;
-                        }
-                    }
-                    
-                    // Normalize
-                    bandEnergy = sqrt(bandEnergy / samplesPerBand);
-                    
-                    // Apply same processing as the overall energy
-                    bandEnergy = logScale(bandEnergy);
-                    bandEnergy = dynamicRangeCompression(bandEnergy, 0.3f, 0.6f);
-                    bandEnergy *= sensitivityBoost;
-                    
-                    // Store in spectrum
-                    m_currentAudioData.spectrum[band] = std::min(1.0f, bandEnergy);
-                    
-                    // Apply a curve to make the spectrum more visually interesting
-                    // We'll boost lower frequencies to make bass more prominent
-                    float freq = static_cast<float>(band) / numBands;
-                    
-                    if (freq < 0.1f) { // Bass frequencies (0-10%)
-                        m_currentAudioData.spectrum[band] *= 1.2f; // Reduced from 1.5f
-                    } else if (freq < 0.3f) { // Low-mid (10-30%)
-                        m_currentAudioData.spectrum[band] *= 1.1f; // Reduced from 1.2f
-                    } else if (freq < 0.7f) { // Mid (30-70%)
-                        m_currentAudioData.spectrum[band] *= 1.0f; // Reduced from 1.1f
-                    }
-                    
-                    // Cap at 1.0
-                    m_currentAudioData.spectrum[band] = std::min(1.0f, m_currentAudioData.spectrum[band]);
-                }
-                
-                // Calculate energy levels for bass, mid, and treble based on our segmented bands
-                const int numBands10Pct = std::max(1, numBands / 10);
-                const int numBands30Pct = std::max(1, numBands * 3 / 10);
-                const int numBands60Pct = std::max(1, numBands * 6 / 10);
-                
-                float bassSum = 0.0f;
-                float midSum = 0.0f;
-                float trebleSum = 0.0f;
-                
-                // Bass: first 10% of bands
-                for (int i = 0; i < numBands10Pct; i++) {
-                    bassSum += m_currentAudioData.spectrum[i];
-                }
-                
-                // Mid: next 20% of bands (10%-30%)
-                for (int i = numBands10Pct; i < numBands30Pct; i++) {
-                    midSum += m_currentAudioData.spectrum[i];
-                }
-                
-                // Treble: next 30% of bands (30%-60%)
-                for (int i = numBands30Pct; i < numBands60Pct; i++) {
-                    trebleSum += m_currentAudioData.spectrum[i];
-                }
-                
-                // Normalize by count (with the same processing as before)
-                m_currentAudioData.bass = std::min(1.0f, bassSum / numBands10Pct * 1.0f);  // Reduced from 1.2f
-                m_currentAudioData.mid = std::min(1.0f, midSum / (numBands30Pct - numBands10Pct) * 1.0f);
-                m_currentAudioData.treble = std::min(1.0f, trebleSum / (numBands60Pct - numBands30Pct) * 1.0f);
-                
-                // Calculate overall energy - give more weight to bass for a better "feel"
-                // Use the processed RMS energy instead of recalculating
-                m_currentAudioData.energy = processedEnergy;
-                
-                // Add smoothing with previous frame for a more stable visualization
-                if (!m_audioHistory.empty()) {
-                    const float smoothFactor = 0.5f; // Increased from 0.3f for more stability
-                    
-                    const AudioData& prevData = m_audioHistory.back();
-                    m_currentAudioData.bass = prevData.bass * smoothFactor + m_currentAudioData.bass * (1.0f - smoothFactor);
-                    m_currentAudioData.mid = prevData.mid * smoothFactor + m_currentAudioData.mid * (1.0f - smoothFactor);
-                    m_currentAudioData.treble = prevData.treble * smoothFactor + m_currentAudioData.treble * (1.0f - smoothFactor);
-                    m_currentAudioData.energy = prevData.energy * smoothFactor + m_currentAudioData.energy * (1.0f - smoothFactor);
-                    
-                    // Detect transients
-                    float prevEnergy = prevData.energy;
-                    float energyDelta = std::max(0.0f, m_currentAudioData.energy - prevEnergy);
-                    // Apply logarithmic scaling to transients as well for better detection
-                    m_currentAudioData.transient = logScale(energyDelta * 5.0f); // Adjusted from 10.0f
-                }
-            }
+    // Replay publishes from the file here instead of on an analysis thread
+    if (m_impl->track.isOpen() || m_impl->log.isOpen()) {
+        replayFrame();
+    }
+    
+    // Pick up the newest frame the analysis thread has published
+    if (m_snapshots.acquire()) {
+        // Update audio history (copies into preallocated storage)
+        m_history.push(m_snapshots.getReadBuffer());
+    }
+}
+
+void AudioProcessor::replayFrame()
+{
+    const AudioDataLogReader& log = m_impl->log;
+    const FeatureTrackReader& track = m_impl->track;
+    const float speed = m_impl->sourceConfig.replaySpeed;
+    int frame = -1;
+    if (speed <= 0.0f) {
+        // Every recorded frame in turn, one per update, for benchmarking the render side
+        const int frameCount = log.isOpen() ? log.getFrameCount() : track.getFrameCount();
+        frame = (m_impl->replayFrame + 1) % frameCount;
+    } else {
+        // Frame current at the playback position, looping like WAV playback
+        const double elapsed = std::max(0.0, speed * std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_impl->playbackStart).count());
+        if (log.isOpen()) {
+            // Log timestamps start wherever the recording clock was at the first frame
+            const double first = log.getTimestamp(0);
+            const double span = log.getDuration() - first;
+            frame = log.findFrame(first + ((span > 0.0) ? std::fmod(elapsed, span) : 0.0));
         } else {
-            // If no audio is playing, gradually reduce energy levels
-            m_currentAudioData.bass *= 0.95f;
-            m_currentAudioData.mid *= 0.95f;
-            m_currentAudioData.treble *= 0.95f;
-            m_currentAudioData.energy *= 0.95f;
-            m_currentAudioData.transient *= 0.9f;
-            
-            // Also reduce spectrum values
-            for (size_t i = 0; i < m_currentAudioData.spectrum.size(); i++) {
-                m_currentAudioData.spectrum[i] *= 0.95f;
+            frame = track.findFrame(std::fmod(elapsed, track.getDuration()));
+        }
+        if (frame < 0 || frame == m_impl->replayFrame) {
+            return;
+        }
+    }
+    
+    m_impl->replayFrame = frame;
+    if (log.isOpen()) {
+        if (!log.decode(frame, m_currentAudioData)) {
+            return;
+        }
+    } else {
+        track.decode(frame, m_currentAudioData);
+    }
+    publishFrame();
+}
+
+void AudioProcessor::analysisLoop()
+{
+    using Clock = std::chrono::steady_clock;
+    
+    const std::chrono::microseconds hopDuration(
+        static_cast<long long>(m_hopSize) * 1000000 / m_sampleRate);
+    Clock::time_point lastFrameTime = Clock::now();
+    
+    while (m_impl->analysisRunning.load(std::memory_order_relaxed)) {
+        // Analyze every hop as it arrives
+        if (m_impl->ring.getReadAvailable() >= m_impl->stereoBuffer.size()) {
+            readHop();
+            analyzeFrame();
+            publishFrame();
+            lastFrameTime = Clock::now();
+            continue;
+        }
+        
+        // The source is late: count the underrun and keep publishing a decaying frame
+        if (Clock::now() - lastFrameTime >= 2 * hopDuration) {
+            if (!readHop()) {
+                decayFrame();
+            } else {
+                analyzeFrame();
             }
+            publishFrame();
+            lastFrameTime = Clock::now();
             
-            // Clear waveform when no audio
-            if (m_currentAudioData.energy < 0.01f) {
-                std::fill(m_currentAudioData.waveform.begin(), m_currentAudioData.waveform.end(), 0.0f);
+            // Report ring health occasionally
+            if (m_impl->statsFrameCount++ % 1000 == 0 && (getOverrunCount() > 0)) {
+                std::cout << "Capture ring overruns: " << getOverrunCount() << " frames" << std::endl;
             }
         }
-    } else
-#endif
-    {
-        // Fallback to generated test data on non-Windows or if WASAPI failed
-        generateTestData();
+        
+        std::this_thread::sleep_for(hopDuration / 4);
     }
+}
+
+void AudioProcessor::publishFrame()
+{
+    // Same-sized vectors, so the copy reuses the snapshot's storage
+    m_snapshots.getWriteBuffer() = m_currentAudioData;
+    m_snapshots.publish();
     
-    // Update audio history
-    m_audioHistory.push_back(m_currentAudioData);
+    if (m_impl->recording) {
+        std::lock_guard<std::mutex> lock(m_impl->recordMutex);
+        if (m_impl->recorder) {
+            const double timestamp = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - m_impl->recordStart).count();
+            m_impl->recorder->append(m_currentAudioData, timestamp);
+        }
+    }
+}
+
+void AudioProcessor::decayFrame()
+{
+    // If no audio is playing, gradually reduce energy levels
+    m_currentAudioData.bass *= 0.95f;
+    m_currentAudioData.mid *= 0.95f;
+    m_currentAudioData.treble *= 0.95f;
+    m_currentAudioData.energy *= 0.95f;
+    m_currentAudioData.onset *= 0.9f;
+    m_currentAudioData.transient = m_currentAudioData.onset;
+    m_currentAudioData.pitchConfidence *= 0.9f;
+
+    // Also reduce spectrum values
+    for (size_t i = 0; i < m_currentAudioData.spectrum.size(); i++) {
+        m_currentAudioData.spectrum[i] *= 0.95f;
+    }
+    for (size_t i = 0; i < m_currentAudioData.bands.size(); i++) {
+        m_currentAudioData.bands[i] *= 0.95f;
+    }
+    for (float& level : m_currentAudioData.envelopes) {
+        level *= 0.95f;
+    }
+    for (float& level : m_currentAudioData.envelopeBlocks) {
+        level *= 0.95f;
+    }
+    for (float& level : m_currentAudioData.probes) {
+        level *= 0.95f;
+    }
+    m_currentAudioData.features.rms *= 0.95f;
+    m_currentAudioData.features.truePeak *= 0.95f;
+    for (std::vector<float>* levels : { &m_currentAudioData.spectrumLeft, &m_currentAudioData.spectrumRight,
+                                        &m_currentAudioData.spectrumMid, &m_currentAudioData.spectrumSide,
+                                        &m_currentAudioData.goniometer }) {
+        for (float& level : *levels) {
+            level *= 0.95f;
+        }
+    }
+
+    // Clear waveform when no audio
+    if (m_currentAudioData.energy < 0.01f) {
+        std::fill(m_currentAudioData.waveform.begin(), m_currentAudioData.waveform.end(), 0.0f);
+    }
+}
+
+uint64_t AudioProcessor::getOverrunCount() const
+{
+    // The ring counts samples, two per frame
+    return m_impl->ring.getOverrunCount() / 2;
+}
+
+uint64_t AudioProcessor::getUnderrunCount() const
+{
+    return m_impl->ring.getUnderrunCount();
+}
+
+bool AudioProcessor::readHop()
+{
+    // Read exactly one hop; leaves the frame untouched (and counts an underrun) if not enough is buffered
+    const std::vector<float>& frames = m_impl->stereoBuffer;
+    if (!m_impl->ring.read(m_impl->stereoBuffer.data(), frames.size())) {
+        return false;
+    }
     
-    // Keep history at desired size
-    while (m_audioHistory.size() > m_historySize) {
-        m_audioHistory.pop_front();
+    // Everything but the stereo image analyzes the mid of the two channels
+    const SampleKernels& kernels = SampleKernels::best();
+    float* planes[2] = { m_impl->channelPlanes.data(), m_impl->channelPlanes.data() + m_hopSize };
+    const float* channels[2] = { planes[0], planes[1] };
+    float* mono = m_impl->buffer.data();
+    kernels.deinterleave(frames.data(), 2, m_hopSize, planes);
+    kernels.downmix(channels, 2, m_hopSize, MidMix, 1, &mono);
+    if (m_impl->stereoEnabled) {
+        m_impl->stereo.processHop(frames.data());
     }
+    m_impl->loudness.process(frames.data(), m_hopSize);
+    processHop();
+    return true;
 }
 
-// Helper method to generate test audio data (placeholder)
-void AudioProcessor::generateTestData()
+void AudioProcessor::processHop()
 {
-    static float phase = 0.0f;
-    static float bassPhase = 0.0f;
-    static float midPhase = 0.0f;
-    static float treblePhase = 0.0f;
+    // Slide the analysis frame and append the new hop
+    std::vector<float>& waveform = m_currentAudioData.waveform;
+    std::copy(waveform.begin() + m_hopSize, waveform.end(), waveform.begin());
+    std::copy(m_impl->buffer.begin(), m_impl->buffer.end(), waveform.end() - m_hopSize);
     
-    // Log that we're using test data
-    static int counter = 0;
-    if (counter++ % 500 == 0) {
-        std::cout << "USING TEST AUDIO DATA - No real audio capture available" << std::endl;
+    // Decimated streams (bass, multi-resolution tiers) and the envelopes keep their own history
+    m_impl->envelopeBlockCount = 0;
+    m_impl->decimation.process(m_impl->buffer.data(), m_hopSize);
+    m_impl->featureExtractor.processBlock(m_impl->buffer.data(), m_hopSize);
+}
+
+void AudioProcessor::recordEnvelopeBlock(const float* levels, int numBands)
+{
+    // Same level processing as the other band levels
+    const size_t block = m_impl->envelopeBlockCount++;
+    std::vector<float>& blocks = m_currentAudioData.envelopeBlocks;
+    for (int band = 0; band < numBands; band++) {
+        const float level = std::min(1.0f, dynamicRangeCompression(logScale(levels[band]), 0.3f, 0.6f));
+        m_currentAudioData.envelopes[band] = level;
+        if ((block + 1) * numBands <= blocks.size()) {
+            blocks[block * numBands + band] = level;
+        }
     }
+}
+
+void AudioProcessor::analyzeFrame()
+{
+    // Previous frame's levels for smoothing
+    const float prevBass = m_currentAudioData.bass;
+    const float prevMid = m_currentAudioData.mid;
+    const float prevTreble = m_currentAudioData.treble;
+    const float prevEnergy = m_currentAudioData.energy;
     
-    // Generate more pronounced waveform with higher amplitude
-    for (int i = 0; i < m_frameSize; ++i) {
-        // Mix frequencies for bass, mid, and treble with higher amplitudes
-        float bassFreq = 100.0f; // 100 Hz
-        float midFreq = 1000.0f; // 1 kHz
-        float trebleFreq = 5000.0f; // 5 kHz
-        
-        float t = static_cast<float>(i) / m_sampleRate;
-        
-        // Generate separate components with higher amplitudes
-        float bassSignal = 0.8f * sin(2.0f * M_PI * bassFreq * t + bassPhase); // Increased from 0.4f
-        float midSignal = 0.6f * sin(2.0f * M_PI * midFreq * t + midPhase);    // Increased from 0.3f
-        float trebleSignal = 0.4f * sin(2.0f * M_PI * trebleFreq * t + treblePhase); // Increased from 0.2f
-        
-        // Add a sweeping component to make it more interesting
-        float sweepFreq = 500.0f + 500.0f * sin(phase * 0.1f);
-        float sweepSignal = 0.5f * sin(2.0f * M_PI * sweepFreq * t + phase * 0.5f);
-        
-        // Mix all components - will be automatically clamped in visualization
-        m_currentAudioData.waveform[i] = bassSignal + midSignal + trebleSignal + sweepSignal;
+    // Loudness, and the energy level it gives after automatic gain
+    const float processedEnergy = analyzeLoudness();
+    
+    // Debug output occasionally to see actual levels (not from offline workers)
+    if (!m_impl->offline && m_impl->debugFrameCount++ % 500 == 0) {
+        std::cout << "Loudness: momentary " << m_currentAudioData.loudnessMomentary
+                  << " LUFS | Short-term: " << m_currentAudioData.loudnessShortTerm
+                  << " LUFS | Integrated: " << m_currentAudioData.loudnessIntegrated
+                  << " LUFS | Energy: " << processedEnergy << std::endl;
     }
     
-    // Update phases for next frame with higher speeds
-    phase += 0.2f;        // Increased from 0.1f
-    bassPhase += 0.05f;   // Increased from 0.02f
-    midPhase += 0.1f;     // Increased from 0.05f
-    treblePhase += 0.15f; // Increased from 0.08f
+    // Stereo image first: with the FFT stage, its transform also yields the spectrum
+    if (m_impl->stereoEnabled) {
+        analyzeStereo();
+    }
     
-    // Generate fake spectrum data with higher peaks
-    for (size_t i = 0; i < m_currentAudioData.spectrum.size(); ++i) {
-        float freq = static_cast<float>(i) * m_sampleRate / m_frameSize;
-        
-        // Shape the spectrum to have peaks at different frequencies
-        float spectrum = 0.0f;
+    // Spectrum, bands and the bass/mid/treble levels
+    const bool hasBands = m_analysisConfig.spectrum || m_analysisConfig.slidingBands;
+    if (m_analysisConfig.spectrum) {
+        analyzeSpectrum();
+    } else {
+        // Low-power mode: levels straight from the crossover envelopes (bass, mid, presence, air)
+        const std::vector<float>& envelopes = m_currentAudioData.envelopes;
+        m_currentAudioData.bass = envelopes[0];
+        m_currentAudioData.mid = envelopes[1];
+        m_currentAudioData.treble = std::max(envelopes[2], envelopes[3]);
         
-        // Bass peak around 100 Hz
-        if (freq < m_bassFrequencyLimit) {
-            spectrum = 0.9f * exp(-pow((freq - 100.0f) / 50.0f, 2.0f)); // Increased from 0.8f
-        }
-        // Mid peak around 1000 Hz
-        else if (freq < m_midFrequencyLimit) {
-            spectrum = 0.8f * exp(-pow((freq - 1000.0f) / 400.0f, 2.0f)); // Increased from 0.6f
-        }
-        // Treble peak around 5000 Hz
-        else if (freq < m_maxFrequency) {
-            spectrum = 0.7f * exp(-pow((freq - 5000.0f) / 2000.0f, 2.0f)); // Increased from 0.4f
+        // Sliding bands don't need the frame FFT
+        if (hasBands) {
+            analyzeBands();
         }
+    }
+    
+    // Probes are measured either way
+    updateProbes();
+    
+    // Overall energy from the loudness stage
+    m_currentAudioData.energy = processedEnergy;
+    
+    // Add smoothing with previous frame for a more stable visualization
+    if (m_impl->hasPreviousFrame) {
+        const float smoothFactor = 0.5f; // Increased from 0.3f for more stability
         
-        // Add some time variation - more pronounced
-        spectrum *= 0.7f + 0.5f * sin(phase * 0.2f + freq * 0.001f); // Increased variation
+        m_currentAudioData.bass = prevBass * smoothFactor + m_currentAudioData.bass * (1.0f - smoothFactor);
+        m_currentAudioData.mid = prevMid * smoothFactor + m_currentAudioData.mid * (1.0f - smoothFactor);
+        m_currentAudioData.treble = prevTreble * smoothFactor + m_currentAudioData.treble * (1.0f - smoothFactor);
+        m_currentAudioData.energy = prevEnergy * smoothFactor + m_currentAudioData.energy * (1.0f - smoothFactor);
+    }
+    m_impl->hasPreviousFrame = true;
+    
+    m_currentAudioData.features = m_impl->featureExtractor.getFeatures();
+    
+    // Onsets from spectral flux on the raw bands, driving the tempo tracker
+    if (hasBands) {
+        const bool onset = m_impl->onsetDetector.process(m_impl->bandMagnitudes.data());
+        m_impl->tempoTracker.process(m_impl->onsetDetector.getFlux(), onset);
         
-        m_currentAudioData.spectrum[i] = spectrum;
+        m_currentAudioData.onset = m_impl->onsetDetector.getOnsetStrength();
+        m_currentAudioData.transient = m_currentAudioData.onset;
+        m_currentAudioData.bpm = m_impl->tempoTracker.getBpm();
+        m_currentAudioData.beatPhase = m_impl->tempoTracker.getBeatPhase();
+    }
+    
+    // Pitch and key are part of the FFT stage
+    if (m_analysisConfig.spectrum && m_impl->pitchEnabled) {
+        m_impl->pitchDetector.process(m_impl->pitchWindow.data());
+        m_currentAudioData.pitchHz = m_impl->pitchDetector.getPitch();
+        m_currentAudioData.pitchConfidence = m_impl->pitchDetector.getConfidence();
+    }
+    if (m_analysisConfig.spectrum && m_impl->harmonyEnabled) {
+        analyzeHarmony();
     }
+}
+
+void AudioProcessor::analyzeSpectrum()
+{
+    const float sensitivityBoost = 1.0f;
     
-    // Calculate energy levels from spectrum
-    float bassEnergy = 0.0f;
-    float midEnergy = 0.0f;
-    float trebleEnergy = 0.0f;
+    // Scale magnitudes so a full-scale sine reads 1.0 in its bin. The waveform is the mid of
+    // left and right, so with stereo analysis its spectrum is the mid spectrum already computed.
+    if (m_impl->stereoEnabled) {
+        const StereoAnalyzer& stereo = m_impl->stereo;
+        const std::vector<float>& mid = stereo.getMagnitudes(StereoChannel::Mid);
+        const float scale = 2.0f / stereo.getWindowSum();
+        std::transform(mid.begin(), mid.end(), m_currentAudioData.spectrum.begin(),
+                       [scale](float magnitude) { return magnitude * scale; });
+    } else {
+        RealFFT& realFFT = m_impl->realFFT;
+        realFFT.forward(m_currentAudioData.waveform.data());
+        realFFT.getMagnitudes(m_currentAudioData.spectrum.data(), 2.0f / realFFT.getWindowSum());
+    }
+    m_impl->featureExtractor.processSpectrum(m_currentAudioData.spectrum.data());
+    
+    // Perceptual bands from the raw magnitudes
+    analyzeBands();
+    
+    const int numBands = m_currentAudioData.spectrum.size();
+    const float binWidth = static_cast<float>(m_sampleRate) / m_frameSize;
+    
+    float bassSum = 0.0f;
+    float midSum = 0.0f;
+    float trebleSum = 0.0f;
     int bassCount = 0;
     int midCount = 0;
     int trebleCount = 0;
     
-    for (size_t i = 0; i < m_currentAudioData.spectrum.size(); ++i) {
-        float freq = static_cast<float>(i) * m_sampleRate / m_frameSize;
+    for (int band = 0; band < numBands; band++) {
+        float bandEnergy = m_currentAudioData.spectrum[band];
+        
+        // Apply same processing as the overall energy
+        bandEnergy = logScale(bandEnergy);
+        bandEnergy = dynamicRangeCompression(bandEnergy, 0.3f, 0.6f);
+        bandEnergy *= sensitivityBoost;
         
-        if (freq < m_bassFrequencyLimit) {
-            bassEnergy += m_currentAudioData.spectrum[i];
-            bassCount++;
+        // Store in spectrum
+        m_currentAudioData.spectrum[band] = std::min(1.0f, bandEnergy);
+        
+        // Apply a curve to make the spectrum more visually interesting
+        // We'll boost lower frequencies to make bass more prominent
+        float freq = static_cast<float>(band) / numBands;
+        
+        if (freq < 0.1f) { // Bass frequencies (0-10%)
+            m_currentAudioData.spectrum[band] *= 1.2f; // Reduced from 1.5f
+        } else if (freq < 0.3f) { // Low-mid (10-30%)
+            m_currentAudioData.spectrum[band] *= 1.1f; // Reduced from 1.2f
+        } else if (freq < 0.7f) { // Mid (30-70%)
+            m_currentAudioData.spectrum[band] *= 1.0f; // Reduced from 1.1f
         }
-        else if (freq < m_midFrequencyLimit) {
-            midEnergy += m_currentAudioData.spectrum[i];
+        
+        // Cap at 1.0
+        m_currentAudioData.spectrum[band] = std::min(1.0f, m_currentAudioData.spectrum[band]);
+        
+        // Accumulate mid and treble levels by bin frequency
+        float binFrequency = band * binWidth;
+        if (binFrequency < m_bassFrequencyLimit) {
+            // Bass is measured from the decimated stream below
+        } else if (binFrequency < m_midFrequencyLimit) {
+            midSum += m_currentAudioData.spectrum[band];
             midCount++;
-        }
-        else if (freq < m_maxFrequency) {
-            trebleEnergy += m_currentAudioData.spectrum[i];
+        } else if (binFrequency < m_maxFrequency) {
+            trebleSum += m_currentAudioData.spectrum[band];
             trebleCount++;
         }
     }
     
-    // Normalize and update audio data with higher values
-    m_currentAudioData.bass = (bassCount > 0) ? std::min(1.0f, bassEnergy / bassCount * 1.5f) : 0.0f;
-    m_currentAudioData.mid = (midCount > 0) ? std::min(1.0f, midEnergy / midCount * 1.5f) : 0.0f;
-    m_currentAudioData.treble = (trebleCount > 0) ? std::min(1.0f, trebleEnergy / trebleCount * 1.5f) : 0.0f;
+    // Bass from the 1/8-rate stream: the frame's bin spacing from an eighth of
+    // the samples, with the same per-bin processing
+    RealFFT& bassFFT = m_impl->bassFFT;
+    bassFFT.forward(m_impl->bassWindow.data());
+    bassFFT.getMagnitudes(m_impl->bassSpectrum.data(), 2.0f / bassFFT.getWindowSum());
+    const float bassBinWidth = static_cast<float>(m_sampleRate) / BassDecimation / BassWindowSize;
+    for (int bin = 1; bin * bassBinWidth < m_bassFrequencyLimit; bin++) {
+        float binLevel = logScale(m_impl->bassSpectrum[bin]);
+        binLevel = dynamicRangeCompression(binLevel, 0.3f, 0.6f) * sensitivityBoost;
+        bassSum += std::min(1.0f, std::min(1.0f, binLevel) * 1.2f);
+        bassCount++;
+    }
     
-    // Overall energy - boosted
-    m_currentAudioData.energy = std::min(1.0f, (m_currentAudioData.bass + m_currentAudioData.mid + m_currentAudioData.treble) / 2.5f);
+    // Normalize by count (with the same processing as before)
+    m_currentAudioData.bass = (bassCount > 0) ? std::min(1.0f, bassSum / bassCount) : 0.0f;
+    m_currentAudioData.mid = (midCount > 0) ? std::min(1.0f, midSum / midCount) : 0.0f;
+    m_currentAudioData.treble = (trebleCount > 0) ? std::min(1.0f, trebleSum / trebleCount) : 0.0f;
+}
+
+void AudioProcessor::analyzeBands()
+{
+    const float sensitivityBoost = 1.0f;
     
-    // Detect transients (sudden changes in energy) - more pronounced
-    if (!m_audioHistory.empty()) {
-        float prevEnergy = m_audioHistory.back().energy;
-        m_currentAudioData.transient = std::min(1.0f, std::max(0.0f, m_currentAudioData.energy - prevEnergy) * 8.0f); // Increased from 5.0f
+    // Perceptual bands from whichever analysis is configured, with the same level processing as the bins
+    if (m_analysisConfig.slidingBands) {
+        m_impl->slidingBands.getMagnitudes(m_impl->bandMagnitudes.data());
+    } else if (m_analysisConfig.multiResolution) {
+        m_impl->multiResolution.computeBands(m_impl->bandMagnitudes.data());
+    } else {
+        m_impl->filterbank.apply(m_currentAudioData.spectrum.data(), m_impl->bandMagnitudes.data());
+    }
+    if (m_analysisConfig.adaptiveBands) {
+        normalizeBands();
+        return;
+    }
+    for (size_t band = 0; band < m_impl->bandMagnitudes.size(); band++) {
+        float bandLevel = logScale(m_impl->bandMagnitudes[band]);
+        bandLevel = dynamicRangeCompression(bandLevel, 0.3f, 0.6f);
+        m_currentAudioData.bands[band] = std::min(1.0f, bandLevel * sensitivityBoost);
+    }
+}
+
+void AudioProcessor::normalizeBands()
+{
+    // 20 * log10(x) from the natural log
+    const float decibelsPerNeper = 20.0f / 2.30258509f;
+    const float floorMagnitude = std::pow(10.0f, BandFloorDb / 20.0f);
+    
+    for (size_t band = 0; band < m_impl->bandMagnitudes.size(); band++) {
+        const float magnitude = m_impl->bandMagnitudes[band];
+        QuantileSketch& sketch = m_impl->bandQuantiles[band];
+        
+        // Silence doesn't count towards the range, so gaps between tracks don't reset it
+        if (magnitude <= floorMagnitude) {
+            m_currentAudioData.bands[band] = 0.0f;
+            continue;
+        }
+        const float level = decibelsPerNeper * fastLog(magnitude);
+        sketch.add(level);
+        
+        const float low = sketch.getQuantile(0);
+        const float range = std::max(MinBandRangeDb, sketch.getQuantile(1) - low);
+        m_currentAudioData.bands[band] = std::max(0.0f, std::min(1.0f, (level - low) / range));
+    }
+}
+
+float AudioProcessor::analyzeLoudness()
+{
+    const LoudnessMeter& loudness = m_impl->loudness;
+    const float momentary = loudness.getMomentary();
+    const float shortTerm = loudness.getShortTerm();
+    m_currentAudioData.loudnessMomentary = momentary;
+    m_currentAudioData.loudnessShortTerm = shortTerm;
+    m_currentAudioData.loudnessIntegrated = loudness.getIntegrated();
+    
+    if (momentary <= LoudnessMeter::SilenceLoudness) {
+        return 0.0f;
+    }
+    
+    // Reference: the programme's integrated loudness, or the short-term loudness
+    // until enough has been gated (the momentary one at the very start)
+    float reference = momentary;
+    if (loudness.hasIntegrated() && shortTerm > LoudnessMeter::SilenceLoudness) {
+        reference = std::max(shortTerm - MaxReferenceDrift,
+                             std::min(shortTerm + MaxReferenceDrift, loudness.getIntegrated()));
+    } else if (shortTerm > LoudnessMeter::SilenceLoudness) {
+        reference = shortTerm;
+    }
+    
+    // Gain that brings the reference to ReferenceEnergy, applied to the momentary amplitude
+    const float relative = std::pow(10.0f, (momentary - reference) / 20.0f);
+    return std::min(1.0f, ReferenceEnergy * relative);
+}
+
+void AudioProcessor::analyzeHarmony()
+{
+    Impl& impl = *m_impl;
+    
+    RealFFT& chromaFFT = impl.chromaFFT;
+    chromaFFT.forward(impl.chromaWindow.data());
+    chromaFFT.getMagnitudes(impl.chromaSpectrum.data(), 2.0f / chromaFFT.getWindowSum());
+    impl.chromagram.process(impl.chromaSpectrum.data());
+    impl.keyEstimator.process(impl.chromagram.getChroma());
+    
+    const float* chroma = impl.chromagram.getChroma();
+    std::copy(chroma, chroma + Chromagram::NumPitchClasses, m_currentAudioData.chroma.begin());
+    m_currentAudioData.key = impl.keyEstimator.getKey();
+    m_currentAudioData.keyMinor = impl.keyEstimator.isMinor();
+    m_currentAudioData.keyConfidence = impl.keyEstimator.getConfidence();
+}
+
+void AudioProcessor::analyzeStereo()
+{
+    StereoAnalyzer& stereo = m_impl->stereo;
+    m_currentAudioData.stereoCorrelation = stereo.getCorrelation();
+    const std::vector<float>& points = stereo.getGoniometer();
+    std::copy(points.begin(), points.end(), m_currentAudioData.goniometer.begin());
+    if (!m_analysisConfig.spectrum) {
+        return;
+    }
+    
+    // All four spectra from one packed transform, with the same level processing as the spectrum bins
+    stereo.transform();
+    const float scale = 2.0f / stereo.getWindowSum();
+    const std::pair<StereoChannel, std::vector<float>*> spectra[] = {
+        { StereoChannel::Left, &m_currentAudioData.spectrumLeft },
+        { StereoChannel::Right, &m_currentAudioData.spectrumRight },
+        { StereoChannel::Mid, &m_currentAudioData.spectrumMid },
+        { StereoChannel::Side, &m_currentAudioData.spectrumSide }
+    };
+    for (const auto& spectrum : spectra) {
+        const std::vector<float>& magnitudes = stereo.getMagnitudes(spectrum.first);
+        std::transform(magnitudes.begin(), magnitudes.end(), spectrum.second->begin(), [scale](float magnitude) {
+            return std::min(1.0f, dynamicRangeCompression(logScale(magnitude * scale), 0.3f, 0.6f));
+        });
+    }
+}
+
+void AudioProcessor::updateProbes()
+{
+    Impl& impl = *m_impl;
+    
+    // Adopt new registrations without ever waiting on the registering thread
+    if (impl.probesPending.load(std::memory_order_acquire)) {
+        std::unique_lock<std::mutex> lock(impl.probeMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            for (size_t i = impl.probeSlots.size(); i < impl.probeRequests.size(); i++) {
+                impl.probeSlots.push_back(impl.probes.addProbe(impl.probeRequests[i].first,
+                                                               impl.probeRequests[i].second));
+            }
+            impl.probesPending.store(false, std::memory_order_relaxed);
+            m_currentAudioData.probes.resize(impl.probeSlots.size(), 0.0f);
+        }
+    }
+    
+    // Same level processing as the bands
+    impl.probes.update();
+    for (size_t i = 0; i < impl.probeSlots.size(); i++) {
+        if (impl.probeSlots[i] >= 0) {
+            const float level = logScale(impl.probes.getMagnitude(impl.probeSlots[i]));
+            m_currentAudioData.probes[i] = std::min(1.0f, dynamicRangeCompression(level, 0.3f, 0.6f));
+        }
     }
 }
 
-} // namespace av 
\ No newline at end of file
+} // namespace av
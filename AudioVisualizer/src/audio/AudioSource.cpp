@@ -0,0 +1,53 @@
+#include "audio/AudioSource.h"
+#include "audio/SdlCaptureSource.h"
+#include "audio/WasapiLoopbackSource.h"
+#include "audio/SyntheticSource.h"
+#include "audio/WavFileSource.h"
+#include "audio/PcmStreamSource.h"
+#include <iostream>
+
+namespace av {
+
+std::unique_ptr<AudioSource> AudioSource::create(const AudioSourceConfig& config)
+{
+    const std::string& type = config.type;
+
+    if (type == "auto") {
+        // Loopback of what is playing on Windows, the default capture device elsewhere
+#ifdef _WIN32
+        return std::make_unique<WasapiLoopbackSource>();
+#else
+        return std::make_unique<SdlCaptureSource>();
+#endif
+    }
+    if (type == "capture") {
+        return std::make_unique<SdlCaptureSource>();
+    }
+    if (type == "wasapi") {
+#ifdef _WIN32
+        return std::make_unique<WasapiLoopbackSource>();
+#else
+        std::cerr << "WASAPI loopback is only available on Windows" << std::endl;
+        return nullptr;
+#endif
+    }
+    if (type == "synthetic") {
+        return std::make_unique<SyntheticSource>(config.scenario, config.seed);
+    }
+    if (type == "wav") {
+        if (config.path.empty()) {
+            std::cerr << "WAV source needs a file path" << std::endl;
+            return nullptr;
+        }
+        return std::make_unique<WavFileSource>(config.path);
+    }
+    if (type == "pcm") {
+        return std::make_unique<PcmStreamSource>(config.path.empty() ? "-" : config.path,
+                                                 config.sampleRate, config.channels, config.format);
+    }
+
+    std::cerr << "Unknown audio source type: " << type << std::endl;
+    return nullptr;
+}
+
+} // namespace av
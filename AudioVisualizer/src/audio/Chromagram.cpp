@@ -0,0 +1,98 @@
+#include "audio/Chromagram.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Below this level the frame counts as silent and has no pitch classes
+const float SilenceLevel = 1e-7f;
+
+// Equal-tempered frequency of a MIDI note (A4 = 69 = 440 Hz)
+float noteFrequency(int note)
+{
+    return 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+}
+
+} // namespace
+
+Chromagram::Chromagram()
+    : m_numOctaves(0)
+{
+    std::fill(m_chroma, m_chroma + NumPitchClasses, 0.0f);
+}
+
+bool Chromagram::initialize(int fftSize, int sampleRate, int lowestC, int numOctaves)
+{
+    if (lowestC < 0 || lowestC % NumPitchClasses != 0 || numOctaves < 1) {
+        std::cerr << "Chromagram needs a C (MIDI note divisible by 12) and at least one octave" << std::endl;
+        return false;
+    }
+
+    // Each note's filter runs from the semitone below to the semitone above
+    const int numNotes = numOctaves * NumPitchClasses;
+    std::vector<float> edges;
+    for (int note = lowestC - 1; note <= lowestC + numNotes; note++) {
+        edges.push_back(noteFrequency(note));
+    }
+    if (edges.back() >= 0.5f * sampleRate) {
+        std::cerr << "Chromagram range up to " << edges.back() << " Hz is above the Nyquist frequency ("
+                  << 0.5f * sampleRate << " Hz at " << sampleRate << " Hz)" << std::endl;
+        return false;
+    }
+    if (!m_notes.initialize(edges, fftSize, sampleRate)) {
+        return false;
+    }
+
+    m_numOctaves = numOctaves;
+    m_noteLevels.assign(numNotes, 0.0f);
+    std::fill(m_chroma, m_chroma + NumPitchClasses, 0.0f);
+    return true;
+}
+
+void Chromagram::process(const float* magnitudes)
+{
+    m_notes.apply(magnitudes, m_noteLevels.data());
+    const float* notes = m_noteLevels.data();
+
+#ifdef AV_SIMD_SSE2
+    __m128 low = _mm_setzero_ps();
+    __m128 middle = _mm_setzero_ps();
+    __m128 high = _mm_setzero_ps();
+    for (int octave = 0; octave < m_numOctaves; octave++) {
+        const float* row = notes + octave * NumPitchClasses;
+        low = _mm_add_ps(low, _mm_loadu_ps(row));
+        middle = _mm_add_ps(middle, _mm_loadu_ps(row + 4));
+        high = _mm_add_ps(high, _mm_loadu_ps(row + 8));
+    }
+
+    // Largest class: max across the vectors, then across the lanes
+    __m128 largest = _mm_max_ps(_mm_max_ps(low, middle), high);
+    largest = _mm_max_ps(largest, _mm_movehl_ps(largest, largest));
+    largest = _mm_max_ss(largest, _mm_shuffle_ps(largest, largest, _MM_SHUFFLE(1, 1, 1, 1)));
+    const float peak = _mm_cvtss_f32(largest);
+
+    const __m128 scale = _mm_set1_ps(peak > SilenceLevel ? 1.0f / peak : 0.0f);
+    _mm_store_ps(m_chroma, _mm_mul_ps(low, scale));
+    _mm_store_ps(m_chroma + 4, _mm_mul_ps(middle, scale));
+    _mm_store_ps(m_chroma + 8, _mm_mul_ps(high, scale));
+#else
+    std::fill(m_chroma, m_chroma + NumPitchClasses, 0.0f);
+    for (int octave = 0; octave < m_numOctaves; octave++) {
+        for (int pitchClass = 0; pitchClass < NumPitchClasses; pitchClass++) {
+            m_chroma[pitchClass] += notes[octave * NumPitchClasses + pitchClass];
+        }
+    }
+
+    const float peak = *std::max_element(m_chroma, m_chroma + NumPitchClasses);
+    const float scale = peak > SilenceLevel ? 1.0f / peak : 0.0f;
+    for (float& level : m_chroma) {
+        level *= scale;
+    }
+#endif
+}
+
+} // namespace av
@@ -0,0 +1,205 @@
+#include "audio/CrossoverFilterBank.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// Keeps filter state out of the denormal range while the input is silent
+const float DenormalGuard = 1e-18f;
+
+enum class BiquadType { Lowpass, Highpass };
+
+// Butterworth (Q = 1/sqrt(2)) section from the RBJ cookbook, normalized by a0
+void designButterworth(BiquadType type, double frequency, double sampleRate, float* coefficients)
+{
+    const double w0 = 2.0 * Pi * frequency / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / std::sqrt(2.0);
+    const double a0 = 1.0 + alpha;
+
+    const double b1 = (type == BiquadType::Lowpass) ? (1.0 - cosW0) : -(1.0 + cosW0);
+    const double b0 = (type == BiquadType::Lowpass) ? b1 / 2.0 : -b1 / 2.0;
+    coefficients[0] = static_cast<float>(b0 / a0);
+    coefficients[1] = static_cast<float>(b1 / a0);
+    coefficients[2] = static_cast<float>(b0 / a0);
+    coefficients[3] = static_cast<float>(-2.0 * cosW0 / a0);
+    coefficients[4] = static_cast<float>((1.0 - alpha) / a0);
+}
+
+} // namespace
+
+CrossoverFilterBank::CrossoverFilterBank()
+    : m_numBands(0)
+    , m_numGroups(0)
+    , m_blockSize(0)
+    , m_blockPosition(0)
+    , m_attack(0.0f)
+    , m_release(0.0f)
+{
+}
+
+bool CrossoverFilterBank::initialize(int sampleRate, const std::vector<float>& crossovers,
+                                     float attackSeconds, float releaseSeconds, int blockSize)
+{
+    const int numBands = static_cast<int>(crossovers.size()) + 1;
+    if (numBands < MinBands || numBands > MaxBands || sampleRate <= 0 || blockSize < 1 ||
+        attackSeconds <= 0.0f || releaseSeconds <= 0.0f) {
+        std::cerr << "Crossover bank needs " << MinBands << "-" << MaxBands
+                  << " bands, a sample rate, a block size and positive time constants" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < crossovers.size(); i++) {
+        if (crossovers[i] <= 0.0f || crossovers[i] >= 0.5f * sampleRate ||
+            (i > 0 && crossovers[i] <= crossovers[i - 1])) {
+            std::cerr << "Crossover frequencies must rise and stay below Nyquist" << std::endl;
+            return false;
+        }
+    }
+
+    m_numBands = numBands;
+    m_numGroups = (numBands + Lanes - 1) / Lanes;
+    m_blockSize = blockSize;
+    m_crossovers = crossovers;
+
+    // Sections default to a pass-through; unused lanes output silence
+    m_coefficients.assign(m_numGroups * NumSections * 5 * Lanes, 0.0f);
+    for (int lane = 0; lane < m_numGroups * Lanes; lane++) {
+        const int group = lane / Lanes;
+        const int index = lane % Lanes;
+        float* groupCoefficients = &m_coefficients[group * NumSections * 5 * Lanes];
+
+        for (int section = 0; section < NumSections; section++) {
+            float design[5] = { lane < numBands ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+            if (lane < numBands) {
+                if (section < 2 && lane > 0) {
+                    designButterworth(BiquadType::Highpass, crossovers[lane - 1], sampleRate, design);
+                } else if (section >= 2 && lane < numBands - 1) {
+                    designButterworth(BiquadType::Lowpass, crossovers[lane], sampleRate, design);
+                }
+            }
+            for (int c = 0; c < 5; c++) {
+                groupCoefficients[(section * 5 + c) * Lanes + index] = design[c];
+            }
+        }
+    }
+
+    // One-pole followers: the envelope covers 1 - 1/e of a step in the time constant
+    m_attack = 1.0f - std::exp(-1.0f / (attackSeconds * sampleRate));
+    m_release = 1.0f - std::exp(-1.0f / (releaseSeconds * sampleRate));
+
+    m_state.assign(m_numGroups * NumSections * 2 * Lanes, 0.0f);
+    m_envelope.assign(m_numGroups * Lanes, 0.0f);
+    m_levels.assign(m_numGroups * Lanes, 0.0f);
+    reset();
+    return true;
+}
+
+void CrossoverFilterBank::reset()
+{
+    std::fill(m_state.begin(), m_state.end(), 0.0f);
+    std::fill(m_envelope.begin(), m_envelope.end(), 0.0f);
+    std::fill(m_levels.begin(), m_levels.end(), 0.0f);
+    m_blockPosition = 0;
+}
+
+void CrossoverFilterBank::process(const float* samples, size_t count)
+{
+    if (m_numBands == 0) {
+        return;
+    }
+
+    // Run up to each block boundary so every group has finished the block before publishing it
+    while (count > 0) {
+        const size_t chunk = std::min(count, static_cast<size_t>(m_blockSize - m_blockPosition));
+        for (int group = 0; group < m_numGroups; group++) {
+            processGroup(group, samples, chunk);
+        }
+
+        m_blockPosition += static_cast<int>(chunk);
+        if (m_blockPosition == m_blockSize) {
+            m_blockPosition = 0;
+            std::copy(m_envelope.begin(), m_envelope.end(), m_levels.begin());
+            if (m_blockCallback) {
+                m_blockCallback(m_levels.data(), m_numBands);
+            }
+        }
+
+        samples += chunk;
+        count -= chunk;
+    }
+}
+
+void CrossoverFilterBank::processGroup(int group, const float* samples, size_t count)
+{
+    const float* coefficients = &m_coefficients[group * NumSections * 5 * Lanes];
+    float* state = &m_state[group * NumSections * 2 * Lanes];
+    float* envelope = &m_envelope[group * Lanes];
+
+#ifdef AV_SIMD_SSE2
+    // Keep the whole group in registers for the block
+    __m128 b0[NumSections], b1[NumSections], b2[NumSections], a1[NumSections], a2[NumSections];
+    __m128 z1[NumSections], z2[NumSections];
+    for (int s = 0; s < NumSections; s++) {
+        b0[s] = _mm_loadu_ps(coefficients + (s * 5 + 0) * Lanes);
+        b1[s] = _mm_loadu_ps(coefficients + (s * 5 + 1) * Lanes);
+        b2[s] = _mm_loadu_ps(coefficients + (s * 5 + 2) * Lanes);
+        a1[s] = _mm_loadu_ps(coefficients + (s * 5 + 3) * Lanes);
+        a2[s] = _mm_loadu_ps(coefficients + (s * 5 + 4) * Lanes);
+        z1[s] = _mm_loadu_ps(state + (s * 2 + 0) * Lanes);
+        z2[s] = _mm_loadu_ps(state + (s * 2 + 1) * Lanes);
+    }
+    __m128 env = _mm_loadu_ps(envelope);
+    const __m128 attack = _mm_set1_ps(m_attack);
+    const __m128 release = _mm_set1_ps(m_release);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    for (size_t n = 0; n < count; n++) {
+        __m128 x = _mm_set1_ps(samples[n] + DenormalGuard);
+        for (int s = 0; s < NumSections; s++) {
+            const __m128 y = _mm_add_ps(_mm_mul_ps(b0[s], x), z1[s]);
+            z1[s] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1[s], x), _mm_mul_ps(a1[s], y)), z2[s]);
+            z2[s] = _mm_sub_ps(_mm_mul_ps(b2[s], x), _mm_mul_ps(a2[s], y));
+            x = y;
+        }
+
+        // Attack where the rectified signal is above the envelope, release elsewhere
+        const __m128 rectified = _mm_and_ps(x, absMask);
+        const __m128 rising = _mm_cmpgt_ps(rectified, env);
+        const __m128 rate = _mm_or_ps(_mm_and_ps(rising, attack), _mm_andnot_ps(rising, release));
+        env = _mm_add_ps(env, _mm_mul_ps(rate, _mm_sub_ps(rectified, env)));
+    }
+
+    for (int s = 0; s < NumSections; s++) {
+        _mm_storeu_ps(state + (s * 2 + 0) * Lanes, z1[s]);
+        _mm_storeu_ps(state + (s * 2 + 1) * Lanes, z2[s]);
+    }
+    _mm_storeu_ps(envelope, env);
+#else
+    for (int lane = 0; lane < Lanes; lane++) {
+        float env = envelope[lane];
+        for (size_t n = 0; n < count; n++) {
+            float x = samples[n] + DenormalGuard;
+            for (int s = 0; s < NumSections; s++) {
+                const float* c = coefficients + s * 5 * Lanes + lane;
+                float* z = state + s * 2 * Lanes + lane;
+                const float y = c[0] * x + z[0];
+                z[0] = c[Lanes] * x - c[3 * Lanes] * y + z[Lanes];
+                z[Lanes] = c[2 * Lanes] * x - c[4 * Lanes] * y;
+                x = y;
+            }
+
+            const float rectified = std::fabs(x);
+            env += (rectified > env ? m_attack : m_release) * (rectified - env);
+        }
+        envelope[lane] = env;
+    }
+#endif
+}
+
+} // namespace av
@@ -0,0 +1,106 @@
+#include "audio/DecimationChain.h"
+#include <iostream>
+#include <algorithm>
+
+namespace av {
+
+DecimationChain::DecimationChain()
+    : m_sampleRate(0)
+    , m_maxBlockSize(0)
+    , m_activeStages(0)
+{
+}
+
+bool DecimationChain::initialize(int sampleRate, int numStages, size_t maxBlockSize, int taps)
+{
+    if (sampleRate <= 0 || numStages < 0 || numStages > 16 || maxBlockSize < 2) {
+        std::cerr << "Invalid decimation chain: " << numStages << " stages at " << sampleRate << " Hz" << std::endl;
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_maxBlockSize = maxBlockSize;
+    m_inputSubscribers.clear();
+    m_stages.clear();
+    m_stages.resize(numStages);
+    m_activeStages = 0;
+
+    // Each stage sees at most the previous stage's largest output block
+    size_t stageInput = maxBlockSize;
+    for (int s = 0; s < numStages; s++) {
+        if (!m_stages[s].decimator.initialize(taps, std::max<size_t>(2, stageInput))) {
+            return false;
+        }
+        stageInput = (stageInput + 1) / 2;
+        m_stages[s].output.assign(stageInput, 0.0f);
+    }
+    return true;
+}
+
+void DecimationChain::reset()
+{
+    for (Stage& stage : m_stages) {
+        stage.decimator.reset();
+    }
+}
+
+bool DecimationChain::subscribe(int decimation, StreamCallback callback)
+{
+    int stages = 0;
+    while ((1 << stages) < decimation) {
+        stages++;
+    }
+    if (decimation < 1 || (1 << stages) != decimation || stages > getNumStages()) {
+        std::cerr << "Decimation chain has no stream at 1/" << decimation << " rate (up to 1/"
+                  << getMaxDecimation() << ")" << std::endl;
+        return false;
+    }
+
+    if (stages == 0) {
+        m_inputSubscribers.push_back(std::move(callback));
+    } else {
+        m_stages[stages - 1].subscribers.push_back(std::move(callback));
+        m_activeStages = std::max(m_activeStages, stages);
+    }
+    return true;
+}
+
+void DecimationChain::process(const float* samples, size_t count)
+{
+    while (count > 0) {
+        const size_t block = std::min(count, m_maxBlockSize);
+
+        for (const StreamCallback& callback : m_inputSubscribers) {
+            callback(samples, block);
+        }
+
+        // Each stage feeds the next
+        const float* stageInput = samples;
+        size_t stageCount = block;
+        for (int s = 0; s < m_activeStages; s++) {
+            Stage& stage = m_stages[s];
+            stageCount = stage.decimator.process(stageInput, stageCount, stage.output.data());
+            for (const StreamCallback& callback : stage.subscribers) {
+                callback(stage.output.data(), stageCount);
+            }
+            stageInput = stage.output.data();
+        }
+
+        samples += block;
+        count -= block;
+    }
+}
+
+int DecimationChain::getDelay(int decimation) const
+{
+    // A stage's delay counts in its own input samples
+    int delay = 0;
+    int scale = 1;
+    for (int s = 0; s < getNumStages() && (2 << s) <= decimation; s++) {
+        delay += m_stages[s].decimator.getDelay() * scale;
+        scale *= 2;
+    }
+    return delay;
+}
+
+} // namespace av
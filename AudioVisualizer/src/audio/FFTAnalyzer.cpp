@@ -1,8 +1,10 @@
-#include "AudioProcessor.h"
+#include "FFTAnalyzer.h"
+#include "audio/FFTPlan.h"
+#include "audio/FastMath.h"
+#include <iostream>
 #include <cmath>
-#include <vector>
-#include <complex>
 #include <algorithm>
+#include <cstdint>
 
 // Define M_PI if not available
 #ifndef M_PI
@@ -11,89 +13,275 @@
 
 namespace av {
 
-// Simple FFT implementation (placeholder for a real FFT library)
-// In a production system, you would use a real FFT library like FFTW or kiss_fft
-class FFTAnalyzer {
-public:
-    // Perform FFT on the input data and return the magnitude spectrum
-    static std::vector<float> computeFFT(const std::vector<float>& input) {
-        // Ensure input size is a power of 2
-        int size = nextPowerOf2(input.size());
-        
-        // Pad input if necessary
-        std::vector<std::complex<float>> data(size);
-        for (size_t i = 0; i < input.size(); ++i) {
-            data[i] = std::complex<float>(input[i], 0.0f);
+FFTAnalyzer::FFTAnalyzer() 
+    : m_mode(Mode::STFT)
+    , m_sampleRate(0)
+    , m_fftSize(0)
+    , m_hopSize(0)
+    , m_writePosition(0)
+    , m_samplesUntilFrame(0)
+    , m_samplesProcessed(0)
+    , m_frameCount(0)
+    , m_initialized(false)
+{
+}
+
+FFTAnalyzer::~FFTAnalyzer() {
+    shutdown();
+}
+
+bool FFTAnalyzer::initialize(int sampleRate, int fftSize, int hopSize) {
+    if (m_initialized) {
+        shutdown();
+    }
+    
+    // The radix-2 FFT needs a power-of-two size
+    if (!m_realFFT.initialize(fftSize)) {
+        return false;
+    }
+    
+    if (hopSize <= 0 || hopSize > fftSize) {
+        std::cerr << "STFT hop size must be in 1.." << fftSize << ", got " << hopSize << std::endl;
+        return false;
+    }
+    
+    m_mode = Mode::STFT;
+    m_sampleRate = sampleRate;
+    m_fftSize = fftSize;
+    m_hopSize = hopSize;
+    
+    // Initialize buffers
+    m_inputBuffer.assign(m_fftSize * 2, 0.0f);
+    m_frequencyData.assign(m_fftSize / 2 + 1, 0.0f);
+    
+    m_initialized = true;
+    reset();
+    
+    return true;
+}
+
+bool FFTAnalyzer::initialize(int sampleRate, int fftSize, Overlap overlap) {
+    return initialize(sampleRate, fftSize, fftSize / static_cast<int>(overlap));
+}
+
+bool FFTAnalyzer::initializeSliding(int sampleRate, int fftSize, const std::vector<int>& bins, float damping) {
+    if (m_initialized) {
+        shutdown();
+    }
+    
+    if (sampleRate <= 0 || !m_slidingDFT.initialize(fftSize, bins, damping, true)) {
+        return false;
+    }
+    
+    m_mode = Mode::SlidingDFT;
+    m_sampleRate = sampleRate;
+    m_fftSize = fftSize;
+    m_hopSize = 0;
+    
+    // No frame buffer: the sliding DFT keeps its own history
+    m_frequencyData.assign(bins.size(), -100.0f);
+    
+    m_initialized = true;
+    reset();
+    
+    return true;
+}
+
+void FFTAnalyzer::reset() {
+    if (m_mode == Mode::SlidingDFT) {
+        m_slidingDFT.reset();
+    }
+    std::fill(m_inputBuffer.begin(), m_inputBuffer.end(), 0.0f);
+    m_writePosition = 0;
+    m_samplesUntilFrame = m_hopSize;
+    m_samplesProcessed = 0;
+    m_frameCount = 0;
+}
+
+void FFTAnalyzer::shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+    
+    m_inputBuffer.clear();
+    m_frequencyData.clear();
+    
+    m_initialized = false;
+}
+
+void FFTAnalyzer::processAudioBuffer(const float* buffer, int bufferSize) {
+    if (!m_initialized || !buffer) {
+        return;
+    }
+    
+    // Every selected bin is current after the buffer, so each buffer is a frame
+    if (m_mode == Mode::SlidingDFT) {
+        if (bufferSize > 0) {
+            m_slidingDFT.process(buffer, bufferSize);
+            m_samplesProcessed += bufferSize;
+            computeSlidingMagnitudes();
+            m_frameCount++;
+            emitFrame();
         }
+        return;
+    }
+    
+    float* input = m_inputBuffer.data();
+    int consumed = 0;
+    while (consumed < bufferSize) {
+        // Copy up to the end of the current hop (and the end of the circular buffer)
+        const int count = std::min({ bufferSize - consumed, m_samplesUntilFrame, m_fftSize - m_writePosition });
+        std::copy(buffer + consumed, buffer + consumed + count, input + m_writePosition);
+        std::copy(buffer + consumed, buffer + consumed + count, input + m_writePosition + m_fftSize);
         
-        // Apply window function (Hanning)
-        applyWindow(data, input.size());
-        
-        // Perform FFT
-        fft(data);
-        
-        // Compute magnitude spectrum
-        std::vector<float> spectrum(size / 2 + 1);
-        spectrum[0] = std::abs(data[0].real()) / size;  // DC component
-        
-        for (int i = 1; i < size / 2; ++i) {
-            spectrum[i] = 2.0f * std::sqrt(data[i].real() * data[i].real() + 
-                                          data[i].imag() * data[i].imag()) / size;
+        consumed += count;
+        m_samplesProcessed += count;
+        m_samplesUntilFrame -= count;
+        m_writePosition += count;
+        if (m_writePosition == m_fftSize) {
+            m_writePosition = 0;
         }
         
-        spectrum[size / 2] = std::abs(data[size / 2].real()) / size;  // Nyquist component
+        if (m_samplesUntilFrame == 0) {
+            // The newest fftSize samples are contiguous starting at the oldest slot
+            performFFT(input + m_writePosition);
+            m_frameCount++;
+            m_samplesUntilFrame = m_hopSize;
+            emitFrame();
+        }
+    }
+}
+
+void FFTAnalyzer::emitFrame() {
+    if (m_frameCallback) {
+        const int64_t startSample = static_cast<int64_t>(m_samplesProcessed) - m_fftSize;
+        const SpectralFrame frame = {
+            startSample,
+            (static_cast<double>(startSample) + 0.5 * m_fftSize) / m_sampleRate,
+            m_frequencyData
+        };
+        m_frameCallback(frame);
+    }
+}
+
+void FFTAnalyzer::performFFT(const float* window) {
+    // Windowed real-input FFT; the window is applied while packing, so the
+    // overlapping part of the input buffer stays intact
+    m_realFFT.forward(window, true);
+    
+    // Compute magnitude spectrum
+    computeMagnitudes();
+}
+
+void FFTAnalyzer::computeMagnitudes() {
+    // Compute magnitude spectrum (only need half the FFT result due to symmetry).
+    // Work on power directly: 20*log10(|X|/N) = 10*log10(|X|^2/N^2), which saves a sqrt per bin
+    const float* re = m_realFFT.getReal();
+    const float* im = m_realFFT.getImag();
+    const float powerScale = 1.0f / (static_cast<float>(m_fftSize) * m_fftSize);
+    const float decibelsPerNeper = 10.0f / 2.30258509f;     // 10 / ln(10)
+    float* output = m_frequencyData.data();
+    
+    for (int i = 0; i <= m_fftSize / 2; i++) {
+        float power = (re[i] * re[i] + im[i] * im[i]) * powerScale;
         
-        return spectrum;
+        // Convert to decibels with a lower limit (-100 dB is a magnitude of 1e-5)
+        float magnitudeDB = decibelsPerNeper * fastLog(std::max(power, 1e-12f));
+        output[i] = std::max(-100.0f, magnitudeDB);
     }
+}
+
+void FFTAnalyzer::computeSlidingMagnitudes() {
+    // Same dB scale as the STFT frames: |X|/N of a Hann-windowed frame is a quarter of the amplitude
+    const float decibelsPerNeper = 20.0f / 2.30258509f;     // 20 / ln(10)
+    float* output = m_frequencyData.data();
+    m_slidingDFT.getMagnitudes(output);
     
-private:
-    // Find the next power of 2
-    static int nextPowerOf2(int n) {
-        int power = 1;
-        while (power < n) {
-            power *= 2;
-        }
-        return power;
+    for (size_t i = 0; i < m_frequencyData.size(); i++) {
+        float magnitudeDB = decibelsPerNeper * fastLog(std::max(0.25f * output[i], 1e-6f));
+        output[i] = std::max(-100.0f, magnitudeDB);
     }
+}
+
+std::vector<float> FFTAnalyzer::computeFFT(const std::vector<float>& input) {
+    // Ensure input size is a power of 2
+    int size = FFTPlan::nextPowerOfTwo(static_cast<int>(std::max<size_t>(input.size(), 2)));
+    RealFFT realFFT;
+    realFFT.initialize(size);
     
-    // Apply a Hanning window function
-    static void applyWindow(std::vector<std::complex<float>>& data, int inputSize) {
+    if (static_cast<int>(input.size()) == size) {
+        realFFT.forward(input.data(), true);
+    } else {
+        // Padded input: the window has to span the real samples only
+        std::vector<float> padded(size, 0.0f);
+        const int inputSize = static_cast<int>(input.size());
         for (int i = 0; i < inputSize; ++i) {
-            float window = 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (inputSize - 1)));
-            data[i] *= window;
+            float window = (inputSize > 1) ? 0.5f * (1.0f - std::cos(2.0f * M_PI * i / (inputSize - 1))) : 1.0f;
+            padded[i] = input[i] * window;
         }
+        realFFT.forward(padded.data(), false);
     }
     
-    // Simple recursive FFT implementation (Cooley-Tukey algorithm)
-    static void fft(std::vector<std::complex<float>>& data) {
-        int n = data.size();
-        
-        if (n <= 1) {
-            return;
-        }
-        
-        // Divide
-        std::vector<std::complex<float>> even(n / 2);
-        std::vector<std::complex<float>> odd(n / 2);
-        
-        for (int i = 0; i < n / 2; ++i) {
-            even[i] = data[i * 2];
-            odd[i] = data[i * 2 + 1];
-        }
-        
-        // Conquer
-        fft(even);
-        fft(odd);
-        
-        // Combine
-        for (int k = 0; k < n / 2; ++k) {
-            float angle = -2.0f * M_PI * k / n;
-            std::complex<float> t(std::cos(angle), std::sin(angle));
-            t = t * odd[k];
-            data[k] = even[k] + t;
-            data[k + n / 2] = even[k] - t;
+    // Compute magnitude spectrum
+    std::vector<float> spectrum(size / 2 + 1);
+    realFFT.getMagnitudes(spectrum.data(), 2.0f / size);
+    
+    spectrum[0] = std::abs(realFFT.getBin(0).real()) / size;  // DC component
+    spectrum[size / 2] = std::abs(realFFT.getBin(size / 2).real()) / size;  // Nyquist component
+    
+    return spectrum;
+}
+
+const std::vector<float>& FFTAnalyzer::getFrequencyData() const {
+    return m_frequencyData;
+}
+
+float FFTAnalyzer::getLowFrequencyMagnitude() const {
+    return averageMagnitude(20.0f, 250.0f);
+}
+
+float FFTAnalyzer::getMidFrequencyMagnitude() const {
+    return averageMagnitude(250.0f, 4000.0f);
+}
+
+float FFTAnalyzer::getHighFrequencyMagnitude() const {
+    return averageMagnitude(4000.0f, 20000.0f);
+}
+
+float FFTAnalyzer::averageMagnitude(float lowFrequency, float highFrequency) const {
+    if (!m_initialized) {
+        return 0.0f;
+    }
+    
+    // Calculate frequency band indices
+    int lowIndex = static_cast<int>(lowFrequency * m_fftSize / m_sampleRate);
+    int highIndex = static_cast<int>(highFrequency * m_fftSize / m_sampleRate);
+    
+    // Calculate average magnitude over the selected bins in the band
+    if (m_mode == Mode::SlidingDFT) {
+        const std::vector<int>& bins = m_slidingDFT.getBins();
+        float sum = 0.0f;
+        int count = 0;
+        for (size_t i = 0; i < bins.size(); i++) {
+            if (bins[i] >= lowIndex && bins[i] <= highIndex) {
+                sum += m_frequencyData[i];
+                count++;
+            }
         }
+        return (count > 0) ? sum / count : 0.0f;
     }
-};
+    
+    // Ensure indices are within valid range
+    lowIndex = std::max(0, lowIndex);
+    highIndex = std::min(static_cast<int>(m_frequencyData.size() - 1), highIndex);
+    
+    // Calculate average magnitude in the band
+    float sum = 0.0f;
+    for (int i = lowIndex; i <= highIndex; i++) {
+        sum += m_frequencyData[i];
+    }
+    
+    return (highIndex >= lowIndex) ? sum / (highIndex - lowIndex + 1) : 0.0f;
+}
 
 } // namespace av 
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "audio/FFTKernels.h"
+#include "audio/Simd.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace av {
+
+// Defined in FFTKernelsAVX2.cpp, which is compiled with AVX2 enabled
+const FFTKernels* getAVX2Kernels();
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference kernels
+// ---------------------------------------------------------------------------
+
+void scalarRadix2(float* re, float* im, int n, int h, const float* wRe, const float* wIm)
+{
+    for (int start = 0; start < n; start += 2 * h) {
+        for (int k = 0; k < h; k++) {
+            const int a = start + k;
+            const int b = a + h;
+
+            const float tr = re[b] * wRe[k] - im[b] * wIm[k];
+            const float ti = re[b] * wIm[k] + im[b] * wRe[k];
+
+            re[b] = re[a] - tr;
+            im[b] = im[a] - ti;
+            re[a] += tr;
+            im[a] += ti;
+        }
+    }
+}
+
+void scalarRadix4(float* re, float* im, int n, int h,
+                  const float* w1Re, const float* w1Im,
+                  const float* w2Re, const float* w2Im)
+{
+    for (int start = 0; start < n; start += 4 * h) {
+        for (int k = 0; k < h; k++) {
+            const int a = start + k;
+            const int b = a + h;
+            const int c = a + 2 * h;
+            const int d = a + 3 * h;
+
+            // First stage: (a, b) and (c, d) with the size-2h twiddle
+            const float t1r = re[b] * w1Re[k] - im[b] * w1Im[k];
+            const float t1i = re[b] * w1Im[k] + im[b] * w1Re[k];
+            const float t2r = re[d] * w1Re[k] - im[d] * w1Im[k];
+            const float t2i = re[d] * w1Im[k] + im[d] * w1Re[k];
+
+            const float a0r = re[a] + t1r, a0i = im[a] + t1i;
+            const float a1r = re[a] - t1r, a1i = im[a] - t1i;
+            const float c0r = re[c] + t2r, c0i = im[c] + t2i;
+            const float c1r = re[c] - t2r, c1i = im[c] - t2i;
+
+            // Second stage: the size-4h twiddle, and the same twiddle times -i for the odd half
+            const float u0r = c0r * w2Re[k] - c0i * w2Im[k];
+            const float u0i = c0r * w2Im[k] + c0i * w2Re[k];
+            const float v1r = c1r * w2Re[k] - c1i * w2Im[k];
+            const float v1i = c1r * w2Im[k] + c1i * w2Re[k];
+            const float u1r = v1i;
+            const float u1i = -v1r;
+
+            re[a] = a0r + u0r; im[a] = a0i + u0i;
+            re[c] = a0r - u0r; im[c] = a0i - u0i;
+            re[b] = a1r + u1r; im[b] = a1i + u1i;
+            re[d] = a1r - u1r; im[d] = a1i - u1i;
+        }
+    }
+}
+
+#ifdef AV_SIMD_SSE2
+// ---------------------------------------------------------------------------
+// SSE2 kernels (4 butterflies per iteration)
+// ---------------------------------------------------------------------------
+
+inline void complexMul(__m128 xr, __m128 xi, __m128 wr, __m128 wi, __m128& outR, __m128& outI)
+{
+    outR = _mm_sub_ps(_mm_mul_ps(xr, wr), _mm_mul_ps(xi, wi));
+    outI = _mm_add_ps(_mm_mul_ps(xr, wi), _mm_mul_ps(xi, wr));
+}
+
+void sse2Radix2(float* re, float* im, int n, int h, const float* wRe, const float* wIm)
+{
+    for (int start = 0; start < n; start += 2 * h) {
+        for (int k = 0; k < h; k += 4) {
+            const int a = start + k;
+            const int b = a + h;
+
+            __m128 tr, ti;
+            complexMul(_mm_loadu_ps(re + b), _mm_loadu_ps(im + b),
+                       _mm_loadu_ps(wRe + k), _mm_loadu_ps(wIm + k), tr, ti);
+
+            const __m128 ar = _mm_loadu_ps(re + a);
+            const __m128 ai = _mm_loadu_ps(im + a);
+            _mm_storeu_ps(re + b, _mm_sub_ps(ar, tr));
+            _mm_storeu_ps(im + b, _mm_sub_ps(ai, ti));
+            _mm_storeu_ps(re + a, _mm_add_ps(ar, tr));
+            _mm_storeu_ps(im + a, _mm_add_ps(ai, ti));
+        }
+    }
+}
+
+void sse2Radix4(float* re, float* im, int n, int h,
+                const float* w1Re, const float* w1Im,
+                const float* w2Re, const float* w2Im)
+{
+    for (int start = 0; start < n; start += 4 * h) {
+        for (int k = 0; k < h; k += 4) {
+            const int a = start + k;
+            const int b = a + h;
+            const int c = a + 2 * h;
+            const int d = a + 3 * h;
+
+            const __m128 w1r = _mm_loadu_ps(w1Re + k);
+            const __m128 w1i = _mm_loadu_ps(w1Im + k);
+            const __m128 w2r = _mm_loadu_ps(w2Re + k);
+            const __m128 w2i = _mm_loadu_ps(w2Im + k);
+
+            __m128 t1r, t1i, t2r, t2i;
+            complexMul(_mm_loadu_ps(re + b), _mm_loadu_ps(im + b), w1r, w1i, t1r, t1i);
+            complexMul(_mm_loadu_ps(re + d), _mm_loadu_ps(im + d), w1r, w1i, t2r, t2i);
+
+            const __m128 ar = _mm_loadu_ps(re + a);
+            const __m128 ai = _mm_loadu_ps(im + a);
+            const __m128 cr = _mm_loadu_ps(re + c);
+            const __m128 ci = _mm_loadu_ps(im + c);
+
+            const __m128 a0r = _mm_add_ps(ar, t1r), a0i = _mm_add_ps(ai, t1i);
+            const __m128 a1r = _mm_sub_ps(ar, t1r), a1i = _mm_sub_ps(ai, t1i);
+            const __m128 c0r = _mm_add_ps(cr, t2r), c0i = _mm_add_ps(ci, t2i);
+            const __m128 c1r = _mm_sub_ps(cr, t2r), c1i = _mm_sub_ps(ci, t2i);
+
+            __m128 u0r, u0i, v1r, v1i;
+            complexMul(c0r, c0i, w2r, w2i, u0r, u0i);
+            complexMul(c1r, c1i, w2r, w2i, v1r, v1i);
+
+            // Multiply by -i: (x + iy) * -i = y - ix
+            _mm_storeu_ps(re + a, _mm_add_ps(a0r, u0r));
+            _mm_storeu_ps(im + a, _mm_add_ps(a0i, u0i));
+            _mm_storeu_ps(re + c, _mm_sub_ps(a0r, u0r));
+            _mm_storeu_ps(im + c, _mm_sub_ps(a0i, u0i));
+            _mm_storeu_ps(re + b, _mm_add_ps(a1r, v1i));
+            _mm_storeu_ps(im + b, _mm_sub_ps(a1i, v1r));
+            _mm_storeu_ps(re + d, _mm_sub_ps(a1r, v1i));
+            _mm_storeu_ps(im + d, _mm_add_ps(a1i, v1r));
+        }
+    }
+}
+#endif // AV_SIMD_SSE2
+
+bool cpuSupportsAVX2()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // AVX needs both CPU support and OS support for saving the YMM registers
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+const FFTKernels& FFTKernels::scalar()
+{
+    static const FFTKernels kernels = { "Scalar", 1, scalarRadix2, scalarRadix4, nullptr };
+    return kernels;
+}
+
+const FFTKernels* FFTKernels::sse2()
+{
+#ifdef AV_SIMD_SSE2
+    static const FFTKernels kernels = { "SSE2", 4, sse2Radix2, sse2Radix4, &scalar() };
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
+
+const FFTKernels* FFTKernels::avx2()
+{
+    static const bool supported = cpuSupportsAVX2();
+    return supported ? getAVX2Kernels() : nullptr;
+}
+
+const FFTKernels& FFTKernels::best()
+{
+    static const FFTKernels& selected = []() -> const FFTKernels& {
+        if (avx2()) {
+            return *avx2();
+        }
+        if (sse2()) {
+            return *sse2();
+        }
+        return scalar();
+    }();
+    return selected;
+}
+
+} // namespace av
@@ -0,0 +1,103 @@
+// Built with AVX2 code generation enabled (see CMakeLists.txt). Nothing in this
+// file may run unless FFTKernels::avx2() has confirmed AVX2 support via CPUID.
+#include "audio/FFTKernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace av {
+
+#ifdef __AVX2__
+namespace {
+
+inline void complexMul(__m256 xr, __m256 xi, __m256 wr, __m256 wi, __m256& outR, __m256& outI)
+{
+    outR = _mm256_sub_ps(_mm256_mul_ps(xr, wr), _mm256_mul_ps(xi, wi));
+    outI = _mm256_add_ps(_mm256_mul_ps(xr, wi), _mm256_mul_ps(xi, wr));
+}
+
+void avx2Radix2(float* re, float* im, int n, int h, const float* wRe, const float* wIm)
+{
+    for (int start = 0; start < n; start += 2 * h) {
+        for (int k = 0; k < h; k += 8) {
+            const int a = start + k;
+            const int b = a + h;
+
+            __m256 tr, ti;
+            complexMul(_mm256_loadu_ps(re + b), _mm256_loadu_ps(im + b),
+                       _mm256_loadu_ps(wRe + k), _mm256_loadu_ps(wIm + k), tr, ti);
+
+            const __m256 ar = _mm256_loadu_ps(re + a);
+            const __m256 ai = _mm256_loadu_ps(im + a);
+            _mm256_storeu_ps(re + b, _mm256_sub_ps(ar, tr));
+            _mm256_storeu_ps(im + b, _mm256_sub_ps(ai, ti));
+            _mm256_storeu_ps(re + a, _mm256_add_ps(ar, tr));
+            _mm256_storeu_ps(im + a, _mm256_add_ps(ai, ti));
+        }
+    }
+}
+
+void avx2Radix4(float* re, float* im, int n, int h,
+                const float* w1Re, const float* w1Im,
+                const float* w2Re, const float* w2Im)
+{
+    for (int start = 0; start < n; start += 4 * h) {
+        for (int k = 0; k < h; k += 8) {
+            const int a = start + k;
+            const int b = a + h;
+            const int c = a + 2 * h;
+            const int d = a + 3 * h;
+
+            const __m256 w1r = _mm256_loadu_ps(w1Re + k);
+            const __m256 w1i = _mm256_loadu_ps(w1Im + k);
+            const __m256 w2r = _mm256_loadu_ps(w2Re + k);
+            const __m256 w2i = _mm256_loadu_ps(w2Im + k);
+
+            __m256 t1r, t1i, t2r, t2i;
+            complexMul(_mm256_loadu_ps(re + b), _mm256_loadu_ps(im + b), w1r, w1i, t1r, t1i);
+            complexMul(_mm256_loadu_ps(re + d), _mm256_loadu_ps(im + d), w1r, w1i, t2r, t2i);
+
+            const __m256 ar = _mm256_loadu_ps(re + a);
+            const __m256 ai = _mm256_loadu_ps(im + a);
+            const __m256 cr = _mm256_loadu_ps(re + c);
+            const __m256 ci = _mm256_loadu_ps(im + c);
+
+            const __m256 a0r = _mm256_add_ps(ar, t1r), a0i = _mm256_add_ps(ai, t1i);
+            const __m256 a1r = _mm256_sub_ps(ar, t1r), a1i = _mm256_sub_ps(ai, t1i);
+            const __m256 c0r = _mm256_add_ps(cr, t2r), c0i = _mm256_add_ps(ci, t2i);
+            const __m256 c1r = _mm256_sub_ps(cr, t2r), c1i = _mm256_sub_ps(ci, t2i);
+
+            __m256 u0r, u0i, v1r, v1i;
+            complexMul(c0r, c0i, w2r, w2i, u0r, u0i);
+            complexMul(c1r, c1i, w2r, w2i, v1r, v1i);
+
+            // Multiply by -i: (x + iy) * -i = y - ix
+            _mm256_storeu_ps(re + a, _mm256_add_ps(a0r, u0r));
+            _mm256_storeu_ps(im + a, _mm256_add_ps(a0i, u0i));
+            _mm256_storeu_ps(re + c, _mm256_sub_ps(a0r, u0r));
+            _mm256_storeu_ps(im + c, _mm256_sub_ps(a0i, u0i));
+            _mm256_storeu_ps(re + b, _mm256_add_ps(a1r, v1i));
+            _mm256_storeu_ps(im + b, _mm256_sub_ps(a1i, v1r));
+            _mm256_storeu_ps(re + d, _mm256_sub_ps(a1r, v1i));
+            _mm256_storeu_ps(im + d, _mm256_add_ps(a1i, v1r));
+        }
+    }
+}
+
+} // namespace
+#endif // __AVX2__
+
+// Only called through FFTKernels::avx2()
+const FFTKernels* getAVX2Kernels()
+{
+#ifdef __AVX2__
+    static const FFTKernels kernels = { "AVX2", 8, avx2Radix2, avx2Radix4,
+                                        FFTKernels::sse2() ? FFTKernels::sse2() : &FFTKernels::scalar() };
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace av
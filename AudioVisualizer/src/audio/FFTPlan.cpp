@@ -0,0 +1,177 @@
+#include "audio/FFTPlan.h"
+#include "audio/FFTKernels.h"
+#include <cmath>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+// Define M_PI if not available
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace av {
+
+FFTPlan::FFTPlan(int size)
+    : m_size(size)
+    , m_log2Size(0)
+    , m_windowSum(0.0f)
+{
+    while ((1 << m_log2Size) < m_size) {
+        m_log2Size++;
+    }
+
+    // Bit-reversal permutation
+    m_bitReverse.resize(m_size);
+    for (int i = 0; i < m_size; i++) {
+        uint32_t reversed = 0;
+        for (int bit = 0; bit < m_log2Size; bit++) {
+            if (i & (1 << bit)) {
+                reversed |= 1u << (m_log2Size - 1 - bit);
+            }
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    // Twiddle factors for the largest stage; smaller stages use a stride into this table.
+    // Computed in double precision so large sizes don't accumulate rounding error.
+    m_twiddles.resize(m_size / 2);
+    for (int k = 0; k < m_size / 2; k++) {
+        double angle = -2.0 * M_PI * k / m_size;
+        m_twiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)),
+                                            static_cast<float>(std::sin(angle)));
+    }
+
+    // Contiguous twiddles for each stage so SIMD kernels can load them directly
+    m_stageTwiddlesRe.resize(std::max(m_size - 1, 1));
+    m_stageTwiddlesIm.resize(std::max(m_size - 1, 1));
+    for (int half = 1; half < m_size; half <<= 1) {
+        const int stride = m_size / (2 * half);
+        for (int k = 0; k < half; k++) {
+            m_stageTwiddlesRe[half - 1 + k] = m_twiddles[k * stride].real();
+            m_stageTwiddlesIm[half - 1 + k] = m_twiddles[k * stride].imag();
+        }
+    }
+
+    // Hann window: 0.5 * (1 - cos(2*pi*n/(N-1)))
+    m_window.resize(m_size);
+    for (int i = 0; i < m_size; i++) {
+        m_window[i] = (m_size > 1)
+            ? static_cast<float>(0.5 * (1.0 - std::cos(2.0 * M_PI * i / (m_size - 1))))
+            : 1.0f;
+        m_windowSum += m_window[i];
+    }
+}
+
+std::shared_ptr<const FFTPlan> FFTPlan::get(int size)
+{
+    if (!isPowerOfTwo(size)) {
+        return nullptr;
+    }
+
+    static std::mutex cacheMutex;
+    static std::unordered_map<int, std::shared_ptr<const FFTPlan>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(size);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    auto plan = std::make_shared<const FFTPlan>(size);
+    cache[size] = plan;
+    return plan;
+}
+
+int FFTPlan::nextPowerOfTwo(int n)
+{
+    int power = 1;
+    while (power < n) {
+        power *= 2;
+    }
+    return power;
+}
+
+void FFTPlan::applyWindow(const float* input, std::complex<float>* output) const
+{
+    for (int i = 0; i < m_size; i++) {
+        output[i] = std::complex<float>(input[i] * m_window[i], 0.0f);
+    }
+}
+
+void FFTPlan::forward(std::complex<float>* data) const
+{
+    // Reorder input into bit-reversed order
+    for (int i = 0; i < m_size; i++) {
+        int j = static_cast<int>(m_bitReverse[i]);
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    // Iterative Cooley-Tukey butterflies, doubling the transform length each stage
+    for (int length = 2; length <= m_size; length <<= 1) {
+        const int half = length / 2;
+        const int twiddleStride = m_size / length;
+
+        for (int start = 0; start < m_size; start += length) {
+            for (int k = 0; k < half; k++) {
+                const std::complex<float>& w = m_twiddles[k * twiddleStride];
+                std::complex<float>& a = data[start + k];
+                std::complex<float>& b = data[start + k + half];
+
+                // Manual complex multiply avoids the NaN/Inf handling in operator*
+                float tr = b.real() * w.real() - b.imag() * w.imag();
+                float ti = b.real() * w.imag() + b.imag() * w.real();
+
+                b = std::complex<float>(a.real() - tr, a.imag() - ti);
+                a = std::complex<float>(a.real() + tr, a.imag() + ti);
+            }
+        }
+    }
+}
+
+void FFTPlan::forward(float* re, float* im) const
+{
+    forward(re, im, FFTKernels::best());
+}
+
+void FFTPlan::forward(float* re, float* im, const FFTKernels& kernels) const
+{
+    // Reorder input into bit-reversed order
+    for (int i = 0; i < m_size; i++) {
+        int j = static_cast<int>(m_bitReverse[i]);
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    const float* twRe = m_stageTwiddlesRe.data();
+    const float* twIm = m_stageTwiddlesIm.data();
+
+    // Narrow passes drop down the fallback chain until the vector width fits
+    auto kernelsFor = [&kernels](int h) {
+        const FFTKernels* selected = &kernels;
+        while (h < selected->width && selected->fallback) {
+            selected = selected->fallback;
+        }
+        return selected;
+    };
+
+    // An odd number of stages needs one radix-2 pass first
+    int h = 1;
+    if (m_log2Size & 1) {
+        kernelsFor(h)->radix2(re, im, m_size, h, twRe + h - 1, twIm + h - 1);
+        h = 2;
+    }
+
+    // Fused radix-4 passes for the remaining stage pairs
+    for (; h < m_size; h *= 4) {
+        kernelsFor(h)->radix4(re, im, m_size, h,
+                              twRe + h - 1, twIm + h - 1,
+                              twRe + 2 * h - 1, twIm + 2 * h - 1);
+    }
+}
+
+} // namespace av
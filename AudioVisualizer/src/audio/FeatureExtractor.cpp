@@ -0,0 +1,287 @@
+#include "audio/FeatureExtractor.h"
+#include "audio/FastMath.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// Power floor for the flatness logs (-120 dB)
+const float PowerFloor = 1e-12f;
+
+// Below this total magnitude the frame counts as silent and has no spectral shape
+const float SilenceMagnitude = 1e-9f;
+
+} // namespace
+
+FeatureExtractor::FeatureExtractor()
+    : m_sampleRate(0)
+    , m_numBins(0)
+    , m_blockSize(0)
+    , m_binWidth(0.0f)
+    , m_rolloffFraction(0.85f)
+    , m_blockIndex(0)
+{
+}
+
+bool FeatureExtractor::initialize(int sampleRate, int fftSize, int blockSize, float rolloffFraction)
+{
+    if (sampleRate <= 0 || fftSize < 4 || blockSize < 1 || blockSize > fftSize ||
+        rolloffFraction <= 0.0f || rolloffFraction > 1.0f) {
+        std::cerr << "Feature extractor needs a sample rate, an FFT size, a block size up to the FFT size"
+                  << " and a rolloff fraction in (0, 1]" << std::endl;
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_numBins = fftSize / 2 + 1;
+    m_blockSize = blockSize;
+    m_binWidth = static_cast<float>(sampleRate) / fftSize;
+    m_rolloffFraction = rolloffFraction;
+
+    m_previous.assign(m_numBins, 0.0f);
+    m_chunkSums.assign((m_numBins + 3) / 4, 0.0f);
+
+    // 4x interpolator: Blackman-windowed sinc cut off at the input Nyquist, centred on
+    // tap 6 of phase 0 so that phase passes the input straight through (6 samples late)
+    const int length = PeakTaps * 4;
+    m_peakCoefficients.assign(length, 0.0f);
+    for (int phase = 0; phase < 4; phase++) {
+        double sum = 0.0;
+        for (int tap = 0; tap < PeakTaps; tap++) {
+            const int i = tap * 4 + phase;
+            const double x = (i - length / 2) / 4.0;
+            const double sinc = (x == 0.0) ? 1.0 : std::sin(Pi * x) / (Pi * x);
+            const double window = 0.42 - 0.5 * std::cos(2.0 * Pi * i / length) + 0.08 * std::cos(4.0 * Pi * i / length);
+            m_peakCoefficients[tap * 4 + phase] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+        // Unity gain at DC for every phase
+        for (int tap = 0; tap < PeakTaps; tap++) {
+            m_peakCoefficients[tap * 4 + phase] = static_cast<float>(m_peakCoefficients[tap * 4 + phase] / sum);
+        }
+    }
+    m_input.assign(PeakTaps - 1 + blockSize, 0.0f);
+
+    const int numBlocks = std::max(1, fftSize / blockSize);
+    m_blockEnergy.assign(numBlocks, 0.0f);
+    m_blockCrossings.assign(numBlocks, 0);
+    m_blockLength.assign(numBlocks, 0);
+    reset();
+    return true;
+}
+
+void FeatureExtractor::reset()
+{
+    std::fill(m_previous.begin(), m_previous.end(), 0.0f);
+    std::fill(m_input.begin(), m_input.end(), 0.0f);
+    std::fill(m_blockEnergy.begin(), m_blockEnergy.end(), 0.0f);
+    std::fill(m_blockCrossings.begin(), m_blockCrossings.end(), 0);
+    std::fill(m_blockLength.begin(), m_blockLength.end(), 0);
+    m_blockIndex = 0;
+    m_features = AudioFeatures();
+}
+
+void FeatureExtractor::processSpectrum(const float* magnitudes)
+{
+    const int numBins = m_numBins;
+    float* previous = m_previous.data();
+    float* chunkSums = m_chunkSums.data();
+
+    float sum = 0.0f;           // Sum of magnitudes
+    float weighted = 0.0f;      // ... times frequency
+    float weighted2 = 0.0f;     // ... times frequency squared
+    float power = 0.0f;         // Sum of power
+    float logPower = 0.0f;      // Sum of log power
+    float rise = 0.0f;          // Sum of magnitude increases
+
+    int k = 0;
+#ifdef AV_SIMD_SSE2
+    __m128 sumV = _mm_setzero_ps();
+    __m128 weightedV = _mm_setzero_ps();
+    __m128 weighted2V = _mm_setzero_ps();
+    __m128 powerV = _mm_setzero_ps();
+    __m128 logPowerV = _mm_setzero_ps();
+    __m128 riseV = _mm_setzero_ps();
+    __m128 frequency = _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f), _mm_set1_ps(m_binWidth));
+    const __m128 frequencyStep = _mm_set1_ps(4.0f * m_binWidth);
+    const __m128 floor = _mm_set1_ps(PowerFloor);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; k + 4 <= numBins; k += 4) {
+        const __m128 magnitude = _mm_loadu_ps(magnitudes + k);
+        const __m128 last = _mm_loadu_ps(previous + k);
+        _mm_storeu_ps(previous + k, magnitude);
+
+        sumV = _mm_add_ps(sumV, magnitude);
+        const __m128 moment = _mm_mul_ps(frequency, magnitude);
+        weightedV = _mm_add_ps(weightedV, moment);
+        weighted2V = _mm_add_ps(weighted2V, _mm_mul_ps(frequency, moment));
+
+        const __m128 binPower = _mm_max_ps(_mm_mul_ps(magnitude, magnitude), floor);
+        powerV = _mm_add_ps(powerV, binPower);
+        logPowerV = _mm_add_ps(logPowerV, fastLog(binPower));
+
+        riseV = _mm_add_ps(riseV, _mm_max_ps(_mm_sub_ps(magnitude, last), zero));
+        chunkSums[k / 4] = horizontalSum(magnitude);
+        frequency = _mm_add_ps(frequency, frequencyStep);
+    }
+
+    sum = horizontalSum(sumV);
+    weighted = horizontalSum(weightedV);
+    weighted2 = horizontalSum(weighted2V);
+    power = horizontalSum(powerV);
+    logPower = horizontalSum(logPowerV);
+    rise = horizontalSum(riseV);
+#endif
+    for (; k < numBins; k++) {
+        const float magnitude = magnitudes[k];
+        // Start each chunk of four bins from zero (all of them on the scalar path)
+        if ((k & 3) == 0) {
+            chunkSums[k / 4] = 0.0f;
+        }
+        const float frequency = k * m_binWidth;
+        sum += magnitude;
+        weighted += frequency * magnitude;
+        weighted2 += frequency * frequency * magnitude;
+
+        const float binPower = std::max(magnitude * magnitude, PowerFloor);
+        power += binPower;
+        logPower += fastLog(binPower);
+
+        rise += std::max(magnitude - previous[k], 0.0f);
+        previous[k] = magnitude;
+        chunkSums[k / 4] += magnitude;
+    }
+
+    AudioFeatures& features = m_features;
+    if (sum < SilenceMagnitude) {
+        features.centroid = 0.0f;
+        features.spread = 0.0f;
+        features.rolloff = 0.0f;
+        features.flatness = 0.0f;
+        features.flux = 0.0f;
+        return;
+    }
+
+    features.centroid = weighted / sum;
+    features.spread = std::sqrt(std::max(0.0f, weighted2 / sum - features.centroid * features.centroid));
+    features.flatness = std::min(1.0f, std::exp(logPower / numBins) / (power / numBins));
+    features.flux = rise / sum;
+
+    // Rolloff: find the four bins holding the threshold, then the bin within them
+    const float threshold = m_rolloffFraction * sum;
+    float cumulative = 0.0f;
+    int chunk = 0;
+    const int numChunks = static_cast<int>(m_chunkSums.size());
+    while (chunk < numChunks - 1 && cumulative + chunkSums[chunk] < threshold) {
+        cumulative += chunkSums[chunk];
+        chunk++;
+    }
+    int bin = chunk * 4;
+    const int lastBin = std::min(bin + 3, numBins - 1);
+    while (bin < lastBin && cumulative + magnitudes[bin] < threshold) {
+        cumulative += magnitudes[bin];
+        bin++;
+    }
+    features.rolloff = bin * m_binWidth;
+}
+
+void FeatureExtractor::processBlock(const float* samples, size_t count)
+{
+    const int history = PeakTaps - 1;
+    float callPeak = 0.0f;
+    while (count > 0) {
+        const size_t block = std::min(count, static_cast<size_t>(m_blockSize));
+        float* x = m_input.data() + history;
+        std::copy(samples, samples + block, x);
+
+        float energy = 0.0f;
+        int crossings = 0;
+        float peak = 0.0f;
+
+        size_t n = 0;
+#ifdef AV_SIMD_SSE2
+        // Phase p of tap t sits in lane p, so one broadcast sample feeds all four phases
+        __m128 taps[PeakTaps];
+        for (int t = 0; t < PeakTaps; t++) {
+            taps[t] = _mm_loadu_ps(&m_peakCoefficients[t * 4]);
+        }
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const __m128 zero = _mm_setzero_ps();
+        __m128 energyV = _mm_setzero_ps();
+        __m128i crossingsV = _mm_setzero_si128();
+        __m128 peakV = _mm_setzero_ps();
+
+        for (; n + 4 <= block; n += 4) {
+            const __m128 current = _mm_loadu_ps(x + n);
+            const __m128 before = _mm_loadu_ps(x + n - 1);
+            energyV = _mm_add_ps(energyV, _mm_mul_ps(current, current));
+
+            // A negative product marks a sign change (the all-ones mask counts as -1)
+            crossingsV = _mm_sub_epi32(crossingsV, _mm_castps_si128(_mm_cmplt_ps(_mm_mul_ps(current, before), zero)));
+
+            for (size_t j = n; j < n + 4; j++) {
+                __m128 interpolated = _mm_mul_ps(taps[0], _mm_set1_ps(x[j]));
+                for (int t = 1; t < PeakTaps; t++) {
+                    interpolated = _mm_add_ps(interpolated, _mm_mul_ps(taps[t], _mm_set1_ps(x[j - t])));
+                }
+                peakV = _mm_max_ps(peakV, _mm_and_ps(interpolated, absMask));
+            }
+        }
+
+        energy = horizontalSum(energyV);
+        int lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), crossingsV);
+        crossings = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        float peaks[4];
+        _mm_storeu_ps(peaks, peakV);
+        peak = std::max(std::max(peaks[0], peaks[1]), std::max(peaks[2], peaks[3]));
+#endif
+        for (; n < block; n++) {
+            energy += x[n] * x[n];
+            crossings += (x[n] * x[n - 1] < 0.0f) ? 1 : 0;
+            for (int phase = 0; phase < 4; phase++) {
+                float interpolated = 0.0f;
+                for (int t = 0; t < PeakTaps; t++) {
+                    interpolated += m_peakCoefficients[t * 4 + phase] * x[n - t];
+                }
+                peak = std::max(peak, std::fabs(interpolated));
+            }
+        }
+
+        // Keep the tail as history for the next block
+        std::copy(x + block - history, x + block, m_input.data());
+
+        m_blockEnergy[m_blockIndex] = energy;
+        m_blockCrossings[m_blockIndex] = crossings;
+        m_blockLength[m_blockIndex] = block;
+        m_blockIndex = (m_blockIndex + 1) % m_blockEnergy.size();
+        callPeak = std::max(callPeak, peak);
+
+        samples += block;
+        count -= block;
+    }
+
+    m_features.truePeak = callPeak;
+
+    // Frame values from the blocks it spans
+    float frameEnergy = 0.0f;
+    int frameCrossings = 0;
+    size_t frameLength = 0;
+    for (size_t i = 0; i < m_blockEnergy.size(); i++) {
+        frameEnergy += m_blockEnergy[i];
+        frameCrossings += m_blockCrossings[i];
+        frameLength += m_blockLength[i];
+    }
+    if (frameLength > 0) {
+        m_features.rms = std::sqrt(frameEnergy / frameLength);
+        m_features.zeroCrossingRate = static_cast<float>(frameCrossings) / frameLength;
+    }
+}
+
+} // namespace av
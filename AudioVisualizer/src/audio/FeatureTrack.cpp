@@ -0,0 +1,241 @@
+#include "audio/FeatureTrack.h"
+#include "AudioProcessor.h"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const char Magic[4] = { 'A', 'V', 'F', 'T' };
+const uint32_t Version = 1;
+
+static_assert(sizeof(FeatureTrackHeader) == 48, "feature track header must have no padding");
+static_assert(sizeof(FeatureTrackIndexEntry) == 16, "feature track index entries must have no padding");
+static_assert(sizeof(FeatureTrackFrame) == 16, "feature track frames must have no padding");
+
+// Records are padded so every one starts 4-byte aligned
+size_t paddedFrameBytes(int spectrumBins, int numBands)
+{
+    return (sizeof(FeatureTrackFrame) + spectrumBins + numBands + 3) & ~static_cast<size_t>(3);
+}
+
+uint16_t quantize16(float level)
+{
+    return static_cast<uint16_t>(std::lround(std::max(0.0f, std::min(1.0f, level)) * 65535.0f));
+}
+
+uint8_t quantize8(float level)
+{
+    return static_cast<uint8_t>(std::lround(std::max(0.0f, std::min(1.0f, level)) * 255.0f));
+}
+
+} // namespace
+
+FeatureTrackWriter::FeatureTrackWriter()
+    : m_sampleRate(0)
+    , m_hopSize(0)
+    , m_spectrumBins(0)
+    , m_numBands(0)
+    , m_frameBytes(0)
+{
+}
+
+bool FeatureTrackWriter::initialize(int sampleRate, int hopSize, int spectrumBins, int numBands)
+{
+    if (sampleRate <= 0 || hopSize <= 0 || spectrumBins < 0 || numBands < 0) {
+        std::cerr << "Feature track needs a sample rate and hop size" << std::endl;
+        return false;
+    }
+    m_sampleRate = sampleRate;
+    m_hopSize = hopSize;
+    m_spectrumBins = spectrumBins;
+    m_numBands = numBands;
+    m_frameBytes = paddedFrameBytes(spectrumBins, numBands);
+    return true;
+}
+
+void FeatureTrackWriter::encode(const AudioData& frame, uint8_t flags, uint8_t* record) const
+{
+    FeatureTrackFrame levels;
+    levels.energy = quantize16(frame.energy);
+    levels.bass = quantize16(frame.bass);
+    levels.mid = quantize16(frame.mid);
+    levels.treble = quantize16(frame.treble);
+    levels.onset = quantize16(frame.onset);
+    levels.beatPhase = quantize16(frame.beatPhase);
+    levels.bpm = static_cast<uint16_t>(std::lround(std::max(0.0f, std::min(655.0f, frame.bpm)) * 100.0f));
+    levels.flags = flags;
+    levels.reserved = 0;
+    std::memcpy(record, &levels, sizeof(levels));
+
+    uint8_t* spectrum = record + sizeof(levels);
+    for (int bin = 0; bin < m_spectrumBins; bin++) {
+        spectrum[bin] = (bin < static_cast<int>(frame.spectrum.size())) ? quantize8(frame.spectrum[bin]) : 0;
+    }
+    uint8_t* bands = spectrum + m_spectrumBins;
+    for (int band = 0; band < m_numBands; band++) {
+        bands[band] = (band < static_cast<int>(frame.bands.size())) ? quantize8(frame.bands[band]) : 0;
+    }
+    std::fill(bands + m_numBands, record + m_frameBytes, 0);
+}
+
+bool FeatureTrackWriter::write(const std::string& path, const std::vector<uint8_t>& records,
+                               uint64_t firstSampleTime) const
+{
+    if (m_frameBytes == 0 || records.size() % m_frameBytes != 0) {
+        std::cerr << "Feature track records don't match the frame size" << std::endl;
+        return false;
+    }
+    const uint32_t frameCount = static_cast<uint32_t>(records.size() / m_frameBytes);
+
+    FeatureTrackHeader header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.sampleRate = static_cast<uint32_t>(m_sampleRate);
+    header.hopSize = static_cast<uint32_t>(m_hopSize);
+    header.frameCount = frameCount;
+    header.spectrumBins = static_cast<uint32_t>(m_spectrumBins);
+    header.numBands = static_cast<uint32_t>(m_numBands);
+    header.frameBytes = static_cast<uint32_t>(m_frameBytes);
+    header.indexOffset = sizeof(FeatureTrackHeader);
+    header.framesOffset = header.indexOffset + frameCount * sizeof(FeatureTrackIndexEntry);
+
+    std::vector<FeatureTrackIndexEntry> index(frameCount);
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        index[frame].sampleTime = firstSampleTime + static_cast<uint64_t>(frame) * m_hopSize;
+        index[frame].offset = header.framesOffset + static_cast<uint64_t>(frame) * m_frameBytes;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to create feature track " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(FeatureTrackIndexEntry));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size());
+    if (!file) {
+        std::cerr << "Failed to write feature track " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+FeatureTrackReader::FeatureTrackReader()
+    : m_header(nullptr)
+    , m_index(nullptr)
+{
+}
+
+bool FeatureTrackReader::open(const std::string& path)
+{
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = m_file.getData();
+    const size_t size = m_file.getSize();
+    const FeatureTrackHeader* header = reinterpret_cast<const FeatureTrackHeader*>(data);
+    if (size < sizeof(FeatureTrackHeader) || std::memcmp(header->magic, Magic, sizeof(Magic)) != 0) {
+        std::cerr << path << " is not a feature track" << std::endl;
+        m_file.close();
+        return false;
+    }
+    if (header->version != Version) {
+        std::cerr << path << " is feature track version " << header->version << ", expected " << Version
+                  << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    // Everything the index and records point at must be inside the file
+    const uint64_t indexEnd = header->indexOffset + uint64_t(header->frameCount) * sizeof(FeatureTrackIndexEntry);
+    const uint64_t framesEnd = header->framesOffset + uint64_t(header->frameCount) * header->frameBytes;
+    if (header->sampleRate == 0 || header->hopSize == 0 || header->frameCount == 0 ||
+        header->frameBytes < paddedFrameBytes(header->spectrumBins, header->numBands) ||
+        header->indexOffset % alignof(FeatureTrackIndexEntry) != 0 ||
+        indexEnd > size || framesEnd > size) {
+        std::cerr << path << " is truncated or corrupt" << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    m_header = header;
+    m_index = reinterpret_cast<const FeatureTrackIndexEntry*>(data + header->indexOffset);
+    for (uint32_t frame = 0; frame < header->frameCount; frame++) {
+        if (m_index[frame].offset + header->frameBytes > size) {
+            std::cerr << path << " has a frame outside the file" << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    std::cout << "Feature track " << path << ": " << header->frameCount << " frames, "
+              << getDuration() << " s at " << header->sampleRate << " Hz" << std::endl;
+    return true;
+}
+
+void FeatureTrackReader::close()
+{
+    m_file.close();
+    m_header = nullptr;
+    m_index = nullptr;
+}
+
+double FeatureTrackReader::getDuration() const
+{
+    const uint64_t end = m_index[m_header->frameCount - 1].sampleTime + m_header->hopSize;
+    return static_cast<double>(end) / m_header->sampleRate;
+}
+
+int FeatureTrackReader::findFrame(double seconds) const
+{
+    // Last frame that became current at or before this sample
+    const uint64_t sampleTime = static_cast<uint64_t>(std::max(0.0, seconds) * m_header->sampleRate);
+    const FeatureTrackIndexEntry* end = m_index + m_header->frameCount;
+    const FeatureTrackIndexEntry* next = std::upper_bound(m_index, end, sampleTime,
+        [](uint64_t time, const FeatureTrackIndexEntry& entry) { return time < entry.sampleTime; });
+    return static_cast<int>(next - m_index) - 1;
+}
+
+void FeatureTrackReader::decode(int frame, AudioData& data) const
+{
+    const uint8_t* record = m_file.getData() + m_index[frame].offset;
+    FeatureTrackFrame levels;
+    std::memcpy(&levels, record, sizeof(levels));
+
+    const float scale = 1.0f / 65535.0f;
+    data.energy = levels.energy * scale;
+    data.bass = levels.bass * scale;
+    data.mid = levels.mid * scale;
+    data.treble = levels.treble * scale;
+    data.onset = levels.onset * scale;
+    data.transient = data.onset;
+    data.beatPhase = levels.beatPhase * scale;
+    data.bpm = levels.bpm / 100.0f;
+
+    const uint8_t* spectrum = record + sizeof(levels);
+    data.spectrum.resize(m_header->spectrumBins);
+    for (uint32_t bin = 0; bin < m_header->spectrumBins; bin++) {
+        data.spectrum[bin] = spectrum[bin] / 255.0f;
+    }
+    const uint8_t* bands = spectrum + m_header->spectrumBins;
+    data.bands.resize(m_header->numBands);
+    for (uint32_t band = 0; band < m_header->numBands; band++) {
+        data.bands[band] = bands[band] / 255.0f;
+    }
+}
+
+uint8_t FeatureTrackReader::getFlags(int frame) const
+{
+    FeatureTrackFrame levels;
+    std::memcpy(&levels, m_file.getData() + m_index[frame].offset, sizeof(levels));
+    return levels.flags;
+}
+
+} // namespace av
@@ -0,0 +1,133 @@
+#include "audio/Filterbank.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+float hzToMel(float hz) { return 2595.0f * std::log10(1.0f + hz / 700.0f); }
+float melToHz(float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); }
+
+} // namespace
+
+Filterbank::Filterbank()
+    : m_scale(FilterbankScale::Log)
+    , m_numBins(0)
+{
+}
+
+bool Filterbank::initialize(FilterbankScale scale, int numBands, int fftSize, int sampleRate,
+                            float minFrequency, float maxFrequency)
+{
+    std::vector<float> edges;
+    if (!computeEdges(scale, numBands, minFrequency, std::min(maxFrequency, 0.5f * sampleRate), edges)) {
+        return false;
+    }
+
+    m_scale = scale;
+    return initialize(edges, fftSize, sampleRate);
+}
+
+bool Filterbank::computeEdges(FilterbankScale scale, int numBands, float minFrequency, float maxFrequency,
+                              std::vector<float>& edges)
+{
+    if (minFrequency <= 0.0f || maxFrequency <= minFrequency) {
+        std::cerr << "Invalid filterbank range " << minFrequency << "-" << maxFrequency << " Hz" << std::endl;
+        return false;
+    }
+
+    // Band edges: band b spans edges[b]..edges[b+2] with its centre at edges[b+1]
+    edges.clear();
+    if (scale == FilterbankScale::ThirdOctave) {
+        const int firstBand = static_cast<int>(std::ceil(3.0f * std::log2(minFrequency / 1000.0f)));
+        const int lastBand = static_cast<int>(std::floor(3.0f * std::log2(maxFrequency / 1000.0f)));
+        if (lastBand < firstBand) {
+            std::cerr << "No 1/3-octave band fits in " << minFrequency << "-" << maxFrequency << " Hz" << std::endl;
+            return false;
+        }
+        for (int k = firstBand - 1; k <= lastBand + 1; k++) {
+            edges.push_back(1000.0f * std::pow(2.0f, k / 3.0f));
+        }
+    } else {
+        if (numBands < 1) {
+            std::cerr << "Filterbank needs at least one band" << std::endl;
+            return false;
+        }
+        const bool mel = (scale == FilterbankScale::Mel);
+        const float low = mel ? hzToMel(minFrequency) : std::log(minFrequency);
+        const float high = mel ? hzToMel(maxFrequency) : std::log(maxFrequency);
+        for (int i = 0; i < numBands + 2; i++) {
+            const float position = low + (high - low) * i / (numBands + 1);
+            edges.push_back(mel ? melToHz(position) : std::exp(position));
+        }
+    }
+    return true;
+}
+
+bool Filterbank::initialize(const std::vector<float>& edges, int fftSize, int sampleRate)
+{
+    if (fftSize < 2 || edges.size() < 3) {
+        std::cerr << "Filterbank needs an FFT size of at least 2 and at least 3 band edges" << std::endl;
+        return false;
+    }
+
+    m_numBins = fftSize / 2 + 1;
+    const int bandCount = static_cast<int>(edges.size()) - 2;
+    const float binWidth = static_cast<float>(sampleRate) / fftSize;
+
+    m_centerFrequencies.assign(edges.begin() + 1, edges.end() - 1);
+    m_rowOffsets.assign(1, 0);
+    m_firstBin.clear();
+    m_weights.clear();
+
+    for (int band = 0; band < bandCount; band++) {
+        const float low = edges[band];
+        const float center = edges[band + 1];
+        const float high = edges[band + 2];
+
+        const int firstBin = std::max(0, static_cast<int>(std::ceil(low / binWidth)));
+        const int lastBin = std::min(m_numBins - 1, static_cast<int>(std::floor(high / binWidth)));
+
+        const size_t rowStart = m_weights.size();
+        for (int bin = firstBin; bin <= lastBin; bin++) {
+            const float frequency = bin * binWidth;
+            const float weight = (frequency <= center) ? (frequency - low) / (center - low)
+                                                       : (high - frequency) / (high - center);
+            m_weights.push_back(std::max(0.0f, weight));
+        }
+
+        // Bands narrower than a bin (low end of large banks) take the nearest bin
+        float weightSum = 0.0f;
+        for (size_t i = rowStart; i < m_weights.size(); i++) {
+            weightSum += m_weights[i];
+        }
+        if (weightSum <= 0.0f) {
+            m_weights.resize(rowStart);
+            m_weights.push_back(1.0f);
+            m_firstBin.push_back(std::min(m_numBins - 1, static_cast<int>(std::lround(center / binWidth))));
+        } else {
+            for (size_t i = rowStart; i < m_weights.size(); i++) {
+                m_weights[i] /= weightSum;
+            }
+            m_firstBin.push_back(firstBin);
+        }
+        m_rowOffsets.push_back(static_cast<int>(m_weights.size()));
+    }
+
+    return true;
+}
+
+void Filterbank::apply(const float* spectrum, float* bands) const
+{
+    const int numBands = getNumBands();
+    const float* weights = m_weights.data();
+    for (int band = 0; band < numBands; band++) {
+        const int offset = m_rowOffsets[band];
+        bands[band] = dotProduct(weights + offset, spectrum + m_firstBin[band], m_rowOffsets[band + 1] - offset);
+    }
+}
+
+} // namespace av
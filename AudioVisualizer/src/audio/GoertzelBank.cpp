@@ -0,0 +1,118 @@
+#include "audio/GoertzelBank.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// A probe may use a decimated stream while its band stays below this fraction
+// of the stream's Nyquist frequency (clear of the decimation filter's transition)
+const float UsableBandwidth = 0.8f;
+
+// Shortest useful window
+const size_t MinWindowSize = 16;
+
+} // namespace
+
+GoertzelBank::GoertzelBank()
+    : m_sampleRate(0)
+    , m_maxWindowSeconds(0.0f)
+{
+}
+
+bool GoertzelBank::initialize(DecimationChain& chain, float maxWindowSeconds)
+{
+    m_sampleRate = chain.getSampleRate();
+    if (m_sampleRate <= 0 || maxWindowSeconds <= 0.0f) {
+        std::cerr << "Goertzel probes need an initialized decimation chain and a window length" << std::endl;
+        return false;
+    }
+    m_maxWindowSeconds = maxWindowSeconds;
+    m_probes.clear();
+
+    // One window per stream, subscribed once the vector has stopped moving
+    m_streams.assign(chain.getNumStages() + 1, SlidingWindow());
+    for (size_t stream = 0; stream < m_streams.size(); stream++) {
+        const int rate = m_sampleRate >> stream;
+        m_streams[stream].initialize(std::max(MinWindowSize, static_cast<size_t>(maxWindowSeconds * rate)));
+
+        SlidingWindow* target = &m_streams[stream];
+        chain.subscribe(1 << stream, [target](const float* samples, size_t count) { target->push(samples, count); });
+    }
+    return true;
+}
+
+int GoertzelBank::addProbe(float frequency, float bandwidth)
+{
+    if (m_streams.empty() || frequency <= 0.0f || frequency >= 0.5f * m_sampleRate || bandwidth <= 0.0f) {
+        std::cerr << "Invalid probe: " << frequency << " Hz, " << bandwidth << " Hz wide" << std::endl;
+        return -1;
+    }
+
+    // Coarsest stream that still holds the whole band
+    int stream = 0;
+    while (stream + 1 < static_cast<int>(m_streams.size()) &&
+           frequency + bandwidth < UsableBandwidth * 0.5f * (m_sampleRate >> (stream + 1))) {
+        stream++;
+    }
+    const float rate = static_cast<float>(m_sampleRate >> stream);
+
+    // The Hann main lobe is 2 bins wide at -6 dB
+    size_t size = static_cast<size_t>(std::ceil(2.0f * rate / bandwidth));
+    if (size > m_streams[stream].size()) {
+        std::cerr << "Probe at " << frequency << " Hz limited to " << (2.0f * rate / m_streams[stream].size())
+                  << " Hz bandwidth by the " << m_maxWindowSeconds << " s window" << std::endl;
+        size = m_streams[stream].size();
+    }
+    size = std::max(size, MinWindowSize);
+
+    Probe probe;
+    probe.stream = stream;
+    probe.coefficient = static_cast<float>(2.0 * std::cos(2.0 * Pi * frequency / rate));
+    probe.window.resize(size);
+    double windowSum = 0.0;
+    for (size_t n = 0; n < size; n++) {
+        probe.window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * Pi * n / size));
+        windowSum += probe.window[n];
+    }
+    probe.scale = static_cast<float>(2.0 / windowSum);
+    probe.magnitude = 0.0f;
+
+    m_probes.push_back(std::move(probe));
+    return static_cast<int>(m_probes.size()) - 1;
+}
+
+void GoertzelBank::clearProbes()
+{
+    m_probes.clear();
+}
+
+void GoertzelBank::update()
+{
+    for (Probe& probe : m_probes) {
+        const SlidingWindow& stream = m_streams[probe.stream];
+        const size_t size = probe.window.size();
+        const float* samples = stream.data() + (stream.size() - size);
+        const float* window = probe.window.data();
+        const float coefficient = probe.coefficient;
+
+        // s[n] = x[n] + 2cos(w) s[n-1] - s[n-2]
+        float s1 = 0.0f;
+        float s2 = 0.0f;
+        for (size_t n = 0; n < size; n++) {
+            const float s0 = samples[n] * window[n] + coefficient * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+
+        // |X|^2 = s1^2 + s2^2 - 2cos(w) s1 s2
+        const float power = std::max(0.0f, s1 * s1 + s2 * s2 - coefficient * s1 * s2);
+        probe.magnitude = std::sqrt(power) * probe.scale;
+    }
+}
+
+} // namespace av
@@ -0,0 +1,158 @@
+#include "audio/HalfBandDecimator.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+} // namespace
+
+HalfBandDecimator::HalfBandDecimator()
+    : m_numTaps(0)
+    , m_halfLength(0)
+    , m_maxBlockSize(0)
+    , m_centreTap(0.0f)
+    , m_nextIsOdd(false)
+{
+}
+
+bool HalfBandDecimator::initialize(int taps, size_t maxBlockSize)
+{
+    if (taps < 3 || maxBlockSize < 2) {
+        std::cerr << "Half-band decimator needs at least 3 taps and a block size of 2, got "
+                  << taps << " and " << maxBlockSize << std::endl;
+        return false;
+    }
+
+    // Lengths of 4K+3 put non-zero taps at both ends of the filter
+    m_numTaps = std::max(7, (taps / 4) * 4 + 3);
+    m_halfLength = (m_numTaps - 3) / 4;
+    m_maxBlockSize = maxBlockSize;
+    const int centre = (m_numTaps - 1) / 2;
+
+    // Windowed sinc with its cutoff at a quarter of the input rate. The Blackman
+    // window spans numTaps + 1 points so the outermost taps are not zero.
+    // odd[i] is the tap at distance 2i+1 from the centre.
+    std::vector<double> odd(m_halfLength + 1);
+    double sum = 0.5;
+    for (size_t i = 0; i < odd.size(); i++) {
+        const int offset = 2 * static_cast<int>(i) + 1;
+        const double sinc = std::sin(Pi * offset / 2.0) / (Pi * offset);
+        const double phase = 2.0 * Pi * (centre + offset + 1) / (m_numTaps + 1);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        odd[i] = sinc * window;
+        sum += 2.0 * odd[i];
+    }
+
+    // Unity gain at DC. Even-branch tap t sits at distance 2(K-t)+1 from the centre.
+    m_evenTaps.resize(m_halfLength + 1);
+    for (int t = 0; t <= m_halfLength; t++) {
+        m_evenTaps[t] = static_cast<float>(odd[m_halfLength - t] / sum);
+    }
+    m_centreTap = static_cast<float>(0.5 / sum);
+
+    const size_t branchBlock = (maxBlockSize + 1) / 2;
+    m_even.assign(2 * m_halfLength + 1 + branchBlock, 0.0f);
+    m_odd.assign(m_halfLength + 1 + branchBlock, 0.0f);
+
+    reset();
+    return true;
+}
+
+void HalfBandDecimator::reset()
+{
+    std::fill(m_even.begin(), m_even.end(), 0.0f);
+    std::fill(m_odd.begin(), m_odd.end(), 0.0f);
+    m_nextIsOdd = false;
+}
+
+size_t HalfBandDecimator::process(const float* input, size_t count, float* output)
+{
+    if (m_numTaps == 0) {
+        return 0;
+    }
+
+    size_t written = 0;
+    while (count > 0) {
+        const size_t block = std::min(count, m_maxBlockSize);
+        written += processBlock(input, block, output + written);
+        input += block;
+        count -= block;
+    }
+    return written;
+}
+
+size_t HalfBandDecimator::processBlock(const float* input, size_t count, float* output)
+{
+    const int K = m_halfLength;
+    const size_t evenHistory = static_cast<size_t>(2 * K + 1);
+    const size_t oddHistory = static_cast<size_t>(K + 1);
+
+    // Split the block into its polyphase branches behind their histories
+    float* even = m_even.data();
+    float* odd = m_odd.data();
+    const size_t lead = m_nextIsOdd ? 1 : 0;    // Evens seen minus odds seen before this block
+    float* evenOut = even + evenHistory;
+    float* oddOut = odd + oddHistory;
+    size_t n = 0;
+    if (lead) {
+        *oddOut++ = input[n++];
+    }
+#ifdef AV_SIMD_SSE2
+    for (; n + 8 <= count; n += 8) {
+        const __m128 a = _mm_loadu_ps(input + n);
+        const __m128 b = _mm_loadu_ps(input + n + 4);
+        _mm_storeu_ps(evenOut, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(oddOut, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        evenOut += 4;
+        oddOut += 4;
+    }
+#endif
+    for (; n + 2 <= count; n += 2) {
+        *evenOut++ = input[n];
+        *oddOut++ = input[n + 1];
+    }
+    if (n < count) {
+        *evenOut++ = input[n];
+    }
+    const size_t numEven = static_cast<size_t>(evenOut - (even + evenHistory));
+    const size_t numOdd = static_cast<size_t>(oddOut - (odd + oddHistory));
+
+    // y[m] = centre * odd[m-K-1] + sum_t g[t] * (even[m-t] + even[m-2K-1+t]);
+    // indices are relative to the start of each buffer
+    const float* taps = m_evenTaps.data();
+    const float* centre = odd + lead;
+    size_t j = 0;
+#ifdef AV_SIMD_SSE2
+    const __m128 centreTap = _mm_set1_ps(m_centreTap);
+    for (; j + 4 <= numEven; j += 4) {
+        __m128 acc = _mm_mul_ps(centreTap, _mm_loadu_ps(centre + j));
+        for (int t = 0; t <= K; t++) {
+            const __m128 pair = _mm_add_ps(_mm_loadu_ps(even + evenHistory + j - t),
+                                           _mm_loadu_ps(even + j + t));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps[t]), pair));
+        }
+        _mm_storeu_ps(output + j, acc);
+    }
+#endif
+    for (; j < numEven; j++) {
+        float acc = m_centreTap * centre[j];
+        for (int t = 0; t <= K; t++) {
+            acc += taps[t] * (even[evenHistory + j - t] + even[j + t]);
+        }
+        output[j] = acc;
+    }
+
+    // Keep the branch histories for the next block
+    std::copy(even + numEven, even + numEven + evenHistory, even);
+    std::copy(odd + numOdd, odd + numOdd + oddHistory, odd);
+    m_nextIsOdd = (m_nextIsOdd != ((count & 1) != 0));
+    return numEven;
+}
+
+} // namespace av
@@ -0,0 +1,109 @@
+#include "audio/KeyEstimator.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Krumhansl-Kessler probe-tone ratings, tonic first
+const float MajorProfile[KeyEstimator::NumPitchClasses] = {
+    6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f
+};
+const float MinorProfile[KeyEstimator::NumPitchClasses] = {
+    6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f
+};
+
+// Averaged chroma with less spread than this (silence, or all classes equal) names no key
+const float MinimumSpread = 1e-4f;
+
+} // namespace
+
+KeyEstimator::KeyEstimator()
+    : m_decay(0.0f)
+    , m_key(-1)
+    , m_minor(false)
+    , m_confidence(0.0f)
+{
+    std::fill(&m_profiles[0][0], &m_profiles[0][0] + 2 * NumPitchClasses * NumPitchClasses, 0.0f);
+    std::fill(m_average, m_average + NumPitchClasses, 0.0f);
+}
+
+bool KeyEstimator::initialize(float frameRate, float memorySeconds)
+{
+    if (frameRate <= 0.0f || memorySeconds <= 0.0f) {
+        std::cerr << "Key estimator needs a positive frame rate and memory" << std::endl;
+        return false;
+    }
+    m_decay = std::exp(-1.0f / (memorySeconds * frameRate));
+
+    // Rotate each profile to every tonic, then centre and normalize it
+    for (int mode = 0; mode < 2; mode++) {
+        const float* profile = (mode == 0) ? MajorProfile : MinorProfile;
+        float mean = 0.0f;
+        for (int i = 0; i < NumPitchClasses; i++) {
+            mean += profile[i] / NumPitchClasses;
+        }
+        float norm = 0.0f;
+        for (int i = 0; i < NumPitchClasses; i++) {
+            norm += (profile[i] - mean) * (profile[i] - mean);
+        }
+        norm = std::sqrt(norm);
+
+        for (int tonic = 0; tonic < NumPitchClasses; tonic++) {
+            float* row = m_profiles[mode * NumPitchClasses + tonic];
+            for (int pitchClass = 0; pitchClass < NumPitchClasses; pitchClass++) {
+                row[pitchClass] = (profile[(pitchClass - tonic + NumPitchClasses) % NumPitchClasses] - mean) / norm;
+            }
+        }
+    }
+
+    reset();
+    return true;
+}
+
+void KeyEstimator::reset()
+{
+    std::fill(m_average, m_average + NumPitchClasses, 0.0f);
+    m_key = -1;
+    m_minor = false;
+    m_confidence = 0.0f;
+}
+
+void KeyEstimator::process(const float* chroma)
+{
+    // Exponential average, and its spread around its own mean
+    float mean = 0.0f;
+    for (int i = 0; i < NumPitchClasses; i++) {
+        m_average[i] = m_decay * m_average[i] + (1.0f - m_decay) * chroma[i];
+        mean += m_average[i];
+    }
+    mean /= NumPitchClasses;
+    float spread = 0.0f;
+    for (int i = 0; i < NumPitchClasses; i++) {
+        spread += (m_average[i] - mean) * (m_average[i] - mean);
+    }
+    spread = std::sqrt(spread);
+    if (spread < MinimumSpread) {
+        return;
+    }
+
+    // Profiles are zero-mean, so the dot product with the raw average is the centred one
+    int best = 0;
+    float bestCorrelation = -1.0f;
+    for (int row = 0; row < 2 * NumPitchClasses; row++) {
+        const float correlation = dotProduct(m_average, m_profiles[row], NumPitchClasses);
+        if (correlation > bestCorrelation) {
+            bestCorrelation = correlation;
+            best = row;
+        }
+    }
+
+    m_key = best % NumPitchClasses;
+    m_minor = best >= NumPitchClasses;
+    m_confidence = std::max(0.0f, std::min(1.0f, bestCorrelation / spread));
+}
+
+} // namespace av
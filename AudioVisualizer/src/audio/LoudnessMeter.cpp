@@ -0,0 +1,213 @@
+#include "audio/LoudnessMeter.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// Keeps filter state out of the denormal range while the input is silent
+const double DenormalGuard = 1e-25;
+
+// Integrated loudness gates out blocks this far below the average of the louder ones
+const double RelativeGate = -10.0;
+
+// Histogram resolution in LU
+const double BinsPerLU = 10.0;
+
+// BS.1770 loudness of a mean square
+double toLoudness(double meanSquare)
+{
+    return -0.691 + 10.0 * std::log10(meanSquare);
+}
+
+float reportedLoudness(double meanSquare)
+{
+    if (meanSquare <= 0.0) {
+        return LoudnessMeter::SilenceLoudness;
+    }
+    return static_cast<float>(std::max<double>(LoudnessMeter::SilenceLoudness, toLoudness(meanSquare)));
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter()
+    : m_sampleRate(0)
+    , m_channels(0)
+    , m_subBlockSize(0)
+    , m_subBlockEnergy(0.0)
+    , m_subBlockPosition(0)
+    , m_subBlockIndex(0)
+    , m_subBlocksSeen(0)
+    , m_momentarySum(0.0)
+    , m_shortTermSum(0.0)
+    , m_gatedBlocks(0)
+    , m_gatedEnergy(0.0)
+    , m_momentary(SilenceLoudness)
+    , m_shortTerm(SilenceLoudness)
+    , m_integrated(SilenceLoudness)
+{
+    std::fill(&m_coefficients[0][0], &m_coefficients[0][0] + 10, 0.0);
+}
+
+bool LoudnessMeter::initialize(int sampleRate, int channels)
+{
+    if (sampleRate < 8000 || channels < 1) {
+        std::cerr << "Loudness meter needs a sample rate of at least 8 kHz and at least one channel" << std::endl;
+        return false;
+    }
+
+    // K-weighting from the BS.1770 analog prototypes, so any sample rate
+    // matches the 48 kHz coefficients in the standard
+    const double shelfFrequency = 1681.974450955533;
+    const double shelfGain = 3.999843853973347;
+    const double shelfQ = 0.7071752369554196;
+    double k = std::tan(Pi * shelfFrequency / sampleRate);
+    const double vh = std::pow(10.0, shelfGain / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / shelfQ + k * k;
+    m_coefficients[0][0] = (vh + vb * k / shelfQ + k * k) / a0;
+    m_coefficients[0][1] = 2.0 * (k * k - vh) / a0;
+    m_coefficients[0][2] = (vh - vb * k / shelfQ + k * k) / a0;
+    m_coefficients[0][3] = 2.0 * (k * k - 1.0) / a0;
+    m_coefficients[0][4] = (1.0 - k / shelfQ + k * k) / a0;
+
+    const double highpassFrequency = 38.13547087602444;
+    const double highpassQ = 0.5003270373238773;
+    k = std::tan(Pi * highpassFrequency / sampleRate);
+    a0 = 1.0 + k / highpassQ + k * k;
+    m_coefficients[1][0] = 1.0;
+    m_coefficients[1][1] = -2.0;
+    m_coefficients[1][2] = 1.0;
+    m_coefficients[1][3] = 2.0 * (k * k - 1.0) / a0;
+    m_coefficients[1][4] = (1.0 - k / highpassQ + k * k) / a0;
+
+    m_sampleRate = sampleRate;
+    m_channels = channels;
+    m_state.assign(4 * channels, 0.0);
+    m_subBlockSize = (sampleRate + SubBlocksPerSecond / 2) / SubBlocksPerSecond;
+    m_subBlocks.assign(ShortTermSubBlocks, 0.0);
+    m_histogramCounts.assign(HistogramBins, 0);
+    m_histogramEnergy.assign(HistogramBins, 0.0);
+
+    reset();
+    return true;
+}
+
+void LoudnessMeter::reset()
+{
+    std::fill(m_state.begin(), m_state.end(), 0.0);
+    m_subBlockEnergy = 0.0;
+    m_subBlockPosition = 0;
+    std::fill(m_subBlocks.begin(), m_subBlocks.end(), 0.0);
+    m_subBlockIndex = 0;
+    m_subBlocksSeen = 0;
+    m_momentarySum = 0.0;
+    m_shortTermSum = 0.0;
+    std::fill(m_histogramCounts.begin(), m_histogramCounts.end(), 0);
+    std::fill(m_histogramEnergy.begin(), m_histogramEnergy.end(), 0.0);
+    m_gatedBlocks = 0;
+    m_gatedEnergy = 0.0;
+    m_momentary = SilenceLoudness;
+    m_shortTerm = SilenceLoudness;
+    m_integrated = SilenceLoudness;
+}
+
+void LoudnessMeter::process(const float* frames, size_t count)
+{
+    const double* shelf = m_coefficients[0];
+    const double* highpass = m_coefficients[1];
+    const int channels = m_channels;
+    double energy = m_subBlockEnergy;
+    int position = m_subBlockPosition;
+
+    for (size_t i = 0; i < count; i++) {
+        const float* frame = frames + i * channels;
+        for (int channel = 0; channel < channels; channel++) {
+            // Both sections in transposed direct form II: shelf z1, z2, then highpass z1, z2
+            double* state = m_state.data() + 4 * channel;
+            const double x = frame[channel] + DenormalGuard;
+            const double shelved = shelf[0] * x + state[0];
+            state[0] = shelf[1] * x - shelf[3] * shelved + state[1];
+            state[1] = shelf[2] * x - shelf[4] * shelved;
+
+            const double weighted = highpass[0] * shelved + state[2];
+            state[2] = highpass[1] * shelved - highpass[3] * weighted + state[3];
+            state[3] = highpass[2] * shelved - highpass[4] * weighted;
+
+            energy += weighted * weighted;
+        }
+        if (++position == m_subBlockSize) {
+            m_subBlockEnergy = energy;
+            finishSubBlock();
+            energy = 0.0;
+            position = 0;
+        }
+    }
+
+    m_subBlockEnergy = energy;
+    m_subBlockPosition = position;
+}
+
+void LoudnessMeter::finishSubBlock()
+{
+    const double meanSquare = m_subBlockEnergy / m_subBlockSize;
+
+    // Slide both windows by one sub-block: add the new one, drop the one leaving
+    const int momentaryLeaving = (m_subBlockIndex + ShortTermSubBlocks - MomentarySubBlocks) % ShortTermSubBlocks;
+    m_momentarySum += meanSquare - m_subBlocks[momentaryLeaving];
+    m_shortTermSum += meanSquare - m_subBlocks[m_subBlockIndex];
+    m_subBlocks[m_subBlockIndex] = meanSquare;
+    m_subBlockIndex = (m_subBlockIndex + 1) % ShortTermSubBlocks;
+    m_subBlocksSeen++;
+
+    // Rounding can leave a tiny negative sum once the window is silent
+    m_momentarySum = std::max(0.0, m_momentarySum);
+    m_shortTermSum = std::max(0.0, m_shortTermSum);
+
+    // Windows are reported only once they are full
+    if (m_subBlocksSeen >= MomentarySubBlocks) {
+        m_momentary = reportedLoudness(m_momentarySum / MomentarySubBlocks);
+
+        if (m_subBlocksSeen % GatingStepSubBlocks == 0) {
+            const double blockMeanSquare = m_momentarySum / MomentarySubBlocks;
+            if (blockMeanSquare > 0.0) {
+                const double loudness = toLoudness(blockMeanSquare);
+                if (loudness >= SilenceLoudness) {
+                    const int bin = std::min(HistogramBins - 1,
+                        static_cast<int>((loudness - SilenceLoudness) * BinsPerLU));
+                    m_histogramCounts[bin]++;
+                    m_histogramEnergy[bin] += blockMeanSquare;
+                    m_gatedBlocks++;
+                    m_gatedEnergy += blockMeanSquare;
+                    updateIntegrated();
+                }
+            }
+        }
+    }
+    if (m_subBlocksSeen >= ShortTermSubBlocks) {
+        m_shortTerm = reportedLoudness(m_shortTermSum / ShortTermSubBlocks);
+    }
+}
+
+void LoudnessMeter::updateIntegrated()
+{
+    // Relative gate from the blocks above the absolute gate
+    const double gate = toLoudness(m_gatedEnergy / m_gatedBlocks) + RelativeGate;
+    const int firstBin = std::max(0, static_cast<int>(std::ceil((gate - SilenceLoudness) * BinsPerLU)));
+
+    int64_t count = 0;
+    double energy = 0.0;
+    for (int bin = firstBin; bin < HistogramBins; bin++) {
+        count += m_histogramCounts[bin];
+        energy += m_histogramEnergy[bin];
+    }
+    if (count > 0) {
+        m_integrated = reportedLoudness(energy / count);
+    }
+}
+
+} // namespace av
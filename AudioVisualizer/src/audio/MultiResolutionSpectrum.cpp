@@ -0,0 +1,154 @@
+#include "audio/MultiResolutionSpectrum.h"
+#include "audio/FFTPlan.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Highest band edge a tier may measure, as a fraction of its Nyquist frequency
+// (leaves room for the transition band of the decimation filters)
+const float UsableBandwidth = 0.8f;
+
+} // namespace
+
+MultiResolutionSpectrum::MultiResolutionSpectrum()
+{
+}
+
+std::vector<ResolutionTier> MultiResolutionSpectrum::getDefaultTiers()
+{
+    return {
+        { 8, 1024, 250.0f },    // ~5.4 Hz bins at 44.1 kHz, like an 8192-point transform
+        { 4, 512, 2000.0f },    // ~21.5 Hz bins, like 2048 points
+        { 1, 512, 0.0f },       // ~86 Hz bins over ~11.6 ms
+    };
+}
+
+bool MultiResolutionSpectrum::initialize(DecimationChain& chain, FilterbankScale scale, int numBands,
+                                         float minFrequency, float maxFrequency,
+                                         const std::vector<ResolutionTier>& tiers)
+{
+    m_tiers.clear();
+    m_centerFrequencies.clear();
+
+    const int sampleRate = chain.getSampleRate();
+    if (sampleRate <= 0 || tiers.empty()) {
+        std::cerr << "Multi-resolution spectrum needs a sample rate and at least one tier" << std::endl;
+        return false;
+    }
+
+    std::vector<float> edges;
+    if (!Filterbank::computeEdges(scale, numBands, minFrequency, std::min(maxFrequency, 0.5f * sampleRate),
+                                  edges)) {
+        return false;
+    }
+    const int bandCount = static_cast<int>(edges.size()) - 2;
+    m_centerFrequencies.assign(edges.begin() + 1, edges.end() - 1);
+    m_bandBins.assign(bandCount, 1.0f);
+
+    int band = 0;
+    for (size_t t = 0; t < tiers.size(); t++) {
+        const ResolutionTier& config = tiers[t];
+        if (config.decimation < 1 || !FFTPlan::isPowerOfTwo(config.decimation) ||
+            config.fftSize < 2 || !FFTPlan::isPowerOfTwo(config.fftSize)) {
+            std::cerr << "Resolution tier " << t << " needs power-of-2 decimation and FFT size" << std::endl;
+            return false;
+        }
+        if (config.decimation > chain.getMaxDecimation()) {
+            std::cerr << "Resolution tier " << t << " needs 1/" << config.decimation
+                      << " rate but the decimation chain stops at 1/" << chain.getMaxDecimation() << std::endl;
+            return false;
+        }
+
+        // This tier's share of the bands
+        const bool last = (t + 1 == tiers.size());
+        const int firstBand = band;
+        while (band < bandCount && (last || m_centerFrequencies[band] < config.maxFrequency)) {
+            band++;
+        }
+        if (band == firstBand) {
+            continue;
+        }
+
+        Tier tier;
+        tier.config = config;
+        tier.firstBand = firstBand;
+        tier.window.initialize(config.fftSize);
+
+        const int tierRate = sampleRate / config.decimation;
+        const float highestEdge = edges[band + 1];
+        if (config.decimation > 1 && highestEdge > UsableBandwidth * 0.5f * tierRate) {
+            std::cerr << "Resolution tier " << t << " (" << tierRate << " Hz) cannot measure bands up to "
+                      << highestEdge << " Hz" << std::endl;
+            return false;
+        }
+
+        const std::vector<float> tierEdges(edges.begin() + firstBand, edges.begin() + band + 2);
+        if (!tier.fft.initialize(config.fftSize) ||
+            !tier.filterbank.initialize(tierEdges, config.fftSize, tierRate)) {
+            return false;
+        }
+
+        // Power scaled so a full-scale sine sums to 1 over its main lobe
+        const std::vector<float>& window = tier.fft.getWindow();
+        float windowPower = 0.0f;
+        for (float w : window) {
+            windowPower += w * w;
+        }
+        const float windowSum = tier.fft.getWindowSum();
+        const float noiseBandwidthBins = config.fftSize * windowPower / (windowSum * windowSum);
+        tier.powerScale = 4.0f / (windowSum * windowSum * noiseBandwidthBins);
+        tier.power.assign(tier.fft.getNumBins(), 0.0f);
+
+        // Filterbank rows average the bins under a band; scaling by the number
+        // of bins under the triangle turns that back into the band's total power
+        const float binWidth = static_cast<float>(tierRate) / config.fftSize;
+        for (int b = firstBand; b < band; b++) {
+            m_bandBins[b] = std::max(1.0f, 0.5f * (edges[b + 2] - edges[b]) / binWidth);
+        }
+        m_tiers.push_back(std::move(tier));
+    }
+
+    // Subscribe once the tiers have stopped moving
+    for (Tier& tier : m_tiers) {
+        Tier* target = &tier;
+        chain.subscribe(tier.config.decimation,
+                        [target](const float* samples, size_t count) { target->window.push(samples, count); });
+    }
+    return true;
+}
+
+void MultiResolutionSpectrum::reset()
+{
+    for (Tier& tier : m_tiers) {
+        tier.window.reset();
+    }
+}
+
+void MultiResolutionSpectrum::computeBands(float* bands)
+{
+    for (Tier& tier : m_tiers) {
+        // Oldest sample first
+        tier.fft.forward(tier.window.data());
+
+        const float* re = tier.fft.getReal();
+        const float* im = tier.fft.getImag();
+        float* power = tier.power.data();
+        const int numBins = tier.fft.getNumBins();
+        for (int k = 0; k < numBins; k++) {
+            power[k] = (re[k] * re[k] + im[k] * im[k]) * tier.powerScale;
+        }
+        tier.filterbank.apply(power, bands + tier.firstBand);
+    }
+
+    // Total power under each band back to an amplitude
+    const int numBands = getNumBands();
+    for (int b = 0; b < numBands; b++) {
+        bands[b] = std::sqrt(bands[b] * m_bandBins[b]);
+    }
+}
+
+} // namespace av
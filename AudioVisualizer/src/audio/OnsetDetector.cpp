@@ -0,0 +1,125 @@
+#include "audio/OnsetDetector.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Log compression: log(1 + gamma * magnitude)
+const float CompressionGamma = 100.0f;
+
+// Threshold = median * multiplier + peak * offset
+const float MedianMultiplier = 1.5f;
+const float PeakOffset = 0.05f;
+
+// Time constants in seconds
+const float MedianWindowSeconds = 0.1f;
+const float MinOnsetSpacingSeconds = 0.05f;
+const float PeakHalfLifeSeconds = 5.0f;
+const float StrengthHalfLifeSeconds = 0.05f;
+
+} // namespace
+
+OnsetDetector::OnsetDetector()
+    : m_numBands(0)
+    , m_historyPosition(0)
+    , m_historyCount(0)
+    , m_flux(0.0f)
+    , m_previousFlux(0.0f)
+    , m_previousPreviousFlux(0.0f)
+    , m_threshold(0.0f)
+    , m_fluxPeak(0.0f)
+    , m_peakDecay(1.0f)
+    , m_framesSinceOnset(0)
+    , m_minOnsetFrames(1)
+    , m_strength(0.0f)
+    , m_strengthDecay(0.0f)
+{
+}
+
+bool OnsetDetector::initialize(int numBands, float frameRate)
+{
+    if (numBands < 1 || frameRate <= 0.0f) {
+        std::cerr << "Onset detector needs bands and a positive frame rate" << std::endl;
+        return false;
+    }
+
+    m_numBands = numBands;
+    m_previousLog.assign(numBands, 0.0f);
+    m_currentLog.assign(numBands, 0.0f);
+
+    // Odd window so the median is a single element
+    const int medianFrames = std::max(3, static_cast<int>(MedianWindowSeconds * frameRate) | 1);
+    m_fluxHistory.assign(medianFrames, 0.0f);
+    m_medianScratch.assign(medianFrames, 0.0f);
+
+    m_minOnsetFrames = std::max(1, static_cast<int>(MinOnsetSpacingSeconds * frameRate));
+    m_peakDecay = std::pow(0.5f, 1.0f / (PeakHalfLifeSeconds * frameRate));
+    m_strengthDecay = std::pow(0.5f, 1.0f / (StrengthHalfLifeSeconds * frameRate));
+
+    reset();
+    return true;
+}
+
+void OnsetDetector::reset()
+{
+    std::fill(m_previousLog.begin(), m_previousLog.end(), 0.0f);
+    std::fill(m_fluxHistory.begin(), m_fluxHistory.end(), 0.0f);
+    m_historyPosition = 0;
+    m_historyCount = 0;
+    m_flux = 0.0f;
+    m_previousFlux = 0.0f;
+    m_previousPreviousFlux = 0.0f;
+    m_threshold = 0.0f;
+    m_fluxPeak = 0.0f;
+    m_framesSinceOnset = m_minOnsetFrames;
+    m_strength = 0.0f;
+}
+
+bool OnsetDetector::process(const float* bandMagnitudes)
+{
+    // Half-wave rectified difference of log-compressed bands
+    float flux = 0.0f;
+    for (int band = 0; band < m_numBands; band++) {
+        const float compressed = std::log1p(CompressionGamma * bandMagnitudes[band]);
+        flux += std::max(0.0f, compressed - m_previousLog[band]);
+        m_currentLog[band] = compressed;
+    }
+    m_currentLog.swap(m_previousLog);
+    flux /= m_numBands;
+
+    // Adaptive threshold from the median of recent flux (allocation-free partial sort)
+    m_fluxHistory[m_historyPosition] = flux;
+    m_historyPosition = (m_historyPosition + 1) % static_cast<int>(m_fluxHistory.size());
+    m_historyCount = std::min(m_historyCount + 1, static_cast<int>(m_fluxHistory.size()));
+
+    std::copy(m_fluxHistory.begin(), m_fluxHistory.begin() + m_historyCount, m_medianScratch.begin());
+    std::vector<float>::iterator middle = m_medianScratch.begin() + m_historyCount / 2;
+    std::nth_element(m_medianScratch.begin(), middle, m_medianScratch.begin() + m_historyCount);
+
+    m_fluxPeak = std::max(flux, m_fluxPeak * m_peakDecay);
+    m_threshold = *middle * MedianMultiplier + m_fluxPeak * PeakOffset;
+
+    // Confirm the previous frame as an onset if it was a local peak above the threshold
+    m_framesSinceOnset++;
+    const bool onset = m_previousFlux > m_threshold &&
+                       m_previousFlux >= m_previousPreviousFlux &&
+                       m_previousFlux > flux &&
+                       m_framesSinceOnset >= m_minOnsetFrames;
+
+    m_strength *= m_strengthDecay;
+    if (onset) {
+        m_framesSinceOnset = 0;
+        const float strength = (m_fluxPeak > 0.0f) ? std::min(1.0f, m_previousFlux / m_fluxPeak) : 0.0f;
+        m_strength = std::max(m_strength, strength);
+    }
+
+    m_previousPreviousFlux = m_previousFlux;
+    m_previousFlux = flux;
+    m_flux = flux;
+    return onset;
+}
+
+} // namespace av
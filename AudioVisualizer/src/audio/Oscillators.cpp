@@ -0,0 +1,65 @@
+#include "audio/Oscillators.h"
+#include <cmath>
+
+namespace av {
+
+namespace {
+
+const int SineTableSize = 2048;
+
+// One cycle of sine and a guard entry, built on first use
+const float* getSineTable()
+{
+    static const struct SineTable {
+        float values[SineTableSize + 1];
+        SineTable()
+        {
+            for (int i = 0; i <= SineTableSize; i++) {
+                values[i] = static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * i / SineTableSize));
+            }
+        }
+    } table;
+    return table.values;
+}
+
+} // namespace
+
+WavetableOscillator::WavetableOscillator()
+    : m_table(getSineTable())
+    , m_phase(0)
+    , m_increment(0)
+    , m_increment64(0.0)
+{
+    static_assert((1 << TableBits) == SineTableSize, "oscillator index bits must match the table");
+}
+
+void WavetableOscillator::setFrequency(double frequencyHz, int sampleRate)
+{
+    m_increment64 = frequencyHz / sampleRate * 4294967296.0;
+    m_increment = static_cast<uint32_t>(static_cast<int64_t>(m_increment64 + 0.5));
+}
+
+void WavetableOscillator::scaleFrequency(double factor)
+{
+    m_increment64 *= factor;
+    m_increment = static_cast<uint32_t>(static_cast<int64_t>(m_increment64 + 0.5));
+}
+
+NoiseGenerator::NoiseGenerator(uint32_t seed)
+{
+    this->seed(seed);
+}
+
+void NoiseGenerator::seed(uint32_t seed)
+{
+    // Spread small seeds over the state; xorshift must never start at zero
+    m_state = seed * 2654435761u;
+    if (m_state == 0) {
+        m_state = 0x9E3779B9u;
+    }
+    m_pink0 = 0.0f;
+    m_pink1 = 0.0f;
+    m_pink2 = 0.0f;
+}
+
+} // namespace av
@@ -0,0 +1,187 @@
+#include "audio/PcmStreamSource.h"
+#include "audio/RingBuffer.h"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace av {
+
+namespace {
+
+// Bytes requested from the stream per read
+const size_t ReadBufferBytes = 16384;
+
+} // namespace
+
+PcmStreamSource::PcmStreamSource(const std::string& path, int sampleRate, int channels, SampleFormat format)
+    : m_path(path)
+    , m_sampleRate(sampleRate)
+    , m_channels(channels)
+    , m_format(format)
+    , m_fd(-1)
+    , m_isStdin(path == "-")
+    , m_running(false)
+{
+}
+
+PcmStreamSource::~PcmStreamSource()
+{
+    stop();
+#ifdef _WIN32
+    if (m_fd >= 0 && !m_isStdin) {
+        _close(m_fd);
+    }
+#else
+    if (m_fd >= 0 && !m_isStdin) {
+        close(m_fd);
+    }
+#endif
+}
+
+std::string PcmStreamSource::getName() const
+{
+    return std::string("raw PCM from ") + (m_isStdin ? "stdin" : m_path);
+}
+
+bool PcmStreamSource::initialize(int /*sampleRate*/)
+{
+    // The stream's rate is fixed by the configuration; the preferred rate is ignored
+    if (m_sampleRate <= 0 || m_channels <= 0 || m_channels > MaxSampleChannels) {
+        std::cerr << "Raw PCM needs a positive sample rate and 1 to " << MaxSampleChannels << " channels"
+                  << std::endl;
+        return false;
+    }
+
+#ifdef _WIN32
+    if (m_isStdin) {
+        m_fd = _fileno(stdin);
+        _setmode(m_fd, _O_BINARY);
+    } else {
+        m_fd = _open(m_path.c_str(), _O_RDONLY | _O_BINARY);
+    }
+#else
+    if (m_isStdin) {
+        m_fd = STDIN_FILENO;
+    } else {
+        // Non-blocking open doesn't wait for a FIFO writer; reads are polled anyway
+        m_fd = open(m_path.c_str(), O_RDONLY | O_NONBLOCK);
+    }
+#endif
+    if (m_fd < 0) {
+        std::cerr << "Failed to open " << m_path << " for raw PCM input" << std::endl;
+        return false;
+    }
+
+    // Whole frames only, so a read never ends mid-sample after conversion
+    const size_t frameBytes = static_cast<size_t>(m_channels) * getBytesPerSample(m_format);
+    m_readBuffer.resize((ReadBufferBytes / frameBytes) * frameBytes + frameBytes);
+
+    std::cout << "Raw PCM input from " << (m_isStdin ? "stdin" : m_path) << ": " << m_sampleRate
+              << " Hz, " << m_channels << " channels, " << getSampleFormatName(m_format) << std::endl;
+    return true;
+}
+
+bool PcmStreamSource::start(RingBuffer& ring)
+{
+    if (m_fd < 0) {
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&PcmStreamSource::readLoop, this, &ring);
+    return true;
+}
+
+void PcmStreamSource::stop()
+{
+    m_running = false;
+    if (m_thread.joinable()) {
+#ifdef _WIN32
+        // Unblock a pending read on the pipe
+        CancelSynchronousIo(m_thread.native_handle());
+#endif
+        m_thread.join();
+    }
+}
+
+int PcmStreamSource::readSome(uint8_t* dest, size_t size, int timeoutMs)
+{
+#ifdef _WIN32
+    // Blocking read; stop() cancels it
+    const int result = _read(m_fd, dest, static_cast<unsigned int>(size));
+    return result > 0 ? result : -1;
+#else
+    struct pollfd descriptor;
+    descriptor.fd = m_fd;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+
+    const int ready = poll(&descriptor, 1, timeoutMs);
+    if (ready <= 0) {
+        return 0;
+    }
+
+    const ssize_t result = read(m_fd, dest, size);
+    if (result > 0) {
+        return static_cast<int>(result);
+    }
+    if (result < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return 0;
+    }
+    return -1;
+#endif
+}
+
+void PcmStreamSource::readLoop(RingBuffer* ring)
+{
+    const size_t frameBytes = static_cast<size_t>(m_channels) * getBytesPerSample(m_format);
+    size_t buffered = 0;    // Bytes of a partial frame carried over from the last read
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        const int bytesRead = readSome(m_readBuffer.data() + buffered, m_readBuffer.size() - buffered, 100);
+        if (bytesRead == 0) {
+            continue;
+        }
+        if (bytesRead < 0) {
+            if (m_isStdin) {
+                std::cout << "Raw PCM input reached end of stdin" << std::endl;
+                break;
+            }
+            // The pipe's writer closed; wait for the next one
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+
+        buffered += static_cast<size_t>(bytesRead);
+        const size_t frames = buffered / frameBytes;
+
+        // Convert whole frames straight into the ring
+        const uint8_t* source = m_readBuffer.data();
+        ring->writeWith(2 * frames, [&](float* dest, size_t offset, size_t n) {
+            convertToStereo(source + offset / 2 * frameBytes, m_format, m_channels, n / 2, dest);
+        });
+
+        // Keep the trailing partial frame for the next read
+        const size_t consumed = frames * frameBytes;
+        buffered -= consumed;
+        if (buffered > 0) {
+            std::memmove(m_readBuffer.data(), m_readBuffer.data() + consumed, buffered);
+        }
+    }
+}
+
+} // namespace av
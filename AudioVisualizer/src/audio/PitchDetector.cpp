@@ -0,0 +1,164 @@
+#include "audio/PitchDetector.h"
+#include "audio/FFTPlan.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// A peak within this fraction of the highest one is taken as the period,
+// so the fundamental wins over its octave below
+const float PeakThreshold = 0.9f;
+
+// Windows quieter than this (mean square) have no pitch
+const float SilenceEnergy = 1e-8f;
+
+} // namespace
+
+PitchDetector::PitchDetector()
+    : m_sampleRate(0)
+    , m_windowSize(0)
+    , m_minLag(0)
+    , m_maxLag(0)
+    , m_pitch(0.0f)
+    , m_confidence(0.0f)
+{
+}
+
+bool PitchDetector::initialize(int sampleRate, int windowSize, float minFrequency, float maxFrequency)
+{
+    if (sampleRate <= 0 || windowSize < 64 || minFrequency <= 0.0f || maxFrequency <= minFrequency) {
+        std::cerr << "Pitch detector needs a sample rate, a window of at least 64 samples and a frequency range"
+                  << std::endl;
+        return false;
+    }
+
+    // Lags up to half the window, so every lag still overlaps half the window
+    const int maxLag = static_cast<int>(std::ceil(sampleRate / minFrequency));
+    const int minLag = std::max(2, static_cast<int>(std::floor(sampleRate / maxFrequency)));
+    if (maxLag > windowSize / 2 || minLag >= maxLag) {
+        std::cerr << "Pitch window of " << windowSize << " samples is too short for " << minFrequency
+                  << " Hz at " << sampleRate << " Hz" << std::endl;
+        return false;
+    }
+
+    // Linear (not circular) correlation needs the window zero-padded to twice its length
+    const int fftSize = FFTPlan::nextPowerOfTwo(2 * windowSize);
+    if (!m_realFFT.initialize(fftSize)) {
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_windowSize = windowSize;
+    m_minLag = minLag;
+    m_maxLag = maxLag;
+    m_padded.assign(fftSize, 0.0f);
+    m_squares.assign(windowSize + 1, 0.0f);
+    m_nsdf.assign(maxLag + 2, 0.0f);
+    m_pitch = 0.0f;
+    m_confidence = 0.0f;
+    return true;
+}
+
+void PitchDetector::process(const float* window)
+{
+    const int size = m_windowSize;
+    const int fftSize = static_cast<int>(m_padded.size());
+    float* padded = m_padded.data();
+    float* squares = m_squares.data();
+
+    // Running sum of squares: squares[i] is the energy of the first i samples
+    squares[0] = 0.0f;
+    for (int i = 0; i < size; i++) {
+        squares[i + 1] = squares[i] + window[i] * window[i];
+    }
+    if (squares[size] < SilenceEnergy * size) {
+        m_pitch = 0.0f;
+        m_confidence = 0.0f;
+        return;
+    }
+
+    // Power spectrum of the zero-padded window
+    std::copy(window, window + size, padded);
+    std::fill(padded + size, padded + fftSize, 0.0f);
+    m_realFFT.forward(padded, false);
+    const float* re = m_realFFT.getReal();
+    const float* im = m_realFFT.getImag();
+    const int half = fftSize / 2;
+    for (int k = 0; k <= half; k++) {
+        padded[k] = re[k] * re[k] + im[k] * im[k];
+    }
+    for (int k = half + 1; k < fftSize; k++) {
+        padded[k] = padded[fftSize - k];
+    }
+
+    // Transforming it again gives fftSize times the autocorrelation in the real part
+    m_realFFT.forward(padded, false);
+    const float scale = 2.0f / fftSize;
+    float* nsdf = m_nsdf.data();
+    const int lastLag = std::min(m_maxLag + 1, size - 1);
+    for (int lag = 0; lag <= lastLag; lag++) {
+        const float m = squares[size - lag] + squares[size] - squares[lag];
+        nsdf[lag] = (m > 0.0f) ? re[lag] * scale / m : 0.0f;
+    }
+
+    // Skip the lobe around lag 0, then collect the highest point of each positive region
+    int lag = 1;
+    while (lag <= lastLag && nsdf[lag] > 0.0f) {
+        lag++;
+    }
+    lag = std::max(lag, m_minLag);
+
+    int bestLag = -1;
+    float highest = 0.0f;
+    int candidateLags[32];
+    int numCandidates = 0;
+    int regionPeak = -1;
+    for (; lag < lastLag; lag++) {
+        if (nsdf[lag] > 0.0f) {
+            if (regionPeak < 0 || nsdf[lag] > nsdf[regionPeak]) {
+                regionPeak = lag;
+            }
+        } else if (regionPeak >= 0) {
+            if (numCandidates < 32) {
+                candidateLags[numCandidates++] = regionPeak;
+            }
+            highest = std::max(highest, nsdf[regionPeak]);
+            regionPeak = -1;
+        }
+    }
+    if (regionPeak >= 0 && numCandidates < 32) {
+        candidateLags[numCandidates++] = regionPeak;
+        highest = std::max(highest, nsdf[regionPeak]);
+    }
+    for (int i = 0; i < numCandidates; i++) {
+        if (nsdf[candidateLags[i]] >= PeakThreshold * highest) {
+            bestLag = candidateLags[i];
+            break;
+        }
+    }
+    if (bestLag < 0) {
+        m_pitch = 0.0f;
+        m_confidence = 0.0f;
+        return;
+    }
+
+    // Parabola through the peak and its neighbours
+    const float left = nsdf[bestLag - 1];
+    const float centre = nsdf[bestLag];
+    const float right = nsdf[bestLag + 1];
+    const float curvature = left - 2.0f * centre + right;
+    float offset = 0.0f;
+    float peak = centre;
+    if (curvature < 0.0f) {
+        offset = std::max(-0.5f, std::min(0.5f, 0.5f * (left - right) / curvature));
+        peak = centre - 0.25f * (left - right) * offset;
+    }
+
+    m_pitch = m_sampleRate / (bestLag + offset);
+    m_confidence = std::max(0.0f, std::min(1.0f, peak));
+}
+
+} // namespace av
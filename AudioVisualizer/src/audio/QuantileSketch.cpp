@@ -0,0 +1,123 @@
+#include "audio/QuantileSketch.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Weights are brought back to 1 once the next one would exceed this
+const double RescaleWeight = 1e100;
+
+} // namespace
+
+QuantileSketch::QuantileSketch()
+    : m_minValue(0.0f)
+    , m_binWidth(1.0f)
+    , m_growth(1.0)
+    , m_weight(1.0)
+    , m_total(0.0)
+{
+}
+
+bool QuantileSketch::initialize(const std::vector<float>& quantiles, float minValue, float maxValue,
+                                int numBins, float memory)
+{
+    if (quantiles.empty() || maxValue <= minValue || numBins < 2 || memory < 1.0f) {
+        std::cerr << "Quantile sketch needs quantiles, a value range, at least 2 bins and a memory"
+                  << std::endl;
+        return false;
+    }
+    for (float quantile : quantiles) {
+        if (quantile < 0.0f || quantile > 1.0f) {
+            std::cerr << "Quantile " << quantile << " is outside 0-1" << std::endl;
+            return false;
+        }
+    }
+
+    m_minValue = minValue;
+    m_binWidth = (maxValue - minValue) / numBins;
+    m_growth = std::exp(1.0 / memory);
+    m_bins.assign(numBins, 0.0);
+    m_trackers.clear();
+    for (float quantile : quantiles) {
+        m_trackers.push_back({ quantile, 0, 0.0 });
+    }
+
+    reset();
+    return true;
+}
+
+void QuantileSketch::reset()
+{
+    std::fill(m_bins.begin(), m_bins.end(), 0.0);
+    for (Tracker& tracker : m_trackers) {
+        tracker.bin = 0;
+        tracker.below = 0.0;
+    }
+    m_weight = 1.0;
+    m_total = 0.0;
+}
+
+void QuantileSketch::add(float value)
+{
+    const int numBins = static_cast<int>(m_bins.size());
+    const int bin = std::max(0, std::min(numBins - 1, static_cast<int>((value - m_minValue) / m_binWidth)));
+
+    m_bins[bin] += m_weight;
+    m_total += m_weight;
+    for (Tracker& tracker : m_trackers) {
+        if (bin < tracker.bin) {
+            tracker.below += m_weight;
+        }
+
+        // Walk to the bin where the cumulative weight crosses the quantile
+        const double target = tracker.fraction * m_total;
+        while (tracker.bin > 0 && tracker.below > target) {
+            tracker.bin--;
+            tracker.below -= m_bins[tracker.bin];
+        }
+        while (tracker.bin < numBins - 1 && tracker.below + m_bins[tracker.bin] <= target) {
+            tracker.below += m_bins[tracker.bin];
+            tracker.bin++;
+        }
+    }
+
+    // Older values now count for less
+    m_weight *= m_growth;
+    if (m_weight > RescaleWeight) {
+        rescale();
+    }
+}
+
+float QuantileSketch::getQuantile(int index) const
+{
+    const Tracker& tracker = m_trackers[index];
+    const double inBin = m_bins[tracker.bin];
+    double position = 0.0;
+    if (inBin > 0.0) {
+        position = std::max(0.0, std::min(1.0, (tracker.fraction * m_total - tracker.below) / inBin));
+    }
+    return m_minValue + static_cast<float>((tracker.bin + position) * m_binWidth);
+}
+
+void QuantileSketch::rescale()
+{
+    // Same shares, smaller numbers; the running sums are recomputed so rounding doesn't build up
+    const double scale = 1.0 / m_weight;
+    m_total = 0.0;
+    for (double& weight : m_bins) {
+        weight *= scale;
+        m_total += weight;
+    }
+    for (Tracker& tracker : m_trackers) {
+        tracker.below = 0.0;
+        for (int bin = 0; bin < tracker.bin; bin++) {
+            tracker.below += m_bins[bin];
+        }
+    }
+    m_weight = 1.0;
+}
+
+} // namespace av
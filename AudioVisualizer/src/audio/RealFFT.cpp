@@ -0,0 +1,102 @@
+#include "audio/RealFFT.h"
+#include "audio/FFTPlan.h"
+#include <iostream>
+#include <cmath>
+
+namespace av {
+
+RealFFT::RealFFT()
+    : m_size(0)
+{
+}
+
+bool RealFFT::initialize(int size)
+{
+    if (size < 2 || !FFTPlan::isPowerOfTwo(size)) {
+        std::cerr << "Real FFT size must be a power of 2 (>= 2), got " << size << std::endl;
+        return false;
+    }
+
+    m_size = size;
+    m_halfPlan = FFTPlan::get(size / 2);
+    m_fullPlan = FFTPlan::get(size);
+    m_real.assign(size / 2 + 1, 0.0f);
+    m_imag.assign(size / 2 + 1, 0.0f);
+    return true;
+}
+
+const std::vector<float>& RealFFT::getWindow() const
+{
+    return m_fullPlan->getWindow();
+}
+
+float RealFFT::getWindowSum() const
+{
+    return m_fullPlan->getWindowSum();
+}
+
+void RealFFT::forward(const float* input, bool applyWindow)
+{
+    const int half = m_size / 2;
+    float* re = m_real.data();
+    float* im = m_imag.data();
+
+    // Pack even samples into the real part and odd samples into the imaginary part
+    if (applyWindow) {
+        const float* window = m_fullPlan->getWindow().data();
+        for (int n = 0; n < half; n++) {
+            re[n] = input[2 * n] * window[2 * n];
+            im[n] = input[2 * n + 1] * window[2 * n + 1];
+        }
+    } else {
+        for (int n = 0; n < half; n++) {
+            re[n] = input[2 * n];
+            im[n] = input[2 * n + 1];
+        }
+    }
+
+    m_halfPlan->forward(re, im);
+
+    // DC and Nyquist both come out of Z[0]
+    const float z0r = re[0];
+    const float z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = 0.0f;
+    re[half] = z0r - z0i;
+    im[half] = 0.0f;
+
+    // Untangle bins k and N/2-k together so the split can happen in place:
+    //   E = (Z[k] + conj(Z[N/2-k])) / 2          (spectrum of the even samples)
+    //   O = (Z[k] - conj(Z[N/2-k])) / 2i         (spectrum of the odd samples)
+    //   X[k] = E + W^k O,  X[N/2-k] = conj(E - W^k O)
+    const std::complex<float>* twiddles = m_fullPlan->getTwiddles().data();
+    for (int k = 1; k <= half / 2; k++) {
+        const int m = half - k;
+
+        const float evenRe = 0.5f * (re[k] + re[m]);
+        const float evenIm = 0.5f * (im[k] - im[m]);
+        const float oddRe = 0.5f * (im[k] + im[m]);
+        const float oddIm = -0.5f * (re[k] - re[m]);
+
+        const std::complex<float>& w = twiddles[k];
+        const float tr = oddRe * w.real() - oddIm * w.imag();
+        const float ti = oddRe * w.imag() + oddIm * w.real();
+
+        re[k] = evenRe + tr;
+        im[k] = evenIm + ti;
+        re[m] = evenRe - tr;
+        im[m] = ti - evenIm;
+    }
+}
+
+void RealFFT::getMagnitudes(float* output, float scale) const
+{
+    const int numBins = getNumBins();
+    const float* re = m_real.data();
+    const float* im = m_imag.data();
+    for (int k = 0; k < numBins; k++) {
+        output[k] = std::sqrt(re[k] * re[k] + im[k] * im[k]) * scale;
+    }
+}
+
+} // namespace av
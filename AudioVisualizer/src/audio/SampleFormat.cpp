@@ -0,0 +1,128 @@
+#include "audio/SampleFormat.h"
+#include "audio/SampleKernels.h"
+#include <cstdint>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Conversions run in blocks of at most this many input samples, so the
+// scratch planes live on the stack and stay in cache
+const size_t BlockSamples = 1024;
+
+} // namespace
+
+int getBytesPerSample(SampleFormat format)
+{
+    switch (format) {
+        case SampleFormat::Int16: return 2;
+        case SampleFormat::Int24: return 3;
+        case SampleFormat::Int32: return 4;
+        case SampleFormat::Float32: return 4;
+    }
+    return 0;
+}
+
+const char* getSampleFormatName(SampleFormat format)
+{
+    switch (format) {
+        case SampleFormat::Int16: return "s16";
+        case SampleFormat::Int24: return "s24";
+        case SampleFormat::Int32: return "s32";
+        case SampleFormat::Float32: return "f32";
+    }
+    return "unknown";
+}
+
+bool parseSampleFormat(const std::string& name, SampleFormat& format)
+{
+    if (name == "s16") format = SampleFormat::Int16;
+    else if (name == "s24") format = SampleFormat::Int24;
+    else if (name == "s32") format = SampleFormat::Int32;
+    else if (name == "f32") format = SampleFormat::Float32;
+    else return false;
+    return true;
+}
+
+void convertToMono(const void* input, SampleFormat format, int channels, size_t frames, float* output)
+{
+    const SampleKernels& kernels = SampleKernels::best();
+    const SampleKernels::Decode decode = kernels.getDecoder(format);
+    if (channels == 1) {
+        decode(input, frames, output);
+        return;
+    }
+
+    float matrix[MaxSampleChannels];
+    std::fill(matrix, matrix + channels, 1.0f / static_cast<float>(channels));
+
+    float interleaved[BlockSamples];
+    float planar[BlockSamples];
+    float* planes[MaxSampleChannels];
+    const size_t blockFrames = BlockSamples / channels;
+    for (int channel = 0; channel < channels; channel++) {
+        planes[channel] = planar + channel * blockFrames;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    const size_t frameBytes = static_cast<size_t>(channels) * getBytesPerSample(format);
+    for (size_t frame = 0; frame < frames; frame += blockFrames) {
+        const size_t count = std::min(blockFrames, frames - frame);
+        float* mono = output + frame;
+        decode(bytes + frame * frameBytes, count * channels, interleaved);
+        kernels.deinterleave(interleaved, channels, count, planes);
+        kernels.downmix(planes, channels, count, matrix, 1, &mono);
+    }
+}
+
+void convertToStereo(const void* input, SampleFormat format, int channels, size_t frames, float* output)
+{
+    const SampleKernels& kernels = SampleKernels::best();
+    const SampleKernels::Decode decode = kernels.getDecoder(format);
+    if (channels == 2) {
+        decode(input, 2 * frames, output);
+        return;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    const size_t frameBytes = static_cast<size_t>(channels) * getBytesPerSample(format);
+    if (channels == 1) {
+        // Mono goes to both sides as it is
+        float mono[BlockSamples];
+        const float* const both[2] = { mono, mono };
+        for (size_t frame = 0; frame < frames; frame += BlockSamples) {
+            const size_t count = std::min(BlockSamples, frames - frame);
+            decode(bytes + frame * frameBytes, count, mono);
+            kernels.interleave(both, 2, count, output + 2 * frame);
+        }
+        return;
+    }
+
+    // Left and right count twice, so (L + R) / 2 weighs every channel 1 / channels
+    float matrix[2 * MaxSampleChannels];
+    const float channelScale = 1.0f / static_cast<float>(channels);
+    std::fill(matrix, matrix + 2 * channels, channelScale);
+    matrix[0] = matrix[channels + 1] = 2.0f * channelScale;
+    matrix[1] = matrix[channels] = 0.0f;
+
+    float interleaved[BlockSamples];
+    float planar[BlockSamples];
+    float mixed[BlockSamples];
+    float* planes[MaxSampleChannels];
+    const size_t blockFrames = BlockSamples / channels;
+    for (int channel = 0; channel < channels; channel++) {
+        planes[channel] = planar + channel * blockFrames;
+    }
+    float* const sides[2] = { mixed, mixed + BlockSamples / 2 };
+
+    for (size_t frame = 0; frame < frames; frame += blockFrames) {
+        const size_t count = std::min(blockFrames, frames - frame);
+        decode(bytes + frame * frameBytes, count * channels, interleaved);
+        kernels.deinterleave(interleaved, channels, count, planes);
+        kernels.downmix(planes, channels, count, matrix, 2, sides);
+        kernels.interleave(sides, 2, count, output + 2 * frame);
+    }
+}
+
+} // namespace av
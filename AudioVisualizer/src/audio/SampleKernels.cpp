@@ -0,0 +1,280 @@
+#include "audio/SampleKernels.h"
+#include "audio/Simd.h"
+#include <cstdint>
+#include <cstring>
+
+namespace av {
+
+namespace {
+
+const float Int16Scale = 1.0f / 32768.0f;
+const float Int24Scale = 1.0f / 8388608.0f;
+const float Int32Scale = 1.0f / 2147483648.0f;
+
+// ---------------------------------------------------------------------------
+// Scalar reference kernels
+// ---------------------------------------------------------------------------
+
+// memcpy keeps the unaligned reads well-defined
+void scalarDecodeInt16(const void* input, size_t samples, float* output)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    for (size_t i = 0; i < samples; i++) {
+        int16_t value;
+        std::memcpy(&value, bytes + i * 2, sizeof(value));
+        output[i] = static_cast<float>(value) * Int16Scale;
+    }
+}
+
+void scalarDecodeInt24(const void* input, size_t samples, float* output)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    for (size_t i = 0; i < samples; i++) {
+        const uint8_t* p = bytes + i * 3;
+        // Assemble in the top 24 bits so the arithmetic shift sign-extends
+        const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                                   (static_cast<uint32_t>(p[1]) << 16) |
+                                                   (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+        output[i] = static_cast<float>(value) * Int24Scale;
+    }
+}
+
+void scalarDecodeInt32(const void* input, size_t samples, float* output)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    for (size_t i = 0; i < samples; i++) {
+        int32_t value;
+        std::memcpy(&value, bytes + i * 4, sizeof(value));
+        output[i] = static_cast<float>(value) * Int32Scale;
+    }
+}
+
+// Already float: a copy for every kernel set
+void copyFloat32(const void* input, size_t samples, float* output)
+{
+    std::memcpy(output, input, samples * sizeof(float));
+}
+
+void scalarDeinterleave(const float* input, int channels, size_t frames, float* const* planes)
+{
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (int channel = 0; channel < channels; channel++) {
+            planes[channel][frame] = input[frame * channels + channel];
+        }
+    }
+}
+
+void scalarInterleave(const float* const* planes, int channels, size_t frames, float* output)
+{
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (int channel = 0; channel < channels; channel++) {
+            output[frame * channels + channel] = planes[channel][frame];
+        }
+    }
+}
+
+void scalarDownmix(const float* const* inputs, int inputChannels, size_t frames,
+                   const float* matrix, int outputChannels, float* const* outputs)
+{
+    for (int output = 0; output < outputChannels; output++) {
+        const float* row = matrix + output * inputChannels;
+        for (size_t frame = 0; frame < frames; frame++) {
+            float sum = row[0] * inputs[0][frame];
+            for (int input = 1; input < inputChannels; input++) {
+                sum += row[input] * inputs[input][frame];
+            }
+            outputs[output][frame] = sum;
+        }
+    }
+}
+
+#ifdef AV_SIMD_SSE2
+// ---------------------------------------------------------------------------
+// SSE2 kernels (4 samples or frames per iteration)
+// ---------------------------------------------------------------------------
+
+void sse2DecodeInt16(const void* input, size_t samples, float* output)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    const __m128 scale = _mm_set1_ps(Int16Scale);
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i * 2));
+        // Each sample paired with itself, then shifted down: sign-extended to 32 bits
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+    scalarDecodeInt16(bytes + i * 2, samples - i, output + i);
+}
+
+void sse2DecodeInt24(const void* input, size_t samples, float* output)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    const __m128 scale = _mm_set1_ps(Int24Scale);
+    const __m128i lane0 = _mm_setr_epi32(0xFFFFFF, 0, 0, 0);
+    const __m128i lane1 = _mm_setr_epi32(0, 0xFFFFFF, 0, 0);
+    const __m128i lane2 = _mm_setr_epi32(0, 0, 0xFFFFFF, 0);
+    const __m128i lane3 = _mm_setr_epi32(0, 0, 0, 0xFFFFFF);
+    size_t i = 0;
+    // Four samples take 12 bytes, but the load reads 16
+    for (; (i + 4) * 3 + 4 <= samples * 3; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i * 3));
+        // Sample k starts at byte 3k, so shifting left by k bytes moves it to the start of lane k
+        const __m128i packed = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(v, lane0), _mm_and_si128(_mm_slli_si128(v, 1), lane1)),
+            _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), lane2), _mm_and_si128(_mm_slli_si128(v, 3), lane3)));
+        const __m128i value = _mm_srai_epi32(_mm_slli_epi32(packed, 8), 8);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+    }
+    scalarDecodeInt24(bytes + i * 3, samples - i, output + i);
+}
+
+void sse2DecodeInt32(const void* input, size_t samples, float* output)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(input);
+    const __m128 scale = _mm_set1_ps(Int32Scale);
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i * 4));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    scalarDecodeInt32(bytes + i * 4, samples - i, output + i);
+}
+
+// Stereo splits by shuffling even and odd lanes, multiples of four channels by 4x4 transposes,
+// and any other layout by gathering four frames of one channel at a time
+void sse2Deinterleave(const float* input, int channels, size_t frames, float* const* planes)
+{
+    size_t frame = 0;
+    if (channels == 2) {
+        for (; frame + 4 <= frames; frame += 4) {
+            const __m128 a = _mm_loadu_ps(input + frame * 2);
+            const __m128 b = _mm_loadu_ps(input + frame * 2 + 4);
+            _mm_storeu_ps(planes[0] + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(planes[1] + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    } else if (channels % 4 == 0) {
+        for (; frame + 4 <= frames; frame += 4) {
+            const float* rows = input + frame * channels;
+            for (int channel = 0; channel < channels; channel += 4) {
+                __m128 r0 = _mm_loadu_ps(rows + channel);
+                __m128 r1 = _mm_loadu_ps(rows + channels + channel);
+                __m128 r2 = _mm_loadu_ps(rows + 2 * channels + channel);
+                __m128 r3 = _mm_loadu_ps(rows + 3 * channels + channel);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(planes[channel] + frame, r0);
+                _mm_storeu_ps(planes[channel + 1] + frame, r1);
+                _mm_storeu_ps(planes[channel + 2] + frame, r2);
+                _mm_storeu_ps(planes[channel + 3] + frame, r3);
+            }
+        }
+    } else {
+        // Other layouts (5.1): gather each channel four frames at a time
+        const size_t vectorFrames = frames & ~size_t(3);
+        for (int channel = 0; channel < channels; channel++) {
+            const float* in = input + channel;
+            float* plane = planes[channel];
+            for (size_t f = 0; f < vectorFrames; f += 4) {
+                _mm_storeu_ps(plane + f, _mm_setr_ps(in[f * channels], in[(f + 1) * channels],
+                                                     in[(f + 2) * channels], in[(f + 3) * channels]));
+            }
+        }
+        frame = vectorFrames;
+    }
+    for (; frame < frames; frame++) {
+        for (int channel = 0; channel < channels; channel++) {
+            planes[channel][frame] = input[frame * channels + channel];
+        }
+    }
+}
+
+void sse2Interleave(const float* const* planes, int channels, size_t frames, float* output)
+{
+    if (channels != 2) {
+        scalarInterleave(planes, channels, frames, output);
+        return;
+    }
+
+    size_t frame = 0;
+    for (; frame + 4 <= frames; frame += 4) {
+        const __m128 left = _mm_loadu_ps(planes[0] + frame);
+        const __m128 right = _mm_loadu_ps(planes[1] + frame);
+        _mm_storeu_ps(output + frame * 2, _mm_unpacklo_ps(left, right));
+        _mm_storeu_ps(output + frame * 2 + 4, _mm_unpackhi_ps(left, right));
+    }
+    for (; frame < frames; frame++) {
+        output[frame * 2] = planes[0][frame];
+        output[frame * 2 + 1] = planes[1][frame];
+    }
+}
+
+// Same order of operations as the scalar kernel, four frames at a time
+void sse2Downmix(const float* const* inputs, int inputChannels, size_t frames,
+                 const float* matrix, int outputChannels, float* const* outputs)
+{
+    for (int output = 0; output < outputChannels; output++) {
+        const float* row = matrix + output * inputChannels;
+        float* out = outputs[output];
+        size_t frame = 0;
+        for (; frame + 4 <= frames; frame += 4) {
+            __m128 sum = _mm_mul_ps(_mm_set1_ps(row[0]), _mm_loadu_ps(inputs[0] + frame));
+            for (int input = 1; input < inputChannels; input++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[input]), _mm_loadu_ps(inputs[input] + frame)));
+            }
+            _mm_storeu_ps(out + frame, sum);
+        }
+        for (; frame < frames; frame++) {
+            float sum = row[0] * inputs[0][frame];
+            for (int input = 1; input < inputChannels; input++) {
+                sum += row[input] * inputs[input][frame];
+            }
+            out[frame] = sum;
+        }
+    }
+}
+#endif
+
+} // namespace
+
+SampleKernels::Decode SampleKernels::getDecoder(SampleFormat format) const
+{
+    switch (format) {
+        case SampleFormat::Int16: return decodeInt16;
+        case SampleFormat::Int24: return decodeInt24;
+        case SampleFormat::Int32: return decodeInt32;
+        case SampleFormat::Float32: return decodeFloat32;
+    }
+    return decodeFloat32;
+}
+
+const SampleKernels& SampleKernels::scalar()
+{
+    static const SampleKernels kernels = {
+        "Scalar", scalarDecodeInt16, scalarDecodeInt24, scalarDecodeInt32, copyFloat32,
+        scalarDeinterleave, scalarInterleave, scalarDownmix
+    };
+    return kernels;
+}
+
+const SampleKernels* SampleKernels::sse2()
+{
+#ifdef AV_SIMD_SSE2
+    static const SampleKernels kernels = {
+        "SSE2", sse2DecodeInt16, sse2DecodeInt24, sse2DecodeInt32, copyFloat32,
+        sse2Deinterleave, sse2Interleave, sse2Downmix
+    };
+    return &kernels;
+#else
+    return nullptr;
+#endif
+}
+
+const SampleKernels& SampleKernels::best()
+{
+    static const SampleKernels& selected = sse2() ? *sse2() : scalar();
+    return selected;
+}
+
+} // namespace av
@@ -0,0 +1,109 @@
+#include "audio/SdlCaptureSource.h"
+#include "audio/RingBuffer.h"
+#include <iostream>
+
+#include <SDL.h>
+
+namespace av {
+
+SdlCaptureSource::SdlCaptureSource()
+    : m_deviceId(0)
+    , m_sampleRate(0)
+    , m_channels(2)
+    , m_format(SampleFormat::Float32)
+    , m_sdlAudioInitialized(false)
+    , m_ring(nullptr)
+{
+}
+
+SdlCaptureSource::~SdlCaptureSource()
+{
+    stop();
+    if (m_sdlAudioInitialized) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+}
+
+bool SdlCaptureSource::initialize(int sampleRate)
+{
+    // Initialize SDL Audio subsystem
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        std::cerr << "SDL audio could not initialize! SDL Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    m_sdlAudioInitialized = true;
+
+    SDL_AudioSpec wantedSpec;
+    SDL_AudioSpec obtainedSpec;
+    SDL_zero(wantedSpec);
+    wantedSpec.freq = sampleRate;
+    wantedSpec.format = AUDIO_F32SYS;
+    wantedSpec.channels = 2;
+    wantedSpec.samples = 512;
+    wantedSpec.callback = &SdlCaptureSource::captureCallback;
+    wantedSpec.userdata = this;
+
+    // Take the device's own format and channels when the sample kernels can decode them,
+    // so SDL doesn't convert each sample on its own. Otherwise reopen with only the rate
+    // allowed to change and let SDL convert to stereo float.
+    // The device stays paused until start() provides the ring.
+    m_deviceId = SDL_OpenAudioDevice(nullptr, 1, &wantedSpec, &obtainedSpec,
+                                     SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_FORMAT_CHANGE |
+                                     SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+    if (m_deviceId != 0 && !getSampleFormat(obtainedSpec.format, m_format)) {
+        SDL_CloseAudioDevice(m_deviceId);
+        m_deviceId = SDL_OpenAudioDevice(nullptr, 1, &wantedSpec, &obtainedSpec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+        m_format = SampleFormat::Float32;
+    }
+    if (m_deviceId == 0) {
+        std::cerr << "No audio capture device available: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    m_sampleRate = obtainedSpec.freq;
+    m_channels = obtainedSpec.channels;
+    std::cout << "SDL audio capture initialized at " << m_sampleRate << " Hz, " << m_channels
+              << " channels, " << getSampleFormatName(m_format) << std::endl;
+    return true;
+}
+
+bool SdlCaptureSource::start(RingBuffer& ring)
+{
+    if (m_deviceId == 0) {
+        return false;
+    }
+
+    m_ring = &ring;
+    SDL_PauseAudioDevice(m_deviceId, 0);
+    return true;
+}
+
+void SdlCaptureSource::stop()
+{
+    if (m_deviceId != 0) {
+        SDL_CloseAudioDevice(m_deviceId);
+        m_deviceId = 0;
+    }
+}
+
+bool SdlCaptureSource::getSampleFormat(uint16_t sdlFormat, SampleFormat& format)
+{
+    // Sample formats are little-endian; anything else is left for SDL to convert
+    if (sdlFormat == AUDIO_S16LSB) format = SampleFormat::Int16;
+    else if (sdlFormat == AUDIO_S32LSB) format = SampleFormat::Int32;
+    else if (sdlFormat == AUDIO_F32LSB) format = SampleFormat::Float32;
+    else return false;
+    return true;
+}
+
+void SdlCaptureSource::captureCallback(void* userdata, uint8_t* stream, int len)
+{
+    SdlCaptureSource* source = static_cast<SdlCaptureSource*>(userdata);
+    const size_t frameBytes = static_cast<size_t>(source->m_channels) * getBytesPerSample(source->m_format);
+    const size_t frames = static_cast<size_t>(len) / frameBytes;
+    source->m_ring->writeWith(2 * frames, [&](float* dest, size_t offset, size_t n) {
+        convertToStereo(stream + offset / 2 * frameBytes, source->m_format, source->m_channels, n / 2, dest);
+    });
+}
+
+} // namespace av
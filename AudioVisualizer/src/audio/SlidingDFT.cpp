@@ -0,0 +1,204 @@
+#include "audio/SlidingDFT.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// Input is processed in chunks of this many samples so the deltas fit a fixed buffer
+const size_t ChunkSize = 256;
+
+} // namespace
+
+SlidingDFT::SlidingDFT()
+    : m_windowSize(0)
+    , m_dampingN(1.0f)
+    , m_hannWindow(false)
+    , m_scale(0.0f)
+    , m_numTracked(0)
+    , m_numGroups(0)
+    , m_historyPosition(0)
+{
+}
+
+bool SlidingDFT::initialize(int windowSize, const std::vector<int>& bins, float damping, bool hannWindow)
+{
+    if (windowSize < 4 || bins.empty() || damping <= 0.0f || damping > 1.0f) {
+        std::cerr << "Sliding DFT needs a window of at least 4 samples, some bins and a damping in (0, 1]"
+                  << std::endl;
+        return false;
+    }
+    for (int bin : bins) {
+        if (bin < 1 || bin >= windowSize / 2) {
+            std::cerr << "Sliding DFT bins must lie in 1.." << (windowSize / 2 - 1) << ", got " << bin << std::endl;
+            return false;
+        }
+    }
+
+    m_windowSize = windowSize;
+    m_hannWindow = hannWindow;
+    m_bins = bins;
+
+    // Every bin the output needs, once each (neighbours are shared between adjacent bins)
+    std::vector<int> tracked;
+    for (int bin : bins) {
+        tracked.push_back(bin);
+        if (hannWindow) {
+            tracked.push_back(bin - 1);
+            tracked.push_back(bin + 1);
+        }
+    }
+    std::sort(tracked.begin(), tracked.end());
+    tracked.erase(std::unique(tracked.begin(), tracked.end()), tracked.end());
+
+    const auto laneOf = [&tracked](int bin) {
+        return static_cast<int>(std::lower_bound(tracked.begin(), tracked.end(), bin) - tracked.begin());
+    };
+    m_lowerLane.resize(bins.size());
+    m_centreLane.resize(bins.size());
+    m_upperLane.resize(bins.size());
+    for (size_t i = 0; i < bins.size(); i++) {
+        m_centreLane[i] = laneOf(bins[i]);
+        m_lowerLane[i] = hannWindow ? laneOf(bins[i] - 1) : m_centreLane[i];
+        m_upperLane[i] = hannWindow ? laneOf(bins[i] + 1) : m_centreLane[i];
+    }
+
+    // Padding lanes rotate by zero and stay silent
+    m_numTracked = static_cast<int>(tracked.size());
+    m_numGroups = (m_numTracked + Lanes - 1) / Lanes;
+    m_rotationRe.assign(m_numGroups * Lanes, 0.0f);
+    m_rotationIm.assign(m_numGroups * Lanes, 0.0f);
+    for (int lane = 0; lane < m_numTracked; lane++) {
+        const double w = 2.0 * Pi * tracked[lane] / windowSize;
+        m_rotationRe[lane] = static_cast<float>(damping * std::cos(w));
+        m_rotationIm[lane] = static_cast<float>(damping * std::sin(w));
+    }
+    m_dampingN = static_cast<float>(std::pow(static_cast<double>(damping), windowSize));
+
+    // A sample m steps from the oldest carries r^(N-m) on top of the window
+    double windowSum = 0.0;
+    for (int m = 0; m < windowSize; m++) {
+        const double window = hannWindow ? 0.5 - 0.5 * std::cos(2.0 * Pi * m / windowSize) : 1.0;
+        windowSum += window * std::pow(static_cast<double>(damping), windowSize - m);
+    }
+    m_scale = static_cast<float>(2.0 / windowSum);
+
+    m_sumRe.assign(m_numGroups * Lanes, 0.0f);
+    m_sumIm.assign(m_numGroups * Lanes, 0.0f);
+    m_history.assign(windowSize, 0.0f);
+    m_deltas.assign(ChunkSize, 0.0f);
+    reset();
+    return true;
+}
+
+void SlidingDFT::reset()
+{
+    std::fill(m_sumRe.begin(), m_sumRe.end(), 0.0f);
+    std::fill(m_sumIm.begin(), m_sumIm.end(), 0.0f);
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_historyPosition = 0;
+}
+
+void SlidingDFT::process(const float* samples, size_t count)
+{
+    if (m_numGroups == 0) {
+        return;
+    }
+
+    float* history = m_history.data();
+    float* deltas = m_deltas.data();
+    while (count > 0) {
+        const size_t chunk = std::min(count, ChunkSize);
+
+        // New sample in, damped oldest sample out; the same for every bin
+        for (size_t n = 0; n < chunk; n++) {
+            deltas[n] = samples[n] - m_dampingN * history[m_historyPosition];
+            history[m_historyPosition] = samples[n];
+            if (++m_historyPosition == m_windowSize) {
+                m_historyPosition = 0;
+            }
+        }
+
+        for (int group = 0; group < m_numGroups; group++) {
+            processGroup(group, deltas, chunk);
+        }
+
+        samples += chunk;
+        count -= chunk;
+    }
+}
+
+void SlidingDFT::processGroup(int group, const float* deltas, size_t count)
+{
+    const float* rotationRe = &m_rotationRe[group * Lanes];
+    const float* rotationIm = &m_rotationIm[group * Lanes];
+    float* sumRe = &m_sumRe[group * Lanes];
+    float* sumIm = &m_sumIm[group * Lanes];
+
+#ifdef AV_SIMD_SSE2
+    // Keep the group's sums in registers for the chunk; the two halves are independent
+    const __m128 cosine0 = _mm_loadu_ps(rotationRe);
+    const __m128 cosine1 = _mm_loadu_ps(rotationRe + 4);
+    const __m128 sine0 = _mm_loadu_ps(rotationIm);
+    const __m128 sine1 = _mm_loadu_ps(rotationIm + 4);
+    __m128 re0 = _mm_loadu_ps(sumRe);
+    __m128 re1 = _mm_loadu_ps(sumRe + 4);
+    __m128 im0 = _mm_loadu_ps(sumIm);
+    __m128 im1 = _mm_loadu_ps(sumIm + 4);
+
+    for (size_t n = 0; n < count; n++) {
+        const __m128 delta = _mm_set1_ps(deltas[n]);
+        const __m128 shifted0 = _mm_add_ps(re0, delta);
+        const __m128 shifted1 = _mm_add_ps(re1, delta);
+        re0 = _mm_sub_ps(_mm_mul_ps(cosine0, shifted0), _mm_mul_ps(sine0, im0));
+        re1 = _mm_sub_ps(_mm_mul_ps(cosine1, shifted1), _mm_mul_ps(sine1, im1));
+        im0 = _mm_add_ps(_mm_mul_ps(sine0, shifted0), _mm_mul_ps(cosine0, im0));
+        im1 = _mm_add_ps(_mm_mul_ps(sine1, shifted1), _mm_mul_ps(cosine1, im1));
+    }
+
+    _mm_storeu_ps(sumRe, re0);
+    _mm_storeu_ps(sumRe + 4, re1);
+    _mm_storeu_ps(sumIm, im0);
+    _mm_storeu_ps(sumIm + 4, im1);
+#else
+    for (int lane = 0; lane < Lanes; lane++) {
+        float re = sumRe[lane];
+        float im = sumIm[lane];
+        for (size_t n = 0; n < count; n++) {
+            const float shifted = re + deltas[n];
+            re = rotationRe[lane] * shifted - rotationIm[lane] * im;
+            im = rotationIm[lane] * shifted + rotationRe[lane] * im;
+        }
+        sumRe[lane] = re;
+        sumIm[lane] = im;
+    }
+#endif
+}
+
+void SlidingDFT::getMagnitudes(float* output) const
+{
+    for (int i = 0; i < getNumBins(); i++) {
+        output[i] = getMagnitude(i);
+    }
+}
+
+float SlidingDFT::getMagnitude(int index) const
+{
+    const int centre = m_centreLane[index];
+    float re = m_sumRe[centre];
+    float im = m_sumIm[centre];
+    if (m_hannWindow) {
+        const int lower = m_lowerLane[index];
+        const int upper = m_upperLane[index];
+        re = 0.5f * re - 0.25f * (m_sumRe[lower] + m_sumRe[upper]);
+        im = 0.5f * im - 0.25f * (m_sumIm[lower] + m_sumIm[upper]);
+    }
+    return std::sqrt(re * re + im * im) * m_scale;
+}
+
+} // namespace av
@@ -0,0 +1,180 @@
+#include "audio/StereoAnalyzer.h"
+#include "audio/FFTPlan.h"
+#include "audio/Simd.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace av {
+
+namespace {
+
+const float InvSqrt2 = 0.70710678f;
+
+// Below this smoothed energy a channel counts as silent
+const float SilentEnergy = 1e-10f;
+
+} // namespace
+
+StereoAnalyzer::StereoAnalyzer()
+    : m_frameSize(0)
+    , m_hopSize(0)
+    , m_smoothing(0.0f)
+    , m_sumLR(0.0f)
+    , m_sumLL(0.0f)
+    , m_sumRR(0.0f)
+    , m_correlation(0.0f)
+    , m_goniometerStep(1)
+{
+}
+
+bool StereoAnalyzer::initialize(int frameSize, int hopSize, int sampleRate, int goniometerPoints,
+                                float correlationSeconds)
+{
+    if (!FFTPlan::isPowerOfTwo(frameSize) || hopSize <= 0 || hopSize > frameSize || goniometerPoints <= 0) {
+        std::cerr << "Invalid stereo analysis: " << frameSize << "-sample frames, " << hopSize
+                  << "-sample hops, " << goniometerPoints << " goniometer points" << std::endl;
+        return false;
+    }
+
+    m_frameSize = frameSize;
+    m_hopSize = hopSize;
+    m_plan = FFTPlan::get(frameSize);
+    m_left.assign(frameSize, 0.0f);
+    m_right.assign(frameSize, 0.0f);
+    m_real.assign(frameSize, 0.0f);
+    m_imag.assign(frameSize, 0.0f);
+    for (std::vector<float>& magnitudes : m_magnitudes) {
+        magnitudes.assign(frameSize / 2 + 1, 0.0f);
+    }
+    m_smoothing = std::exp(-static_cast<float>(hopSize) / (correlationSeconds * sampleRate));
+    m_goniometerStep = std::max(1, hopSize / goniometerPoints);
+    m_goniometer.assign(2 * (hopSize / m_goniometerStep), 0.0f);
+    reset();
+    return true;
+}
+
+void StereoAnalyzer::reset()
+{
+    std::fill(m_left.begin(), m_left.end(), 0.0f);
+    std::fill(m_right.begin(), m_right.end(), 0.0f);
+    std::fill(m_goniometer.begin(), m_goniometer.end(), 0.0f);
+    for (std::vector<float>& magnitudes : m_magnitudes) {
+        std::fill(magnitudes.begin(), magnitudes.end(), 0.0f);
+    }
+    m_sumLR = 0.0f;
+    m_sumLL = 0.0f;
+    m_sumRR = 0.0f;
+    m_correlation = 0.0f;
+}
+
+float StereoAnalyzer::getWindowSum() const
+{
+    return m_plan->getWindowSum();
+}
+
+void StereoAnalyzer::processHop(const float* frames)
+{
+    // Slide both frames and deinterleave the new hop onto their ends
+    const int keep = m_frameSize - m_hopSize;
+    std::copy(m_left.begin() + m_hopSize, m_left.end(), m_left.begin());
+    std::copy(m_right.begin() + m_hopSize, m_right.end(), m_right.begin());
+    float* left = m_left.data() + keep;
+    float* right = m_right.data() + keep;
+
+    float sumLR = 0.0f;
+    float sumLL = 0.0f;
+    float sumRR = 0.0f;
+    for (int i = 0; i < m_hopSize; i++) {
+        const float l = frames[2 * i];
+        const float r = frames[2 * i + 1];
+        left[i] = l;
+        right[i] = r;
+        sumLR += l * r;
+        sumLL += l * l;
+        sumRR += r * r;
+    }
+
+    m_sumLR = m_sumLR * m_smoothing + sumLR;
+    m_sumLL = m_sumLL * m_smoothing + sumLL;
+    m_sumRR = m_sumRR * m_smoothing + sumRR;
+    const float energy = m_sumLL * m_sumRR;
+    m_correlation = (energy > SilentEnergy) ? std::max(-1.0f, std::min(1.0f, m_sumLR / std::sqrt(energy))) : 0.0f;
+
+    // Every step-th frame of the hop, rotated so mid is vertical
+    const size_t numPoints = m_goniometer.size() / 2;
+    for (size_t point = 0; point < numPoints; point++) {
+        const int i = static_cast<int>(point) * m_goniometerStep;
+        m_goniometer[2 * point] = (left[i] - right[i]) * InvSqrt2;
+        m_goniometer[2 * point + 1] = (left[i] + right[i]) * InvSqrt2;
+    }
+}
+
+void StereoAnalyzer::transform()
+{
+    const float* window = m_plan->getWindow().data();
+    float* re = m_real.data();
+    float* im = m_imag.data();
+    for (int n = 0; n < m_frameSize; n++) {
+        re[n] = m_left[n] * window[n];
+        im[n] = m_right[n] * window[n];
+    }
+    m_plan->forward(re, im);
+
+    // With Z[k] = a + bi and Z[N-k] = c + di:
+    //   L[k] = ((a + c) + (b - d)i) / 2,  R[k] = ((b + d) + (c - a)i) / 2
+    //   M[k] = (L[k] + R[k]) / 2,         S[k] = (L[k] - R[k]) / 2
+    float* left = m_magnitudes[static_cast<int>(StereoChannel::Left)].data();
+    float* right = m_magnitudes[static_cast<int>(StereoChannel::Right)].data();
+    float* mid = m_magnitudes[static_cast<int>(StereoChannel::Mid)].data();
+    float* side = m_magnitudes[static_cast<int>(StereoChannel::Side)].data();
+    const int numBins = getNumBins();
+
+    // DC pairs with itself
+    left[0] = std::abs(re[0]);
+    right[0] = std::abs(im[0]);
+    mid[0] = 0.5f * std::abs(re[0] + im[0]);
+    side[0] = 0.5f * std::abs(re[0] - im[0]);
+
+    int k = 1;
+#ifdef AV_SIMD_SSE2
+    // Four bins at a time against the four mirrored ones, loaded in reverse
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    auto magnitude = [](__m128 x, __m128 y) {
+        return _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+    };
+    for (; k + 4 <= numBins; k += 4) {
+        const int m = m_frameSize - k - 3;
+        const __m128 a = _mm_loadu_ps(re + k);
+        const __m128 b = _mm_loadu_ps(im + k);
+        const __m128 c = _mm_shuffle_ps(_mm_loadu_ps(re + m), _mm_loadu_ps(re + m), _MM_SHUFFLE(0, 1, 2, 3));
+        const __m128 d = _mm_shuffle_ps(_mm_loadu_ps(im + m), _mm_loadu_ps(im + m), _MM_SHUFFLE(0, 1, 2, 3));
+        const __m128 sumRe = _mm_add_ps(a, c);
+        const __m128 diffIm = _mm_sub_ps(b, d);
+        const __m128 sumIm = _mm_add_ps(b, d);
+        const __m128 diffRe = _mm_sub_ps(c, a);
+        _mm_storeu_ps(left + k, _mm_mul_ps(half, magnitude(sumRe, diffIm)));
+        _mm_storeu_ps(right + k, _mm_mul_ps(half, magnitude(sumIm, diffRe)));
+        _mm_storeu_ps(mid + k, _mm_mul_ps(quarter, magnitude(_mm_add_ps(sumRe, sumIm), _mm_add_ps(diffIm, diffRe))));
+        _mm_storeu_ps(side + k, _mm_mul_ps(quarter, magnitude(_mm_sub_ps(sumRe, sumIm), _mm_sub_ps(diffIm, diffRe))));
+    }
+#endif
+    for (; k < numBins; k++) {
+        const int m = m_frameSize - k;
+        const float sumRe = re[k] + re[m];
+        const float diffIm = im[k] - im[m];
+        const float sumIm = im[k] + im[m];
+        const float diffRe = re[m] - re[k];
+        left[k] = 0.5f * std::sqrt(sumRe * sumRe + diffIm * diffIm);
+        right[k] = 0.5f * std::sqrt(sumIm * sumIm + diffRe * diffRe);
+        const float midRe = sumRe + sumIm;
+        const float midIm = diffIm + diffRe;
+        const float sideRe = sumRe - sumIm;
+        const float sideIm = diffIm - diffRe;
+        mid[k] = 0.25f * std::sqrt(midRe * midRe + midIm * midIm);
+        side[k] = 0.25f * std::sqrt(sideRe * sideRe + sideIm * sideIm);
+    }
+}
+
+} // namespace av
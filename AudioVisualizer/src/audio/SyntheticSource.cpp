@@ -0,0 +1,348 @@
+#include "audio/SyntheticSource.h"
+#include "audio/RingBuffer.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Frames generated per block
+const size_t GeneratorBlockFrames = 256;
+
+// Tone frequencies
+const double BassFrequency = 100.0;
+const double MidFrequency = 1000.0;
+const double TrebleFrequency = 5000.0;
+const double ToneSweepCentre = 500.0;       // The sweeping tone moves between 0 and 1 kHz every 5 s
+const double ToneSweepRate = 0.2;
+
+// Log sweep range and length
+const double SweepStartFrequency = 20.0;
+const double SweepEndFrequency = 20000.0;
+const double SweepSeconds = 10.0;
+const float SweepLevel = 0.5f;
+
+const float PinkNoiseLevel = 0.5f;
+
+// Drum pattern
+const double BeatsPerMinute = 120.0;
+const double KickBaseFrequency = 50.0;
+const float KickPitchDrop = 100.0f;         // The kick starts this far above its base and glides down
+const double KickDecaySeconds = 0.15;
+const double KickPitchDecaySeconds = 0.03;
+const double ClickDecaySeconds = 0.002;
+const double HatDecaySeconds = 0.02;
+const double BassLineDecaySeconds = 0.3;
+
+// Bass line (one note per beat, A1 A1 C2 G1) and pad chord (A minor)
+const double BassLineNotes[4] = { 55.0, 55.0, 65.41, 49.0 };
+const double PadNotes[3] = { 220.0, 261.63, 329.63 };
+
+// Voice levels
+const float KickOnlyLevel = 0.8f;
+const float KickLevel = 0.5f;
+const float ClickLevel = 0.2f;
+const float BassLineLevel = 0.25f;
+const float PadLevel = 0.05f;
+const float HatLevel = 0.2f;
+const float NoiseBedLevel = 0.04f;
+
+// The clipping scenario drives the mix by 12 dB
+const float ClippingDrive = 4.0f;
+
+// Per-sample factor that decays by 1/e over the given time
+float decayFactor(double seconds, int sampleRate)
+{
+    return static_cast<float>(std::exp(-1.0 / (seconds * sampleRate)));
+}
+
+// Decay an envelope, ending at exactly zero before it reaches the (very slow) denormal range
+inline void decay(float& level, float factor)
+{
+    level *= factor;
+    if (level < 1e-6f) {
+        level = 0.0f;
+    }
+}
+
+} // namespace
+
+const char* getSyntheticScenarioName(SyntheticScenario scenario)
+{
+    switch (scenario) {
+        case SyntheticScenario::Tones: return "tones";
+        case SyntheticScenario::Silence: return "silence";
+        case SyntheticScenario::PinkNoise: return "pink-noise";
+        case SyntheticScenario::LogSweep: return "log-sweep";
+        case SyntheticScenario::Kick: return "kick-120";
+        case SyntheticScenario::DenseMix: return "dense-mix";
+        case SyntheticScenario::Clipping: return "clipping";
+    }
+    return "unknown";
+}
+
+bool parseSyntheticScenario(const std::string& name, SyntheticScenario& scenario)
+{
+    for (SyntheticScenario candidate : AllSyntheticScenarios) {
+        if (name == getSyntheticScenarioName(candidate)) {
+            scenario = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+SyntheticSource::SyntheticSource(SyntheticScenario scenario, uint32_t seed)
+    : m_scenario(scenario)
+    , m_seed(seed)
+    , m_sampleRate(44100)
+    , m_position(0)
+    , m_sweepRatio(1.0)
+    , m_sweepLength(1)
+    , m_noise(seed)
+    , m_kickLevel(0.0f)
+    , m_kickPitch(0.0f)
+    , m_clickLevel(0.0f)
+    , m_hatLevel(0.0f)
+    , m_hatPrevious(0.0f)
+    , m_bassLineLevel(0.0f)
+    , m_beatLength(1)
+    , m_kickDecay(0.0f)
+    , m_kickPitchDecay(0.0f)
+    , m_clickDecay(0.0f)
+    , m_hatDecay(0.0f)
+    , m_bassLineDecay(0.0f)
+    , m_running(false)
+{
+}
+
+SyntheticSource::~SyntheticSource()
+{
+    stop();
+}
+
+bool SyntheticSource::initialize(int sampleRate)
+{
+    m_sampleRate = sampleRate;
+    reset();
+    std::cout << "USING TEST AUDIO DATA - synthetic " << getSyntheticScenarioName(m_scenario)
+              << " signal at " << m_sampleRate << " Hz (seed " << m_seed << ")" << std::endl;
+    return true;
+}
+
+std::string SyntheticSource::getName() const
+{
+    return std::string("synthetic ") + getSyntheticScenarioName(m_scenario) + " test signal";
+}
+
+void SyntheticSource::reset()
+{
+    m_position = 0;
+    m_noise.seed(m_seed);
+
+    m_bass.reset();
+    m_bass.setFrequency(BassFrequency, m_sampleRate);
+    m_mid.reset();
+    m_mid.setFrequency(MidFrequency, m_sampleRate);
+    m_treble.reset();
+    m_treble.setFrequency(TrebleFrequency, m_sampleRate);
+    m_sweep.reset();
+    m_sweep.setFrequency(ToneSweepCentre, m_sampleRate);
+    m_sweepLfo.reset();
+    m_sweepLfo.setFrequency(ToneSweepRate, m_sampleRate);
+
+    // Stop short of Nyquist at low sample rates
+    const double sweepEnd = std::min(SweepEndFrequency, 0.45 * m_sampleRate);
+    m_sweepLength = static_cast<uint64_t>(SweepSeconds * m_sampleRate);
+    m_sweepRatio = std::pow(sweepEnd / SweepStartFrequency, 1.0 / static_cast<double>(m_sweepLength));
+
+    m_beatLength = static_cast<uint64_t>(std::lround(60.0 / BeatsPerMinute * m_sampleRate));
+    m_kick.reset();
+    m_bassLine.reset();
+    m_kickLevel = 0.0f;
+    m_kickPitch = 0.0f;
+    m_clickLevel = 0.0f;
+    m_hatLevel = 0.0f;
+    m_hatPrevious = 0.0f;
+    m_bassLineLevel = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        m_pad[i].reset();
+        m_pad[i].setFrequency(PadNotes[i], m_sampleRate);
+    }
+
+    m_kickDecay = decayFactor(KickDecaySeconds, m_sampleRate);
+    m_kickPitchDecay = decayFactor(KickPitchDecaySeconds, m_sampleRate);
+    m_clickDecay = decayFactor(ClickDecaySeconds, m_sampleRate);
+    m_hatDecay = decayFactor(HatDecaySeconds, m_sampleRate);
+    m_bassLineDecay = decayFactor(BassLineDecaySeconds, m_sampleRate);
+}
+
+void SyntheticSource::generate(float* output, size_t count)
+{
+    switch (m_scenario) {
+        case SyntheticScenario::Tones:
+            generateTones(output, count);
+            break;
+        case SyntheticScenario::Silence:
+            std::fill(output, output + count, 0.0f);
+            m_position += count;
+            break;
+        case SyntheticScenario::PinkNoise:
+            for (size_t i = 0; i < count; i++) {
+                output[i] = PinkNoiseLevel * m_noise.pink();
+            }
+            m_position += count;
+            break;
+        case SyntheticScenario::LogSweep:
+            generateSweep(output, count);
+            break;
+        case SyntheticScenario::Kick:
+            generateMix(output, count, true, 1.0f);
+            break;
+        case SyntheticScenario::DenseMix:
+            generateMix(output, count, false, 1.0f);
+            break;
+        case SyntheticScenario::Clipping:
+            generateMix(output, count, false, ClippingDrive);
+            break;
+    }
+}
+
+void SyntheticSource::generateTones(float* output, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        const float bassSignal = 0.8f * m_bass.next();
+        const float midSignal = 0.6f * m_mid.next();
+        const float trebleSignal = 0.4f * m_treble.next();
+        const float sweepSignal = 0.5f * m_sweep.next();
+
+        // Scale the mix back into [-1, 1]
+        output[i] = (bassSignal + midSignal + trebleSignal + sweepSignal) / 2.3f;
+
+        m_sweep.setFrequency(ToneSweepCentre * (1.0 + m_sweepLfo.next()), m_sampleRate);
+    }
+    m_position += count;
+}
+
+void SyntheticSource::generateSweep(float* output, size_t count)
+{
+    uint64_t sweepSample = m_position % m_sweepLength;
+    for (size_t i = 0; i < count; i++) {
+        if (sweepSample == 0) {
+            m_sweep.reset();
+            m_sweep.setFrequency(SweepStartFrequency, m_sampleRate);
+        }
+        output[i] = SweepLevel * m_sweep.next();
+        m_sweep.scaleFrequency(m_sweepRatio);
+        if (++sweepSample == m_sweepLength) {
+            sweepSample = 0;
+        }
+    }
+    m_position += count;
+}
+
+void SyntheticSource::generateMix(float* output, size_t count, bool kickOnly, float drive)
+{
+    uint64_t beat = m_position / m_beatLength;
+    uint64_t beatSample = m_position % m_beatLength;
+    for (size_t i = 0; i < count; i++) {
+        // Kick and bass note on the beat, hats on the off-beat
+        if (beatSample == 0) {
+            m_kick.reset();
+            m_kick.setFrequency(KickBaseFrequency + KickPitchDrop, m_sampleRate);
+            m_kickLevel = 1.0f;
+            m_kickPitch = KickPitchDrop;
+            m_clickLevel = 1.0f;
+            m_bassLine.setFrequency(BassLineNotes[beat % 4], m_sampleRate);
+            m_bassLineLevel = 1.0f;
+        } else if (beatSample == m_beatLength / 2) {
+            m_hatLevel = 1.0f;
+        }
+
+        float sample = 0.0f;
+        if (kickOnly) {
+            sample = KickOnlyLevel * nextKick();
+        } else {
+            sample = KickLevel * nextKick();
+            sample += BassLineLevel * m_bassLineLevel * m_bassLine.next();
+            decay(m_bassLineLevel, m_bassLineDecay);
+            sample += PadLevel * (m_pad[0].next() + m_pad[1].next() + m_pad[2].next());
+            sample += HatLevel * nextHat();
+            sample += NoiseBedLevel * m_noise.pink();
+        }
+
+        output[i] = std::max(-1.0f, std::min(1.0f, sample * drive));
+        if (++beatSample == m_beatLength) {
+            beatSample = 0;
+            beat++;
+        }
+    }
+    m_position += count;
+}
+
+float SyntheticSource::nextKick()
+{
+    // A sine gliding down to its base pitch, with a short noise click on the attack
+    const float body = m_kickLevel * m_kick.next();
+    const float click = ClickLevel * m_clickLevel * m_noise.white();
+    m_kick.setFrequency(KickBaseFrequency + m_kickPitch, m_sampleRate);
+    decay(m_kickLevel, m_kickDecay);
+    decay(m_kickPitch, m_kickPitchDecay);
+    decay(m_clickLevel, m_clickDecay);
+    return body + click;
+}
+
+float SyntheticSource::nextHat()
+{
+    // First difference of white noise leaves mostly the top octaves
+    const float noise = m_noise.white();
+    const float hat = 0.5f * (noise - m_hatPrevious) * m_hatLevel;
+    m_hatPrevious = noise;
+    decay(m_hatLevel, m_hatDecay);
+    return hat;
+}
+
+bool SyntheticSource::start(RingBuffer& ring)
+{
+    m_running = true;
+    m_thread = std::thread(&SyntheticSource::generateLoop, this, &ring);
+    return true;
+}
+
+void SyntheticSource::stop()
+{
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void SyntheticSource::generateLoop(RingBuffer* ring)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point startTime = Clock::now();
+    uint64_t framesDelivered = 0;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        // Generate straight into the ring, then spread each sample to both channels
+        // (back to front, so the expansion can happen in place)
+        ring->writeWith(2 * GeneratorBlockFrames, [this](float* dest, size_t, size_t n) {
+            const size_t frames = n / 2;
+            generate(dest, frames);
+            for (size_t i = frames; i-- > 0;) {
+                dest[2 * i] = dest[2 * i + 1] = dest[i];
+            }
+        });
+        framesDelivered += GeneratorBlockFrames;
+
+        // Pace delivery to the sample rate
+        std::this_thread::sleep_until(startTime + std::chrono::microseconds(
+            framesDelivered * 1000000 / static_cast<uint64_t>(m_sampleRate)));
+    }
+}
+
+} // namespace av
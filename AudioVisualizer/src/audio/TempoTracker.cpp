@@ -0,0 +1,186 @@
+#include "audio/TempoTracker.h"
+#include "audio/FFTPlan.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// Log-Gaussian tempo prior centred on 120 BPM, one octave wide
+const float PreferredBpm = 120.0f;
+const float PriorOctaves = 1.0f;
+
+// How often the tempo is re-estimated
+const float UpdateSeconds = 0.25f;
+
+// Smoothing of successive tempo estimates
+const float BpmSmoothing = 0.8f;
+
+// Onsets within this fraction of a beat of phase 0 pull the phase by this gain
+const float PhaseCaptureWindow = 0.25f;
+const float PhaseCorrectionGain = 0.3f;
+
+} // namespace
+
+TempoTracker::TempoTracker()
+    : m_frameRate(0.0f)
+    , m_writePosition(0)
+    , m_framesSeen(0)
+    , m_minLag(1)
+    , m_maxLag(1)
+    , m_updateInterval(1)
+    , m_framesUntilUpdate(0)
+    , m_bpm(0.0f)
+    , m_phase(0.0f)
+    , m_confidence(0.0f)
+{
+}
+
+bool TempoTracker::initialize(float frameRate, float windowSeconds, float minBpm, float maxBpm)
+{
+    if (frameRate <= 0.0f || minBpm <= 0.0f || maxBpm <= minBpm) {
+        std::cerr << "Invalid tempo tracker parameters" << std::endl;
+        return false;
+    }
+
+    m_frameRate = frameRate;
+    const int length = FFTPlan::nextPowerOfTwo(static_cast<int>(windowSeconds * frameRate));
+    m_novelty.assign(length, 0.0f);
+
+    // Zero-padding to twice the length makes the circular autocorrelation linear
+    if (!m_fft.initialize(length * 2)) {
+        return false;
+    }
+    m_fftInput.assign(length * 2, 0.0f);
+    m_autocorrelation.assign(length + 1, 0.0f);
+
+    // Lags (in frames) for the tempo range; need at least two periods in the window
+    m_minLag = std::max(1, static_cast<int>(std::floor(60.0f * frameRate / maxBpm)));
+    m_maxLag = std::min(length / 2, static_cast<int>(std::ceil(60.0f * frameRate / minBpm)));
+    m_lagWeights.assign(m_maxLag + 1, 0.0f);
+    for (int lag = m_minLag; lag <= m_maxLag; lag++) {
+        const float octaves = std::log2(60.0f * frameRate / lag / PreferredBpm) / PriorOctaves;
+        m_lagWeights[lag] = std::exp(-0.5f * octaves * octaves);
+    }
+
+    m_updateInterval = std::max(1, static_cast<int>(UpdateSeconds * frameRate));
+    reset();
+    return true;
+}
+
+void TempoTracker::reset()
+{
+    std::fill(m_novelty.begin(), m_novelty.end(), 0.0f);
+    m_writePosition = 0;
+    m_framesSeen = 0;
+    m_framesUntilUpdate = m_updateInterval;
+    m_bpm = 0.0f;
+    m_phase = 0.0f;
+    m_confidence = 0.0f;
+}
+
+void TempoTracker::process(float novelty, bool onset)
+{
+    const int length = static_cast<int>(m_novelty.size());
+    m_novelty[m_writePosition] = novelty;
+    m_writePosition = (m_writePosition + 1) & (length - 1);
+    m_framesSeen++;
+
+    // Re-estimate once half the window is filled, then periodically
+    if (--m_framesUntilUpdate <= 0 && m_framesSeen >= length / 2) {
+        estimateTempo();
+        m_framesUntilUpdate = m_updateInterval;
+    }
+
+    if (m_bpm <= 0.0f) {
+        return;
+    }
+
+    // Advance the beat clock and pull it towards onsets near an expected beat
+    m_phase += m_bpm / 60.0f / m_frameRate;
+    m_phase -= std::floor(m_phase);
+
+    if (onset) {
+        const float error = (m_phase < 0.5f) ? m_phase : m_phase - 1.0f;
+        if (std::fabs(error) < PhaseCaptureWindow) {
+            m_phase -= PhaseCorrectionGain * error;
+            m_phase -= std::floor(m_phase);
+        }
+    }
+}
+
+void TempoTracker::estimateTempo()
+{
+    const int length = static_cast<int>(m_novelty.size());
+    const int fftSize = length * 2;
+
+    // Unroll the ring in time order, remove the mean, zero-pad
+    float mean = 0.0f;
+    for (float value : m_novelty) {
+        mean += value;
+    }
+    mean /= length;
+    for (int i = 0; i < length; i++) {
+        m_fftInput[i] = m_novelty[(m_writePosition + i) & (length - 1)] - mean;
+    }
+    std::fill(m_fftInput.begin() + length, m_fftInput.end(), 0.0f);
+
+    // Power spectrum
+    m_fft.forward(m_fftInput.data(), false);
+    const float* re = m_fft.getReal();
+    const float* im = m_fft.getImag();
+    for (int k = 0; k <= length; k++) {
+        m_autocorrelation[k] = re[k] * re[k] + im[k] * im[k];
+    }
+
+    // The power spectrum is real and even, so its inverse transform equals a forward
+    // transform of the full symmetric sequence (scaled by 1/N); the result is real
+    m_fftInput[0] = m_autocorrelation[0];
+    for (int k = 1; k < length; k++) {
+        m_fftInput[k] = m_autocorrelation[k];
+        m_fftInput[fftSize - k] = m_autocorrelation[k];
+    }
+    m_fftInput[length] = m_autocorrelation[length];
+    m_fft.forward(m_fftInput.data(), false);
+
+    const float zeroLag = re[0];
+    if (zeroLag <= 0.0f) {
+        m_confidence = 0.0f;
+        return;
+    }
+
+    // Strongest weighted lag in the tempo range
+    int bestLag = 0;
+    float bestScore = 0.0f;
+    for (int lag = m_minLag; lag <= m_maxLag; lag++) {
+        const float score = re[lag] / zeroLag * m_lagWeights[lag];
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0) {
+        m_confidence = 0.0f;
+        return;
+    }
+
+    // Parabolic interpolation for a sub-frame lag
+    float lag = static_cast<float>(bestLag);
+    if (bestLag > m_minLag && bestLag < m_maxLag) {
+        const float before = re[bestLag - 1];
+        const float peak = re[bestLag];
+        const float after = re[bestLag + 1];
+        const float curvature = before - 2.0f * peak + after;
+        if (curvature < 0.0f) {
+            lag += 0.5f * (before - after) / curvature;
+        }
+    }
+
+    const float bpm = 60.0f * m_frameRate / lag;
+    m_bpm = (m_bpm > 0.0f) ? m_bpm * BpmSmoothing + bpm * (1.0f - BpmSmoothing) : bpm;
+    m_confidence = std::min(1.0f, re[bestLag] / zeroLag);
+}
+
+} // namespace av
@@ -0,0 +1,256 @@
+#include "audio/WasapiLoopbackSource.h"
+
+#ifdef _WIN32
+
+#include "audio/RingBuffer.h"
+#include <Functiondiscoverykeys_devpkey.h>
+#include <mmreg.h>
+#include <iostream>
+#include <algorithm>
+
+namespace av {
+
+WasapiLoopbackSource::WasapiLoopbackSource()
+    : m_enumerator(nullptr)
+    , m_device(nullptr)
+    , m_audioClient(nullptr)
+    , m_captureClient(nullptr)
+    , m_waveFormat(nullptr)
+    , m_captureEvent(nullptr)
+    , m_comInitialized(false)
+    , m_started(false)
+    , m_sampleRate(0)
+    , m_channels(0)
+    , m_format(SampleFormat::Int16)
+    , m_running(false)
+{
+}
+
+WasapiLoopbackSource::~WasapiLoopbackSource()
+{
+    stop();
+    release();
+}
+
+bool WasapiLoopbackSource::initialize(int sampleRate)
+{
+    // Loopback runs at the mix format's rate; the preferred rate is ignored
+    HRESULT hr = CoInitialize(nullptr);
+    if (FAILED(hr)) {
+        std::cerr << "Failed to initialize COM library" << std::endl;
+        return false;
+    }
+    m_comInitialized = true;
+    
+    // Create device enumerator
+    hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+                          __uuidof(IMMDeviceEnumerator), 
+                          reinterpret_cast<void**>(&m_enumerator));
+    if (FAILED(hr)) {
+        std::cerr << "Failed to create device enumerator" << std::endl;
+        return false;
+    }
+    
+    // Get default audio render device (speakers/headphones)
+    hr = m_enumerator->GetDefaultAudioEndpoint(eRender, eConsole, &m_device);
+    if (FAILED(hr)) {
+        std::cerr << "Failed to get default audio endpoint" << std::endl;
+        return false;
+    }
+    
+    // Get audio client
+    hr = m_device->Activate(__uuidof(IAudioClient), CLSCTX_ALL,
+                            nullptr, reinterpret_cast<void**>(&m_audioClient));
+    if (FAILED(hr)) {
+        std::cerr << "Failed to activate audio client" << std::endl;
+        return false;
+    }
+    
+    // Get the mix format
+    hr = m_audioClient->GetMixFormat(&m_waveFormat);
+    if (FAILED(hr)) {
+        std::cerr << "Failed to get mix format" << std::endl;
+        return false;
+    }
+    
+    // Map the mix format onto a sample format. Shared-mode mix formats are usually
+    // WAVE_FORMAT_EXTENSIBLE, which carries the real format tag in the first field of
+    // the sub-format GUID (KSDATAFORMAT_SUBTYPE_IEEE_FLOAT for float).
+    WORD formatTag = m_waveFormat->wFormatTag;
+    if (formatTag == WAVE_FORMAT_EXTENSIBLE && m_waveFormat->cbSize >= 22) {
+        formatTag = static_cast<WORD>(reinterpret_cast<const WAVEFORMATEXTENSIBLE*>(m_waveFormat)->SubFormat.Data1);
+    }
+    const UINT32 bytesPerSample = m_waveFormat->wBitsPerSample / 8;
+    if (bytesPerSample == 2) {
+        m_format = SampleFormat::Int16;
+    } else if (bytesPerSample == 3) {
+        m_format = SampleFormat::Int24;
+    } else if (bytesPerSample == 4) {
+        m_format = (formatTag == WAVE_FORMAT_IEEE_FLOAT) ? SampleFormat::Float32 : SampleFormat::Int32;
+    } else {
+        std::cerr << "Unsupported mix format with " << m_waveFormat->wBitsPerSample << " bits per sample" << std::endl;
+        return false;
+    }
+    m_sampleRate = m_waveFormat->nSamplesPerSec;
+    m_channels = m_waveFormat->nChannels;
+    if (m_channels <= 0 || m_channels > MaxSampleChannels) {
+        std::cerr << "Unsupported mix format with " << m_channels << " channels" << std::endl;
+        return false;
+    }
+    
+    // Create event for audio capture
+    m_captureEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (m_captureEvent == nullptr) {
+        std::cerr << "Failed to create capture event" << std::endl;
+        return false;
+    }
+    
+    // Initialize the audio client for loopback capture
+    hr = m_audioClient->Initialize(
+        AUDCLNT_SHAREMODE_SHARED,
+        AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+        0, 0, m_waveFormat, nullptr);
+    if (FAILED(hr)) {
+        std::cerr << "Failed to initialize audio client for loopback" << std::endl;
+        return false;
+    }
+    
+    // Set the event handle
+    hr = m_audioClient->SetEventHandle(m_captureEvent);
+    if (FAILED(hr)) {
+        std::cerr << "Failed to set event handle" << std::endl;
+        return false;
+    }
+    
+    // Get the capture client
+    hr = m_audioClient->GetService(__uuidof(IAudioCaptureClient),
+                                   reinterpret_cast<void**>(&m_captureClient));
+    if (FAILED(hr)) {
+        std::cerr << "Failed to get capture client" << std::endl;
+        return false;
+    }
+    
+    std::cout << "WASAPI loopback capture initialized successfully" << std::endl;
+    std::cout << "Capturing at sample rate: " << m_sampleRate << " Hz" << std::endl;
+    std::cout << "Channels: " << m_channels << std::endl;
+    std::cout << "Sample format: " << getSampleFormatName(m_format) << std::endl;
+    return true;
+}
+
+bool WasapiLoopbackSource::start(RingBuffer& ring)
+{
+    if (m_captureClient == nullptr) {
+        return false;
+    }
+    
+    // Start the capture
+    HRESULT hr = m_audioClient->Start();
+    if (FAILED(hr)) {
+        std::cerr << "Failed to start audio capture" << std::endl;
+        return false;
+    }
+    m_started = true;
+    
+    // Capture runs on its own thread so samples keep flowing when a frame runs long
+    m_running = true;
+    m_thread = std::thread(&WasapiLoopbackSource::captureLoop, this, &ring);
+    return true;
+}
+
+void WasapiLoopbackSource::stop()
+{
+    // Stop the capture thread before stopping the client it uses
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    
+    if (m_started) {
+        m_audioClient->Stop();
+        m_started = false;
+    }
+}
+
+void WasapiLoopbackSource::release()
+{
+    // Release WASAPI resources
+    if (m_captureClient) {
+        m_captureClient->Release();
+        m_captureClient = nullptr;
+    }
+    
+    if (m_audioClient) {
+        m_audioClient->Release();
+        m_audioClient = nullptr;
+    }
+    
+    if (m_waveFormat) {
+        CoTaskMemFree(m_waveFormat);
+        m_waveFormat = nullptr;
+    }
+    
+    if (m_device) {
+        m_device->Release();
+        m_device = nullptr;
+    }
+    
+    if (m_enumerator) {
+        m_enumerator->Release();
+        m_enumerator = nullptr;
+    }
+    
+    if (m_captureEvent) {
+        CloseHandle(m_captureEvent);
+        m_captureEvent = nullptr;
+    }
+    
+    if (m_comInitialized) {
+        CoUninitialize();
+        m_comInitialized = false;
+    }
+}
+
+void WasapiLoopbackSource::captureLoop(RingBuffer* ring)
+{
+    CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    
+    const size_t frameBytes = static_cast<size_t>(m_channels) * getBytesPerSample(m_format);
+    
+    while (m_running.load(std::memory_order_relaxed)) {
+        // Wait for capture event (with a timeout so stop() is noticed)
+        WaitForSingleObject(m_captureEvent, 100);
+        
+        // Drain every packet that is ready
+        UINT32 packetLength = 0;
+        while (SUCCEEDED(m_captureClient->GetNextPacketSize(&packetLength)) && packetLength > 0) {
+            BYTE* pData;
+            UINT32 numFramesAvailable;
+            DWORD flags;
+            
+            if (FAILED(m_captureClient->GetBuffer(&pData, &numFramesAvailable, &flags, nullptr, nullptr))) {
+                break;
+            }
+            
+            // Convert straight from the packet into the ring, keeping left and right apart
+            const size_t numSamples = 2 * static_cast<size_t>(numFramesAvailable);
+            if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
+                ring->writeWith(numSamples, [](float* dest, size_t, size_t n) {
+                    std::fill(dest, dest + n, 0.0f);
+                });
+            } else {
+                ring->writeWith(numSamples, [&](float* dest, size_t offset, size_t n) {
+                    convertToStereo(pData + offset / 2 * frameBytes, m_format, m_channels, n / 2, dest);
+                });
+            }
+            
+            // Release the buffer
+            m_captureClient->ReleaseBuffer(numFramesAvailable);
+        }
+    }
+    
+    CoUninitialize();
+}
+
+} // namespace av
+
+#endif // _WIN32
@@ -0,0 +1,203 @@
+#include "audio/WavFileSource.h"
+#include "audio/RingBuffer.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+namespace av {
+
+namespace {
+
+// WAV format tags
+const uint16_t WaveFormatPCM = 0x0001;
+const uint16_t WaveFormatIEEEFloat = 0x0003;
+const uint16_t WaveFormatExtensible = 0xFFFE;
+
+// Frames delivered per block while playing
+const size_t PlaybackBlockFrames = 256;
+
+uint16_t readU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t readU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+
+} // namespace
+
+WavFileSource::WavFileSource(const std::string& path, bool loop)
+    : m_path(path)
+    , m_loop(loop)
+    , m_sampleRate(0)
+    , m_channels(0)
+    , m_format(SampleFormat::Int16)
+    , m_samples(nullptr)
+    , m_frameCount(0)
+    , m_running(false)
+{
+}
+
+WavFileSource::~WavFileSource()
+{
+    stop();
+}
+
+std::string WavFileSource::getName() const
+{
+    return "WAV file " + m_path;
+}
+
+bool WavFileSource::initialize(int /*sampleRate*/)
+{
+    // The file decides the rate; the preferred rate is ignored
+    if (!m_file.open(m_path)) {
+        return false;
+    }
+
+    if (!parseHeader()) {
+        m_file.close();
+        return false;
+    }
+
+    std::cout << "WAV file " << m_path << ": " << m_sampleRate << " Hz, " << m_channels
+              << " channels, " << getSampleFormatName(m_format) << ", "
+              << static_cast<double>(m_frameCount) / m_sampleRate << " s" << std::endl;
+    return true;
+}
+
+bool WavFileSource::parseHeader()
+{
+    const uint8_t* data = m_file.getData();
+    const size_t size = m_file.getSize();
+
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        std::cerr << m_path << " is not a RIFF/WAVE file" << std::endl;
+        return false;
+    }
+
+    bool haveFormat = false;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const uint8_t* chunk = data + offset;
+        const uint32_t chunkSize = readU32(chunk + 4);
+        const size_t bodySize = std::min<size_t>(chunkSize, size - offset - 8);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && bodySize >= 16) {
+            uint16_t formatTag = readU16(chunk + 8);
+            m_channels = readU16(chunk + 10);
+            m_sampleRate = static_cast<int>(readU32(chunk + 12));
+            const uint16_t bitsPerSample = readU16(chunk + 22);
+
+            // Extensible headers carry the real format in the first two bytes of the sub-format GUID
+            if (formatTag == WaveFormatExtensible && bodySize >= 40) {
+                formatTag = readU16(chunk + 8 + 24);
+            }
+
+            if (formatTag == WaveFormatPCM && bitsPerSample == 16) {
+                m_format = SampleFormat::Int16;
+            } else if (formatTag == WaveFormatPCM && bitsPerSample == 24) {
+                m_format = SampleFormat::Int24;
+            } else if (formatTag == WaveFormatPCM && bitsPerSample == 32) {
+                m_format = SampleFormat::Int32;
+            } else if (formatTag == WaveFormatIEEEFloat && bitsPerSample == 32) {
+                m_format = SampleFormat::Float32;
+            } else {
+                std::cerr << m_path << ": unsupported WAV format " << formatTag
+                          << " with " << bitsPerSample << " bits per sample" << std::endl;
+                return false;
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat || m_channels <= 0 || m_sampleRate <= 0) {
+                std::cerr << m_path << ": data chunk before a valid fmt chunk" << std::endl;
+                return false;
+            }
+            if (m_channels > MaxSampleChannels) {
+                std::cerr << m_path << ": " << m_channels << " channels, at most " << MaxSampleChannels
+                          << " are supported" << std::endl;
+                return false;
+            }
+            m_samples = chunk + 8;
+            m_frameCount = bodySize / (static_cast<size_t>(m_channels) * getBytesPerSample(m_format));
+            return m_frameCount > 0;
+        }
+
+        // Chunks are padded to an even size
+        offset += 8 + static_cast<size_t>(chunkSize) + (chunkSize & 1);
+    }
+
+    std::cerr << m_path << ": no data chunk found" << std::endl;
+    return false;
+}
+
+size_t WavFileSource::readMono(size_t firstFrame, size_t count, float* output) const
+{
+    if (firstFrame >= m_frameCount) {
+        return 0;
+    }
+    count = std::min(count, m_frameCount - firstFrame);
+
+    const size_t frameBytes = static_cast<size_t>(m_channels) * getBytesPerSample(m_format);
+    convertToMono(m_samples + firstFrame * frameBytes, m_format, m_channels, count, output);
+    return count;
+}
+
+size_t WavFileSource::readStereo(size_t firstFrame, size_t count, float* output) const
+{
+    if (firstFrame >= m_frameCount) {
+        return 0;
+    }
+    count = std::min(count, m_frameCount - firstFrame);
+
+    const size_t frameBytes = static_cast<size_t>(m_channels) * getBytesPerSample(m_format);
+    convertToStereo(m_samples + firstFrame * frameBytes, m_format, m_channels, count, output);
+    return count;
+}
+
+bool WavFileSource::start(RingBuffer& ring)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&WavFileSource::playbackLoop, this, &ring);
+    return true;
+}
+
+void WavFileSource::stop()
+{
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void WavFileSource::playbackLoop(RingBuffer* ring)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point startTime = Clock::now();
+    size_t position = 0;
+    uint64_t framesDelivered = 0;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (position >= m_frameCount) {
+            if (!m_loop) {
+                break;
+            }
+            position = 0;
+        }
+
+        // Decode straight from the mapping into the ring
+        const size_t blockFrames = std::min(PlaybackBlockFrames, m_frameCount - position);
+        ring->writeWith(2 * blockFrames, [&](float* dest, size_t offset, size_t n) {
+            readStereo(position + offset / 2, n / 2, dest);
+        });
+        position += blockFrames;
+        framesDelivered += blockFrames;
+
+        // Pace delivery to the file's sample rate
+        std::this_thread::sleep_until(startTime + std::chrono::microseconds(
+            framesDelivered * 1000000 / static_cast<uint64_t>(m_sampleRate)));
+    }
+}
+
+} // namespace av
@@ -0,0 +1,1151 @@
+// Audio analysis benchmark
+// Reports the cost of the analysis building blocks on this machine.
+// Runs without SDL/OpenGL so it can be used on headless render nodes.
+
+#include "audio/FFTPlan.h"
+#include "audio/FFTKernels.h"
+#include "audio/SampleKernels.h"
+#include "audio/RealFFT.h"
+#include "audio/Filterbank.h"
+#include "audio/MultiResolutionSpectrum.h"
+#include "audio/DecimationChain.h"
+#include "audio/SlidingWindow.h"
+#include "audio/CrossoverFilterBank.h"
+#include "audio/GoertzelBank.h"
+#include "audio/SlidingDFT.h"
+#include "audio/FeatureExtractor.h"
+#include "audio/StereoAnalyzer.h"
+#include "audio/PitchDetector.h"
+#include "audio/Chromagram.h"
+#include "audio/KeyEstimator.h"
+#include "audio/LoudnessMeter.h"
+#include "audio/QuantileSketch.h"
+#include "audio/AudioDataLog.h"
+#include "audio/SyntheticSource.h"
+#include "audio/OnsetDetector.h"
+#include "audio/TempoTracker.h"
+#include "FFTAnalyzer.h"
+#include "AudioProcessor.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <complex>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+using namespace av;
+
+namespace {
+
+// Run fn repeatedly for at least minSeconds and return the mean time per call in ns
+template<typename Fn>
+double measureNs(Fn&& fn, double minSeconds = 0.2)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and the CPU clock
+    for (int i = 0; i < 10; i++) {
+        fn();
+    }
+
+    long long iterations = 0;
+    const Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int i = 0; i < 16; i++) {
+            fn();
+        }
+        iterations += 16;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+
+    return elapsed * 1e9 / static_cast<double>(iterations);
+}
+
+void benchmarkFFT()
+{
+    std::vector<const FFTKernels*> kernelSets = { &FFTKernels::scalar() };
+    if (FFTKernels::sse2()) kernelSets.push_back(FFTKernels::sse2());
+    if (FFTKernels::avx2()) kernelSets.push_back(FFTKernels::avx2());
+
+    std::cout << "FFT kernels (runtime selection: " << FFTKernels::best().name << ")" << std::endl;
+    std::cout << std::setw(8) << "size" << std::setw(10) << "kernel"
+              << std::setw(14) << "complex ns" << std::setw(14) << "real ns"
+              << std::setw(12) << "max error" << std::endl;
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for (int size = 512; size <= 16384; size *= 2) {
+        std::shared_ptr<const FFTPlan> plan = FFTPlan::get(size);
+
+        std::vector<std::complex<float>> input(size);
+        for (auto& value : input) {
+            value = std::complex<float>(dist(random), dist(random));
+        }
+
+        // Interleaved scalar transform is the reference for correctness and speed
+        std::vector<std::complex<float>> reference = input;
+        plan->forward(reference.data());
+        std::vector<std::complex<float>> work(size);
+        const double referenceNs = measureNs([&]() {
+            work = input;
+            plan->forward(work.data());
+        });
+        std::cout << std::setw(8) << size << std::setw(10) << "reference"
+                  << std::setw(14) << std::fixed << std::setprecision(0) << referenceNs
+                  << std::setw(14) << "-" << std::setw(12) << "-" << std::endl;
+
+        std::vector<float> re(size), im(size);
+        std::vector<float> realInput(size);
+        for (int i = 0; i < size; i++) {
+            realInput[i] = input[i].real();
+        }
+        RealFFT realFFT;
+        realFFT.initialize(size);
+
+        for (const FFTKernels* kernels : kernelSets) {
+            auto load = [&]() {
+                for (int i = 0; i < size; i++) {
+                    re[i] = input[i].real();
+                    im[i] = input[i].imag();
+                }
+            };
+
+            load();
+            plan->forward(re.data(), im.data(), *kernels);
+            double maxError = 0.0;
+            for (int i = 0; i < size; i++) {
+                maxError = std::max(maxError, static_cast<double>(
+                    std::abs(std::complex<float>(re[i], im[i]) - reference[i])));
+            }
+
+            const double complexNs = measureNs([&]() {
+                load();
+                plan->forward(re.data(), im.data(), *kernels);
+            });
+
+            // The real transform always uses the runtime selection, so only time it once
+            std::string realNs = "-";
+            if (kernels == &FFTKernels::best()) {
+                std::ostringstream stream;
+                stream << std::fixed << std::setprecision(0)
+                       << measureNs([&]() { realFFT.forward(realInput.data()); });
+                realNs = stream.str();
+            }
+
+            std::cout << std::setw(8) << size << std::setw(10) << kernels->name
+                      << std::setw(14) << std::fixed << std::setprecision(0) << complexNs
+                      << std::setw(14) << realNs
+                      << std::setw(12) << std::scientific << std::setprecision(1) << maxError
+                      << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+// Check the selected sample kernels against the scalar reference and time both;
+// false if any kernel disagrees
+bool benchmarkSampleKernels()
+{
+    const SampleKernels& reference = SampleKernels::scalar();
+    const SampleKernels& kernels = SampleKernels::best();
+    // Not a multiple of the vector width, so every kernel's scalar tail runs too
+    const size_t frames = 4093;
+
+    std::cout << "Sample kernels (runtime selection: " << kernels.name << "), " << frames << " frames" << std::endl;
+    std::cout << std::setw(20) << "kernel" << std::setw(12) << "scalar ns" << std::setw(12) << "best ns"
+              << std::setw(12) << "ns/sample" << std::setw(12) << "max error" << std::endl;
+
+    std::mt19937 random(25);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    bool ok = true;
+
+    // Decoding is exact and planes are only moved around, so those must match bit for bit;
+    // the matrix mix is allowed rounding differences
+    auto report = [&](const std::string& name, size_t samples, const std::vector<float>& expected,
+                      const std::vector<float>& actual, double tolerance,
+                      const std::function<void()>& runReference, const std::function<void()>& runBest) {
+        double maxError = 0.0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            maxError = std::max(maxError, static_cast<double>(std::abs(expected[i] - actual[i])));
+        }
+        const bool match = (maxError <= tolerance);
+        ok = ok && match;
+        const double referenceNs = measureNs(runReference);
+        const double bestNs = measureNs(runBest);
+        std::cout << std::setw(20) << name
+                  << std::setw(12) << std::fixed << std::setprecision(0) << referenceNs
+                  << std::setw(12) << bestNs
+                  << std::setw(12) << std::setprecision(2) << bestNs / samples
+                  << std::setw(12) << std::scientific << std::setprecision(1) << maxError
+                  << (match ? "" : "  MISMATCH") << std::defaultfloat << std::endl;
+    };
+
+    // Decoders, on 2-channel frames of random bytes (random floats for f32)
+    const SampleFormat formats[] = { SampleFormat::Int16, SampleFormat::Int24, SampleFormat::Int32, SampleFormat::Float32 };
+    for (SampleFormat format : formats) {
+        const size_t samples = 2 * frames;
+        std::vector<uint8_t> bytes(samples * getBytesPerSample(format));
+        if (format == SampleFormat::Float32) {
+            std::vector<float> values(samples);
+            for (float& value : values) {
+                value = dist(random);
+            }
+            std::memcpy(bytes.data(), values.data(), bytes.size());
+        } else {
+            for (uint8_t& byte : bytes) {
+                byte = static_cast<uint8_t>(byteDist(random));
+            }
+        }
+
+        std::vector<float> expected(samples);
+        std::vector<float> actual(samples);
+        const SampleKernels::Decode decodeReference = reference.getDecoder(format);
+        const SampleKernels::Decode decode = kernels.getDecoder(format);
+        decodeReference(bytes.data(), samples, expected.data());
+        decode(bytes.data(), samples, actual.data());
+        report(std::string("decode ") + getSampleFormatName(format), samples, expected, actual, 0.0,
+               [&]() { decodeReference(bytes.data(), samples, expected.data()); },
+               [&]() { decode(bytes.data(), samples, actual.data()); });
+    }
+
+    for (int channels : { 2, 6, 8 }) {
+        const size_t samples = frames * channels;
+        std::vector<float> interleaved(samples);
+        for (float& value : interleaved) {
+            value = dist(random);
+        }
+
+        std::vector<float> expected(samples);
+        std::vector<float> actual(samples);
+        std::vector<float*> expectedPlanes(channels);
+        std::vector<float*> actualPlanes(channels);
+        for (int channel = 0; channel < channels; channel++) {
+            expectedPlanes[channel] = expected.data() + channel * frames;
+            actualPlanes[channel] = actual.data() + channel * frames;
+        }
+        reference.deinterleave(interleaved.data(), channels, frames, expectedPlanes.data());
+        kernels.deinterleave(interleaved.data(), channels, frames, actualPlanes.data());
+        report("deinterleave " + std::to_string(channels) + "ch", samples, expected, actual, 0.0,
+               [&]() { reference.deinterleave(interleaved.data(), channels, frames, expectedPlanes.data()); },
+               [&]() { kernels.deinterleave(interleaved.data(), channels, frames, actualPlanes.data()); });
+
+        // Fold down with a random matrix: stereo to one channel like readHop's mid, more channels to stereo
+        const int outputs = (channels == 2) ? 1 : 2;
+        const std::vector<float> planar = expected;
+        std::vector<const float*> planes(channels);
+        for (int channel = 0; channel < channels; channel++) {
+            planes[channel] = planar.data() + channel * frames;
+        }
+        std::vector<float> matrix(outputs * channels);
+        for (float& weight : matrix) {
+            weight = dist(random);
+        }
+        std::vector<float> expectedMix(outputs * frames);
+        std::vector<float> actualMix(outputs * frames);
+        float* expectedSides[2] = { expectedMix.data(), expectedMix.data() + (outputs - 1) * frames };
+        float* actualSides[2] = { actualMix.data(), actualMix.data() + (outputs - 1) * frames };
+        reference.downmix(planes.data(), channels, frames, matrix.data(), outputs, expectedSides);
+        kernels.downmix(planes.data(), channels, frames, matrix.data(), outputs, actualSides);
+        report("downmix " + std::to_string(channels) + "->" + std::to_string(outputs), samples,
+               expectedMix, actualMix, 1e-6,
+               [&]() { reference.downmix(planes.data(), channels, frames, matrix.data(), outputs, expectedSides); },
+               [&]() { kernels.downmix(planes.data(), channels, frames, matrix.data(), outputs, actualSides); });
+    }
+
+    {
+        std::vector<float> left(frames);
+        std::vector<float> right(frames);
+        for (size_t i = 0; i < frames; i++) {
+            left[i] = dist(random);
+            right[i] = dist(random);
+        }
+        const float* planes[2] = { left.data(), right.data() };
+        std::vector<float> expected(2 * frames);
+        std::vector<float> actual(2 * frames);
+        reference.interleave(planes, 2, frames, expected.data());
+        kernels.interleave(planes, 2, frames, actual.data());
+        report("interleave 2ch", 2 * frames, expected, actual, 0.0,
+               [&]() { reference.interleave(planes, 2, frames, expected.data()); },
+               [&]() { kernels.interleave(planes, 2, frames, actual.data()); });
+    }
+
+    // What the sources run per packet: 7.1 int24 capture folded to stereo
+    {
+        const int channels = 8;
+        std::vector<uint8_t> bytes(frames * channels * 3);
+        for (uint8_t& byte : bytes) {
+            byte = static_cast<uint8_t>(byteDist(random));
+        }
+        std::vector<float> output(2 * frames);
+        const double stereoNs = measureNs([&]() {
+            convertToStereo(bytes.data(), SampleFormat::Int24, channels, frames, output.data());
+        });
+        std::cout << "  convertToStereo s24 8ch: " << std::fixed << std::setprecision(2)
+                  << stereoNs / (frames * channels) << " ns/sample" << std::defaultfloat << std::endl;
+    }
+
+    std::cout << std::endl;
+    return ok;
+}
+
+void benchmarkSTFT()
+{
+    std::cout << "Streaming STFT (cost per hop, fed in 256-sample blocks)" << std::endl;
+    std::cout << std::setw(8) << "size" << std::setw(10) << "overlap"
+              << std::setw(14) << "hop ns" << std::setw(14) << "fft ns" << std::endl;
+
+    const int sampleRate = 48000;
+    const int blockSize = 256;
+    std::mt19937 random(99);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    const FFTAnalyzer::Overlap overlaps[] = {
+        FFTAnalyzer::Overlap::Half, FFTAnalyzer::Overlap::ThreeQuarters, FFTAnalyzer::Overlap::SevenEighths
+    };
+    const char* overlapNames[] = { "50%", "75%", "87.5%" };
+
+    for (int size = 1024; size <= 8192; size *= 2) {
+        // Transform alone, for comparison
+        RealFFT realFFT;
+        realFFT.initialize(size);
+        std::vector<float> frame(size);
+        for (float& value : frame) {
+            value = dist(random);
+        }
+        const double fftNs = measureNs([&]() { realFFT.forward(frame.data()); });
+
+        for (int i = 0; i < 3; i++) {
+            FFTAnalyzer analyzer;
+            analyzer.initialize(sampleRate, size, overlaps[i]);
+
+            std::vector<float> block(blockSize);
+            for (float& value : block) {
+                value = dist(random);
+            }
+
+            const double blockNs = measureNs([&]() { analyzer.processAudioBuffer(block.data(), blockSize); });
+            const double hopNs = blockNs * analyzer.getHopSize() / blockSize;
+
+            std::cout << std::setw(8) << size << std::setw(10) << overlapNames[i]
+                      << std::setw(14) << std::fixed << std::setprecision(0) << hopNs
+                      << std::setw(14) << fftNs << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkSlidingDFT()
+{
+    std::cout << "Sliding DFT (1024-point Hann bins at 48 kHz, fed in 64-sample blocks)" << std::endl;
+    std::cout << std::setw(8) << "bins" << std::setw(10) << "tracked"
+              << std::setw(14) << "block ns" << std::setw(14) << "per 512 ns" << std::endl;
+
+    const int sampleRate = 48000;
+    const int size = 1024;
+    const int blockSize = 64;
+    std::mt19937 random(15);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> block(blockSize);
+    for (float& value : block) {
+        value = dist(random);
+    }
+
+    // Bins spread log-style from bass to treble, as band centres would be
+    for (int numBins : { 4, 8, 16, 32 }) {
+        std::vector<int> bins;
+        for (int i = 0; i < numBins; i++) {
+            const float frequency = 40.0f * std::pow(400.0f, static_cast<float>(i) / numBins);
+            bins.push_back(std::max(1, std::min(size / 2 - 1, static_cast<int>(frequency * size / sampleRate))));
+        }
+
+        FFTAnalyzer analyzer;
+        analyzer.initializeSliding(sampleRate, size, bins);
+        const double blockNs = measureNs([&]() { analyzer.processAudioBuffer(block.data(), blockSize); });
+
+        SlidingDFT sliding;
+        sliding.initialize(size, bins);
+        std::cout << std::setw(8) << numBins << std::setw(10) << sliding.getNumTrackedBins()
+                  << std::setw(14) << std::fixed << std::setprecision(0) << blockNs
+                  << std::setw(14) << blockNs * 512 / blockSize << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkFilterbank()
+{
+    std::cout << "Filterbank (2048-point spectrum at 48 kHz)" << std::endl;
+    std::cout << std::setw(14) << "scale" << std::setw(8) << "bands"
+              << std::setw(10) << "weights" << std::setw(14) << "apply ns" << std::endl;
+
+    const FilterbankScale scales[] = { FilterbankScale::Log, FilterbankScale::Mel, FilterbankScale::ThirdOctave };
+    const char* scaleNames[] = { "log", "mel", "1/3 octave" };
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> spectrum(2048 / 2 + 1);
+    for (float& value : spectrum) {
+        value = dist(random);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        for (int numBands : { 32, 64 }) {
+            Filterbank filterbank;
+            filterbank.initialize(scales[i], numBands, 2048, 48000);
+            std::vector<float> bands(filterbank.getNumBands());
+
+            const double applyNs = measureNs([&]() { filterbank.apply(spectrum.data(), bands.data()); });
+            std::cout << std::setw(14) << scaleNames[i] << std::setw(8) << filterbank.getNumBands()
+                      << std::setw(10) << filterbank.getNumWeights()
+                      << std::setw(14) << std::fixed << std::setprecision(0) << applyNs << std::endl;
+
+            // 1/3-octave ignores the band count
+            if (scales[i] == FilterbankScale::ThirdOctave) {
+                break;
+            }
+        }
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkDecimation()
+{
+    const int sampleRate = 44100;
+    const int hopSize = 512;
+
+    std::mt19937 random(13);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> hop(hopSize);
+    for (float& value : hop) {
+        value = dist(random);
+    }
+
+    std::cout << "Half-band decimation chain (per " << hopSize << "-sample hop)" << std::endl;
+    std::cout << std::setw(10) << "stages" << std::setw(12) << "rate" << std::setw(12) << "delay"
+              << std::setw(14) << "chain ns" << std::endl;
+    for (int stages = 1; stages <= 4; stages++) {
+        DecimationChain chain;
+        chain.initialize(sampleRate, stages, hopSize);
+        chain.subscribe(1 << stages, [](const float*, size_t) {});
+        const double chainNs = measureNs([&]() { chain.process(hop.data(), hopSize); });
+        std::cout << std::setw(10) << stages << std::setw(12) << ("1/" + std::to_string(1 << stages))
+                  << std::setw(12) << chain.getDelay(1 << stages)
+                  << std::setw(14) << std::fixed << std::setprecision(0) << chainNs << std::endl;
+    }
+
+    // Bass spectrum with 43 Hz bins: full-rate 1024-point FFT vs 128 points at 1/8 rate
+    RealFFT fullFFT;
+    fullFFT.initialize(1024);
+    std::vector<float> frame(1024);
+    for (float& value : frame) {
+        value = dist(random);
+    }
+    const double fullNs = measureNs([&]() { fullFFT.forward(frame.data()); });
+
+    DecimationChain chain;
+    chain.initialize(sampleRate, 3, hopSize);
+    SlidingWindow window;
+    window.initialize(128);
+    chain.subscribe(8, [&window](const float* samples, size_t count) { window.push(samples, count); });
+    RealFFT bassFFT;
+    bassFFT.initialize(128);
+    const double decimatedNs = measureNs([&]() {
+        chain.process(hop.data(), hopSize);
+        bassFFT.forward(window.data());
+    });
+
+    std::cout << "Bass spectrum per hop: 1024-point FFT " << std::fixed << std::setprecision(0) << fullNs
+              << " ns, 1/8 rate + 128-point FFT " << decimatedNs << " ns" << std::endl << std::endl;
+}
+
+void benchmarkCrossover()
+{
+    const int sampleRate = 44100;
+    const int hopSize = 512;
+
+    std::mt19937 random(17);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> hop(hopSize);
+    for (float& value : hop) {
+        value = dist(random);
+    }
+
+    std::cout << "Crossover envelopes (4th-order Linkwitz-Riley bands, per " << hopSize << "-sample hop)" << std::endl;
+    std::cout << std::setw(8) << "bands" << std::setw(14) << "hop ns" << std::setw(14) << "ns/sample" << std::endl;
+
+    const std::vector<std::vector<float>> layouts = {
+        { 250.0f, 2000.0f, 6000.0f },
+        { 60.0f, 150.0f, 400.0f, 1000.0f, 2500.0f, 6000.0f, 12000.0f },
+    };
+    for (const std::vector<float>& crossovers : layouts) {
+        CrossoverFilterBank crossover;
+        crossover.initialize(sampleRate, crossovers);
+        const double hopNs = measureNs([&]() { crossover.process(hop.data(), hopSize); });
+        std::cout << std::setw(8) << crossover.getNumBands()
+                  << std::setw(14) << std::fixed << std::setprecision(0) << hopNs
+                  << std::setw(14) << std::setprecision(2) << hopNs / hopSize << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkProbes()
+{
+    const int sampleRate = 44100;
+    const int hopSize = 512;
+
+    std::mt19937 random(19);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> hop(hopSize);
+    for (float& value : hop) {
+        value = dist(random);
+    }
+
+    DecimationChain chain;
+    chain.initialize(sampleRate, 3, hopSize);
+    GoertzelBank probes;
+    probes.initialize(chain);
+
+    // Kick, snare body and hi-hat style probes
+    const float frequencies[] = { 55.0f, 200.0f, 8000.0f };
+    const float bandwidths[] = { 40.0f, 50.0f, 1000.0f };
+    std::cout << "Goertzel probes (per " << hopSize << "-sample hop, including the decimation chain)" << std::endl;
+    std::cout << std::setw(8) << "probes" << std::setw(14) << "hop ns" << std::setw(24) << "last probe" << std::endl;
+    for (int i = 0; i < 3; i++) {
+        const int probe = probes.addProbe(frequencies[i], bandwidths[i]);
+        const double hopNs = measureNs([&]() {
+            chain.process(hop.data(), hopSize);
+            probes.update();
+        });
+
+        std::ostringstream detail;
+        detail << frequencies[i] << " Hz, " << probes.getWindowSize(probe) << " @ 1/" << probes.getDecimation(probe);
+        std::cout << std::setw(8) << probes.getNumProbes()
+                  << std::setw(14) << std::fixed << std::setprecision(0) << hopNs
+                  << std::setw(24) << detail.str() << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkMultiResolution()
+{
+    const int sampleRate = 44100;
+    const int hopSize = 512;
+    const int numBands = 32;
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> hop(hopSize);
+    for (float& value : hop) {
+        value = dist(random);
+    }
+    std::vector<float> bands(numBands);
+
+    // Reference: one full-rate 8192-point transform per hop
+    RealFFT realFFT;
+    realFFT.initialize(8192);
+    Filterbank filterbank;
+    filterbank.initialize(FilterbankScale::Log, numBands, 8192, sampleRate);
+    std::vector<float> frame(8192), magnitudes(realFFT.getNumBins());
+    for (float& value : frame) {
+        value = dist(random);
+    }
+    const double fullNs = measureNs([&]() {
+        realFFT.forward(frame.data());
+        realFFT.getMagnitudes(magnitudes.data());
+        filterbank.apply(magnitudes.data(), bands.data());
+    });
+
+    DecimationChain chain;
+    chain.initialize(sampleRate, 3, hopSize);
+    MultiResolutionSpectrum multiResolution;
+    multiResolution.initialize(chain, FilterbankScale::Log, numBands);
+    const double multiNs = measureNs([&]() {
+        chain.process(hop.data(), hopSize);
+        multiResolution.computeBands(bands.data());
+    });
+
+    std::cout << "Band analysis per " << hopSize << "-sample hop (" << numBands << " bands at 44.1 kHz)" << std::endl;
+    std::cout << "  full-rate 8192-point FFT:  " << std::fixed << std::setprecision(0) << fullNs << " ns" << std::endl;
+    std::cout << "  multi-resolution:          " << multiNs << " ns (";
+    for (int tier = 0; tier < multiResolution.getNumTiers(); tier++) {
+        const ResolutionTier& config = multiResolution.getTier(tier);
+        std::cout << (tier ? ", " : "") << multiResolution.getTierNumBands(tier) << " bands from "
+                  << config.fftSize << " @ 1/" << config.decimation;
+    }
+    std::cout << ")" << std::endl << std::endl;
+}
+
+// The features as separate loops, one pass per feature, for comparison with FeatureExtractor
+AudioFeatures separateFeatures(const float* spectrum, int numBins, float binWidth, std::vector<float>& previous,
+                               const float* frame, int frameSize, const float* block, int blockSize,
+                               const std::vector<float>& peakTaps)
+{
+    AudioFeatures features;
+
+    float sum = 0.0f;
+    for (int k = 0; k < numBins; k++) {
+        sum += spectrum[k];
+    }
+    float weighted = 0.0f;
+    for (int k = 0; k < numBins; k++) {
+        weighted += k * binWidth * spectrum[k];
+    }
+    features.centroid = weighted / sum;
+    float variance = 0.0f;
+    for (int k = 0; k < numBins; k++) {
+        const float distance = k * binWidth - features.centroid;
+        variance += distance * distance * spectrum[k];
+    }
+    features.spread = std::sqrt(variance / sum);
+    float cumulative = 0.0f;
+    int bin = 0;
+    while (bin < numBins - 1 && cumulative + spectrum[bin] < 0.85f * sum) {
+        cumulative += spectrum[bin++];
+    }
+    features.rolloff = bin * binWidth;
+    float logPower = 0.0f;
+    float power = 0.0f;
+    for (int k = 0; k < numBins; k++) {
+        const float binPower = std::max(spectrum[k] * spectrum[k], 1e-12f);
+        logPower += std::log(binPower);
+        power += binPower;
+    }
+    features.flatness = std::exp(logPower / numBins) / (power / numBins);
+    float rise = 0.0f;
+    for (int k = 0; k < numBins; k++) {
+        rise += std::max(spectrum[k] - previous[k], 0.0f);
+        previous[k] = spectrum[k];
+    }
+    features.flux = rise / sum;
+
+    float energy = 0.0f;
+    for (int i = 0; i < frameSize; i++) {
+        energy += frame[i] * frame[i];
+    }
+    features.rms = std::sqrt(energy / frameSize);
+    int crossings = 0;
+    for (int i = 1; i < frameSize; i++) {
+        crossings += (frame[i] * frame[i - 1] < 0.0f) ? 1 : 0;
+    }
+    features.zeroCrossingRate = static_cast<float>(crossings) / frameSize;
+    const int taps = static_cast<int>(peakTaps.size()) / 4;
+    for (int phase = 0; phase < 4; phase++) {
+        for (int i = taps - 1; i < blockSize; i++) {
+            float interpolated = 0.0f;
+            for (int t = 0; t < taps; t++) {
+                interpolated += peakTaps[t * 4 + phase] * block[i - t];
+            }
+            features.truePeak = std::max(features.truePeak, std::fabs(interpolated));
+        }
+    }
+    return features;
+}
+
+void benchmarkFeatures()
+{
+    std::cout << "Frame features (1024-point spectrum and 512-sample hop at 48 kHz)" << std::endl;
+    std::cout << std::setw(14) << "method" << std::setw(14) << "frame ns" << std::endl;
+
+    const int sampleRate = 48000;
+    const int size = 1024;
+    const int hopSize = 512;
+    const int numBins = size / 2 + 1;
+    std::mt19937 random(16);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> frame(size);
+    for (float& value : frame) {
+        value = dist(random);
+    }
+    RealFFT realFFT;
+    realFFT.initialize(size);
+    realFFT.forward(frame.data());
+    std::vector<float> spectrum(numBins);
+    realFFT.getMagnitudes(spectrum.data(), 2.0f / realFFT.getWindowSum());
+    const float* hop = frame.data() + size - hopSize;
+
+    // 48-tap windowed-sinc 4x interpolator for the separate loops' true peak
+    // (prototype order is already [tap][phase])
+    const double pi = 3.14159265358979323846;
+    std::vector<float> peakTaps(48);
+    for (int i = 0; i < 48; i++) {
+        const double x = (i - 24) / 4.0;
+        const double sinc = (x == 0.0) ? 1.0 : std::sin(pi * x) / (pi * x);
+        const double window = 0.42 - 0.5 * std::cos(2.0 * pi * i / 48) + 0.08 * std::cos(4.0 * pi * i / 48);
+        peakTaps[i] = static_cast<float>(sinc * window);
+    }
+
+    std::vector<float> previous(numBins, 0.0f);
+    AudioFeatures separate;
+    const double separateNs = measureNs([&]() {
+        separate = separateFeatures(spectrum.data(), numBins, static_cast<float>(sampleRate) / size, previous,
+                                    frame.data(), size, hop, hopSize, peakTaps);
+    });
+
+    FeatureExtractor extractor;
+    extractor.initialize(sampleRate, size, hopSize);
+    extractor.processBlock(frame.data(), hopSize);
+    const double fusedNs = measureNs([&]() {
+        extractor.processBlock(hop, hopSize);
+        extractor.processSpectrum(spectrum.data());
+    });
+
+    std::cout << std::setw(14) << "separate" << std::setw(14) << std::fixed << std::setprecision(0) << separateNs << std::endl;
+    std::cout << std::setw(14) << "fused" << std::setw(14) << fusedNs << std::endl;
+
+    // Both read the same spectrum and frame
+    const AudioFeatures& fused = extractor.getFeatures();
+    std::cout << std::setprecision(1) << "  centroid " << fused.centroid << " / " << separate.centroid
+              << " Hz, rolloff " << fused.rolloff << " / " << separate.rolloff
+              << " Hz, flatness " << std::setprecision(3) << fused.flatness << " / " << separate.flatness << std::endl;
+    std::cout << std::endl;
+}
+
+void benchmarkStereo()
+{
+    std::cout << "Stereo spectra (left, right, mid, side) at 44.1 kHz, 512-sample hops" << std::endl;
+    std::cout << std::setw(8) << "size" << std::setw(12) << "mono ns" << std::setw(14) << "4x real ns"
+              << std::setw(12) << "packed ns" << std::setw(10) << "hop ns" << std::setw(12) << "max error"
+              << std::setw(8) << "corr" << std::endl;
+
+    std::mt19937 random(24);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    const StereoChannel channels[] = { StereoChannel::Left, StereoChannel::Right, StereoChannel::Mid, StereoChannel::Side };
+
+    for (int size : { 1024, 2048 }) {
+        const int hopSize = 512;
+        const int numBins = size / 2 + 1;
+
+        // Partly correlated channels: a shared signal plus independent noise on each side
+        std::vector<float> frames(2 * size);
+        std::vector<std::vector<float>> signals(4, std::vector<float>(size));
+        for (int i = 0; i < size; i++) {
+            const float shared = dist(random);
+            const float left = shared + 0.5f * dist(random);
+            const float right = shared + 0.5f * dist(random);
+            frames[2 * i] = left;
+            frames[2 * i + 1] = right;
+            signals[0][i] = left;
+            signals[1][i] = right;
+            signals[2][i] = 0.5f * (left + right);
+            signals[3][i] = 0.5f * (left - right);
+        }
+
+        StereoAnalyzer stereo;
+        stereo.initialize(size, hopSize, 44100, 128);
+        for (int hop = 0; hop < size / hopSize; hop++) {
+            stereo.processHop(frames.data() + 2 * hop * hopSize);
+        }
+        const float correlation = stereo.getCorrelation();
+
+        // Reference: a real FFT of each of the four signals
+        RealFFT realFFT;
+        realFFT.initialize(size);
+        std::vector<std::vector<float>> reference(4, std::vector<float>(numBins));
+        for (int channel = 0; channel < 4; channel++) {
+            realFFT.forward(signals[channel].data());
+            realFFT.getMagnitudes(reference[channel].data());
+        }
+        stereo.transform();
+        double maxError = 0.0;
+        for (int channel = 0; channel < 4; channel++) {
+            const std::vector<float>& magnitudes = stereo.getMagnitudes(channels[channel]);
+            for (int bin = 0; bin < numBins; bin++) {
+                maxError = std::max(maxError, static_cast<double>(std::abs(magnitudes[bin] - reference[channel][bin])));
+            }
+        }
+
+        std::vector<float> magnitudes(numBins);
+        const double monoNs = measureNs([&]() {
+            realFFT.forward(signals[2].data());
+            realFFT.getMagnitudes(magnitudes.data());
+        });
+        const double separateNs = measureNs([&]() {
+            for (int channel = 0; channel < 4; channel++) {
+                realFFT.forward(signals[channel].data());
+                realFFT.getMagnitudes(magnitudes.data());
+            }
+        });
+        const double packedNs = measureNs([&]() { stereo.transform(); });
+        int hop = 0;
+        const double hopNs = measureNs([&]() {
+            stereo.processHop(frames.data() + 2 * (hop++ % (size / hopSize)) * hopSize);
+        });
+
+        std::cout << std::setw(8) << size
+                  << std::setw(12) << std::fixed << std::setprecision(0) << monoNs
+                  << std::setw(14) << separateNs
+                  << std::setw(12) << packedNs
+                  << std::setw(10) << hopNs
+                  << std::setw(12) << std::scientific << std::setprecision(1) << maxError
+                  << std::setw(8) << std::fixed << std::setprecision(2) << correlation << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkPitch()
+{
+    std::cout << "Pitch detection (2048-sample window, harmonic tone at 220 Hz)" << std::endl;
+    std::cout << std::setw(8) << "rate" << std::setw(14) << "window ns" << std::setw(12) << "budget %"
+              << std::setw(12) << "pitch Hz" << std::setw(12) << "confidence" << std::endl;
+
+    for (int sampleRate : { 44100, 48000 }) {
+        PitchDetector detector;
+        detector.initialize(sampleRate, 2048);
+
+        std::vector<float> window(2048);
+        for (size_t i = 0; i < window.size(); i++) {
+            const double t = static_cast<double>(i) / sampleRate;
+            window[i] = 0.0f;
+            for (int harmonic = 1; harmonic <= 5; harmonic++) {
+                window[i] += static_cast<float>(0.3 / harmonic * std::sin(2.0 * 3.14159265358979 * 220.0 * harmonic * t));
+            }
+        }
+
+        const double windowNs = measureNs([&]() { detector.process(window.data()); });
+
+        // One detection per 512-sample hop
+        const double hopNs = 512.0 * 1e9 / sampleRate;
+        std::cout << std::setw(8) << sampleRate
+                  << std::setw(14) << std::fixed << std::setprecision(0) << windowNs
+                  << std::setw(12) << std::setprecision(2) << 100.0 * windowNs / hopNs
+                  << std::setw(12) << detector.getPitch()
+                  << std::setw(12) << std::setprecision(3) << detector.getConfidence() << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkChroma()
+{
+    std::cout << "Chroma and key (2048-point window of the 1/8-rate stream, C major triad)" << std::endl;
+    std::cout << std::setw(8) << "rate" << std::setw(12) << "fold ns" << std::setw(12) << "key ns"
+              << std::setw(12) << "total ns" << std::setw(12) << "budget %" << std::setw(8) << "key" << std::endl;
+
+    const char* names[] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+    for (int sampleRate : { 44100, 48000 }) {
+        const int decimatedRate = sampleRate / 8;
+        RealFFT fft;
+        Chromagram chromagram;
+        KeyEstimator keyEstimator;
+        fft.initialize(2048);
+        chromagram.initialize(2048, decimatedRate);
+        keyEstimator.initialize(static_cast<float>(sampleRate) / 512);
+
+        std::vector<float> window(2048);
+        for (size_t i = 0; i < window.size(); i++) {
+            const double t = static_cast<double>(i) / decimatedRate;
+            window[i] = 0.0f;
+            for (double frequency : { 130.81, 164.81, 196.0, 261.63 }) {
+                window[i] += static_cast<float>(0.2 * std::sin(2.0 * 3.14159265358979 * frequency * t));
+            }
+        }
+        std::vector<float> magnitudes(fft.getNumBins());
+        fft.forward(window.data());
+        fft.getMagnitudes(magnitudes.data(), 2.0f / fft.getWindowSum());
+
+        const double foldNs = measureNs([&]() { chromagram.process(magnitudes.data()); });
+        const double keyNs = measureNs([&]() { keyEstimator.process(chromagram.getChroma()); });
+        const double totalNs = measureNs([&]() {
+            fft.forward(window.data());
+            fft.getMagnitudes(magnitudes.data(), 2.0f / fft.getWindowSum());
+            chromagram.process(magnitudes.data());
+            keyEstimator.process(chromagram.getChroma());
+        });
+
+        // One chroma frame per 512-sample hop
+        const double hopNs = 512.0 * 1e9 / sampleRate;
+        const int key = keyEstimator.getKey();
+        std::cout << std::setw(8) << sampleRate
+                  << std::setw(12) << std::fixed << std::setprecision(0) << foldNs
+                  << std::setw(12) << keyNs
+                  << std::setw(12) << totalNs
+                  << std::setw(12) << std::setprecision(2) << 100.0 * totalNs / hopNs
+                  << std::setw(8) << (key < 0 ? std::string("-") :
+                                      std::string(names[key]) + (keyEstimator.isMinor() ? "m" : "")) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkLoudness()
+{
+    std::cout << "Loudness metering (K-weighting and running windows, 1 kHz sine at -20 dBFS reads -23 LUFS"
+              << " mono, -20 LUFS on both stereo channels)" << std::endl;
+    std::cout << std::setw(8) << "rate" << std::setw(10) << "channels" << std::setw(12) << "hop ns"
+              << std::setw(12) << "budget %" << std::setw(12) << "momentary" << std::setw(12) << "short"
+              << std::setw(12) << "integrated" << std::endl;
+
+    for (int sampleRate : { 44100, 48000 }) {
+        for (int channels : { 1, 2 }) {
+            LoudnessMeter meter;
+            meter.initialize(sampleRate, channels);
+
+            // Ten seconds of signal, so every window is full and blocks have been gated
+            const size_t frames = 10 * static_cast<size_t>(sampleRate);
+            std::vector<float> signal(frames * channels);
+            for (size_t i = 0; i < frames; i++) {
+                const float sample = static_cast<float>(0.1 * std::sin(2.0 * 3.14159265358979 * 1000.0 * i / sampleRate));
+                std::fill(signal.begin() + i * channels, signal.begin() + (i + 1) * channels, sample);
+            }
+            meter.process(signal.data(), frames);
+            const float momentary = meter.getMomentary();
+            const float shortTerm = meter.getShortTerm();
+            const float integrated = meter.getIntegrated();
+
+            size_t position = 0;
+            const double hopNs = measureNs([&]() {
+                meter.process(signal.data() + position * channels, 512);
+                position = (position + 512) % (frames - 512);
+            });
+
+            const double budgetNs = 512.0 * 1e9 / sampleRate;
+            std::cout << std::setw(8) << sampleRate << std::setw(10) << channels
+                      << std::setw(12) << std::fixed << std::setprecision(0) << hopNs
+                      << std::setw(12) << std::setprecision(2) << 100.0 * hopNs / budgetNs
+                      << std::setw(12) << momentary
+                      << std::setw(12) << shortTerm
+                      << std::setw(12) << integrated << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkQuantiles()
+{
+    std::cout << "Adaptive band normalization (p10/p95 sketches over ~10 s of hops, levels in dB)" << std::endl;
+    std::cout << std::setw(8) << "bands" << std::setw(12) << "hop ns" << std::setw(12) << "ns/band"
+              << std::setw(10) << "p10" << std::setw(10) << "p95" << std::endl;
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> levels(-40.0f, 10.0f);
+    for (int numBands : { 32, 128 }) {
+        std::vector<QuantileSketch> sketches(numBands);
+        for (QuantileSketch& sketch : sketches) {
+            sketch.initialize({ 0.10f, 0.95f }, -90.0f, 6.0f, 192, 860.0f);
+        }
+
+        // Levels drawn up front so the timing is the sketches alone (expect p10 -52.8, p95 -23.6)
+        std::vector<float> frames(numBands * 4096);
+        for (float& level : frames) {
+            level = levels(rng);
+        }
+        size_t frame = 0;
+        std::vector<float> normalized(numBands);
+        const double hopNs = measureNs([&]() {
+            const float* frameLevels = frames.data() + (frame++ % 4096) * numBands;
+            for (int band = 0; band < numBands; band++) {
+                sketches[band].add(frameLevels[band]);
+                const float low = sketches[band].getQuantile(0);
+                const float range = std::max(12.0f, sketches[band].getQuantile(1) - low);
+                normalized[band] = std::max(0.0f, std::min(1.0f, (frameLevels[band] - low) / range));
+            }
+        });
+
+        std::cout << std::setw(8) << numBands
+                  << std::setw(12) << std::fixed << std::setprecision(0) << hopNs
+                  << std::setw(12) << std::setprecision(1) << hopNs / numBands
+                  << std::setw(10) << sketches[0].getQuantile(0)
+                  << std::setw(10) << sketches[0].getQuantile(1) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+void benchmarkDataLog()
+{
+    std::cout << "AudioData log (513 spectrum bins, 32 bands, 1024 waveform samples per frame)" << std::endl;
+
+    AudioData frame;
+    frame.spectrum.assign(513, 0.25f);
+    frame.bands.assign(32, 0.5f);
+    frame.chroma.assign(12, 0.1f);
+    frame.waveform.assign(1024, 0.0f);
+    const std::string path = (std::filesystem::temp_directory_path() / "audio_bench.avlog").string();
+
+    AudioDataLogWriter writer;
+    if (!writer.open(path, 44100, 512)) {
+        return;
+    }
+    double timestamp = 0.0;
+    const double appendNs = measureNs([&]() {
+        writer.append(frame, timestamp);
+        timestamp += 512.0 / 44100.0;
+    });
+    const size_t frameCount = writer.getFrameCount();
+    writer.close();
+
+    AudioDataLogReader reader;
+    if (!reader.open(path)) {
+        std::remove(path.c_str());
+        return;
+    }
+    const double fileBytes = static_cast<double>(std::filesystem::file_size(path));
+    int next = 0;
+    AudioData decoded;
+    const double decodeNs = measureNs([&]() {
+        reader.decode(next, decoded);
+        next = (next + 1) % reader.getFrameCount();
+    });
+    reader.close();
+    std::remove(path.c_str());
+
+    // 86 frames a second at 512-sample hops
+    std::cout << "  append " << std::fixed << std::setprecision(0) << appendNs << " ns/frame, decode "
+              << decodeNs << " ns/frame, " << fileBytes / frameCount << " bytes/frame ("
+              << std::setprecision(1) << fileBytes / frameCount * 44100.0 / 512.0 * 60.0 / 1e6 << " MB/min)"
+              << std::endl << std::endl;
+}
+
+void benchmarkOnsetTempo()
+{
+    // 512-sample hops at 44.1 kHz
+    const float frameRate = 44100.0f / 512.0f;
+    const int numBands = 32;
+
+    OnsetDetector onsetDetector;
+    onsetDetector.initialize(numBands, frameRate);
+    TempoTracker tempoTracker;
+    tempoTracker.initialize(frameRate);
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> dist(0.0f, 0.5f);
+    std::vector<std::vector<float>> frames(64, std::vector<float>(numBands));
+    for (std::vector<float>& frame : frames) {
+        for (float& value : frame) {
+            value = dist(random);
+        }
+    }
+
+    // Averaged over many hops, so the periodic tempo re-estimate is amortized
+    size_t frameIndex = 0;
+    const double hopNs = measureNs([&]() {
+        const bool onset = onsetDetector.process(frames[frameIndex++ % frames.size()].data());
+        tempoTracker.process(onsetDetector.getFlux(), onset);
+    }, 0.5);
+
+    std::cout << "Onset detection + tempo tracking (" << numBands << " bands): "
+              << std::fixed << std::setprecision(0) << hopNs << " ns per hop" << std::endl << std::endl;
+}
+
+void benchmarkScenarios(const std::vector<SyntheticScenario>& scenarios)
+{
+    const int sampleRate = 44100;
+    const int size = 1024;
+    const int hopSize = 512;
+    const int numBands = 32;
+
+    // Twenty seconds of each scenario, long enough for tempo and integrated loudness to settle
+    std::vector<std::vector<float>> signals;
+    std::vector<double> generateNs;
+    for (SyntheticScenario scenario : scenarios) {
+        SyntheticSource source(scenario);
+        source.initialize(sampleRate);
+        std::vector<float> block(hopSize);
+        generateNs.push_back(measureNs([&]() { source.generate(block.data(), block.size()); }) / hopSize);
+        source.reset();
+        signals.emplace_back(20 * sampleRate);
+        source.generate(signals.back().data(), signals.back().size());
+    }
+
+    std::cout << "Synthetic scenarios through FFT, filterbank, loudness, onsets and tempo ("
+              << size << "-point frames, " << hopSize << "-sample hops at 44.1 kHz)" << std::endl;
+    std::cout << std::setw(12) << "scenario" << std::setw(12) << "gen ns/smp" << std::setw(10) << "hop ns"
+              << std::setw(10) << "budget %" << std::setw(8) << "LUFS" << std::setw(8) << "onsets"
+              << std::setw(8) << "bpm" << std::endl;
+
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        RealFFT realFFT;
+        realFFT.initialize(size);
+        Filterbank filterbank;
+        filterbank.initialize(FilterbankScale::Log, numBands, size, sampleRate);
+        LoudnessMeter meter;
+        meter.initialize(sampleRate);
+        OnsetDetector onsetDetector;
+        onsetDetector.initialize(filterbank.getNumBands(), static_cast<float>(sampleRate) / hopSize);
+        TempoTracker tempoTracker;
+        tempoTracker.initialize(static_cast<float>(sampleRate) / hopSize);
+        std::vector<float> spectrum(size / 2 + 1);
+        std::vector<float> bands(filterbank.getNumBands());
+
+        // One pass in order, since every stage keeps state from hop to hop
+        const std::vector<float>& signal = signals[i];
+        int onsets = 0;
+        size_t hops = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t position = 0; position + size <= signal.size(); position += hopSize) {
+            realFFT.forward(signal.data() + position);
+            realFFT.getMagnitudes(spectrum.data(), 2.0f / realFFT.getWindowSum());
+            filterbank.apply(spectrum.data(), bands.data());
+            meter.process(signal.data() + position + size - hopSize, hopSize);
+            const bool onset = onsetDetector.process(bands.data());
+            tempoTracker.process(onsetDetector.getFlux(), onset);
+            onsets += onset ? 1 : 0;
+            hops++;
+        }
+        const double hopNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / hops;
+
+        const double budgetNs = hopSize * 1e9 / sampleRate;
+        std::cout << std::setw(12) << getSyntheticScenarioName(scenarios[i])
+                  << std::setw(12) << std::fixed << std::setprecision(1) << generateNs[i]
+                  << std::setw(10) << std::setprecision(0) << hopNs
+                  << std::setw(10) << std::setprecision(2) << 100.0 * hopNs / budgetNs
+                  << std::setw(8) << std::setprecision(1) << meter.getIntegrated()
+                  << std::setw(8) << onsets
+                  << std::setw(8) << tempoTracker.getBpm() << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --scenario <name> (repeatable) limits the scenario section to those signals
+    std::vector<SyntheticScenario> scenarios;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        SyntheticScenario scenario;
+        if (arg == "--scenario" && i + 1 < argc && parseSyntheticScenario(argv[i + 1], scenario)) {
+            scenarios.push_back(scenario);
+            i++;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--scenario <name>]...\n"
+                      << "Scenarios: tones, silence, pink-noise, log-sweep, kick-120, dense-mix, clipping" << std::endl;
+            return 1;
+        }
+    }
+    if (scenarios.empty()) {
+        scenarios.assign(std::begin(AllSyntheticScenarios), std::end(AllSyntheticScenarios));
+    }
+
+    std::cout << "Audio analysis benchmark" << std::endl << std::endl;
+
+    benchmarkFFT();
+    const bool kernelsMatch = benchmarkSampleKernels();
+    benchmarkSTFT();
+    benchmarkSlidingDFT();
+    benchmarkFilterbank();
+    benchmarkDecimation();
+    benchmarkCrossover();
+    benchmarkProbes();
+    benchmarkMultiResolution();
+    benchmarkFeatures();
+    benchmarkStereo();
+    benchmarkPitch();
+    benchmarkChroma();
+    benchmarkLoudness();
+    benchmarkQuantiles();
+    benchmarkDataLog();
+    benchmarkOnsetTempo();
+    benchmarkScenarios(scenarios);
+
+    return kernelsMatch ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+// Offline track analysis
+// Runs the full analysis pipeline over a WAV file on all cores and writes a
+// feature track that the visualizer replays with --input <file>.avft, so a
+// known playlist needs no analysis at show time.
+
+#include "AudioProcessor.h"
+#include "audio/WavFileSource.h"
+#include "audio/FeatureTrack.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+const int SampleRateHint = 44100;
+const int FrameSize = 1024;
+const int HopSize = FrameSize / 2;
+
+// Each chunk is analyzed from this far before its start: five time constants
+// of the band ranges' 10 s memory, so the history a chunk misses carries under
+// 1% of their weight. The spectrum matches a single pass exactly, and the
+// adaptive bands nearly so. Stages with longer or state-dependent memory can
+// still differ for a while after a seam: energy (auto gain follows integrated
+// loudness), tempo, beat phase and the beat flags, and the key.
+const int PrerollSeconds = 50;
+
+// Chunks shorter than this aren't worth their preroll
+const int MinChunkSeconds = 60;
+
+// Samples decoded per read
+const size_t ReadBlock = 64 * HopSize;
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " <input.wav> <output.avft> [options]\n"
+              << "Options:\n"
+              << "  --threads <n>       Worker threads (default: all cores)\n"
+              << "  --bands <n>         Number of analysis bands (default 32)\n"
+              << "  --band-scale <s>    Band spacing: log (default), mel, third (1/3 octave)\n";
+}
+
+struct Chunk {
+    size_t firstHop;                // First hop whose frame this chunk writes
+    size_t endHop;
+    std::vector<uint8_t> records;
+    bool ok = false;
+};
+
+// Analyze one chunk's hops (after its preroll) into quantized records
+void analyzeChunk(const av::WavFileSource& wav, const av::AudioAnalysisConfig& analysis,
+                  const av::FeatureTrackWriter& writer, Chunk& chunk)
+{
+    av::AudioProcessor processor;
+    processor.setAnalysisConfig(analysis);
+    if (!processor.initializeOffline(wav.getSampleRate(), FrameSize)) {
+        return;
+    }
+
+    // Start on a hop boundary so frames line up with a single pass over the file
+    const size_t prerollHops = static_cast<size_t>(PrerollSeconds) * wav.getSampleRate() / HopSize;
+    const size_t startHop = chunk.firstHop - std::min(chunk.firstHop, prerollHops);
+    size_t hop = startHop;
+
+    const size_t frameBytes = writer.getFrameBytes();
+    chunk.records.resize((chunk.endHop - chunk.firstHop) * frameBytes);
+    float previousOnset = 0.0f;
+    float previousPhase = 0.0f;
+    auto onFrame = [&](const av::AudioData& frame) {
+        // Onsets show as a rise of the onset envelope, beats as the phase wrapping
+        uint8_t flags = 0;
+        if (frame.onset > previousOnset + 0.01f) {
+            flags |= av::FeatureTrackOnset;
+        }
+        if (frame.bpm > 0.0f && frame.beatPhase < previousPhase - 0.5f) {
+            flags |= av::FeatureTrackBeat;
+        }
+        previousOnset = frame.onset;
+        previousPhase = frame.beatPhase;
+
+        if (hop >= chunk.firstHop && hop < chunk.endHop) {
+            writer.encode(frame, flags, chunk.records.data() + (hop - chunk.firstHop) * frameBytes);
+        }
+        hop++;
+    };
+
+    std::vector<float> samples(ReadBlock);
+    size_t position = startHop * HopSize;
+    const size_t end = chunk.endHop * HopSize;
+    while (position < end) {
+        const size_t count = wav.readMono(position, std::min(ReadBlock, end - position), samples.data());
+        if (count == 0) {
+            break;
+        }
+        processor.analyzeOffline(samples.data(), count, onFrame);
+        position += count;
+    }
+    chunk.ok = (hop == chunk.endHop);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const std::string inputPath = argv[1];
+    const std::string outputPath = argv[2];
+
+    av::AudioAnalysisConfig analysis;
+    int numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 3; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        if (arg == "--threads" && hasValue) {
+            numThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--bands" && hasValue) {
+            analysis.numBands = std::atoi(argv[++i]);
+        } else if (arg == "--band-scale" && hasValue) {
+            const std::string scale = argv[++i];
+            if (scale == "log") {
+                analysis.bandScale = av::FilterbankScale::Log;
+            } else if (scale == "mel") {
+                analysis.bandScale = av::FilterbankScale::Mel;
+            } else if (scale == "third") {
+                analysis.bandScale = av::FilterbankScale::ThirdOctave;
+            } else {
+                std::cerr << "Unknown band scale: " << scale << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    av::WavFileSource wav(inputPath, false);
+    if (!wav.initialize(SampleRateHint)) {
+        return 1;
+    }
+    const int sampleRate = wav.getSampleRate();
+    const size_t totalHops = wav.getFrameCount() / HopSize;
+    if (totalHops == 0) {
+        std::cerr << inputPath << " is shorter than one analysis hop" << std::endl;
+        return 1;
+    }
+
+    // Record layout follows the pipeline's output sizes
+    av::AudioProcessor probe;
+    probe.setAnalysisConfig(analysis);
+    if (!probe.initializeOffline(sampleRate, FrameSize)) {
+        return 1;
+    }
+    av::FeatureTrackWriter writer;
+    if (!writer.initialize(sampleRate, HopSize, FrameSize / 2 + 1,
+                           static_cast<int>(probe.getBandFrequencies().size()))) {
+        return 1;
+    }
+
+    // Contiguous chunks of whole hops, one per thread unless that makes them too short
+    const size_t minChunkHops = static_cast<size_t>(MinChunkSeconds) * sampleRate / HopSize;
+    const size_t numChunks = std::max<size_t>(1, std::min<size_t>(numThreads, totalHops / minChunkHops));
+    std::vector<Chunk> chunks(numChunks);
+    for (size_t i = 0; i < numChunks; i++) {
+        chunks[i].firstHop = totalHops * i / numChunks;
+        chunks[i].endHop = totalHops * (i + 1) / numChunks;
+    }
+
+    std::cout << "Analyzing " << static_cast<double>(totalHops) * HopSize / sampleRate << " s in "
+              << numChunks << " chunk(s)" << std::endl;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (Chunk& chunk : chunks) {
+        workers.emplace_back(analyzeChunk, std::cref(wav), std::cref(analysis), std::cref(writer),
+                             std::ref(chunk));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<uint8_t> records;
+    records.reserve(totalHops * writer.getFrameBytes());
+    for (const Chunk& chunk : chunks) {
+        if (!chunk.ok) {
+            std::cerr << "Analysis failed for hops " << chunk.firstHop << "-" << chunk.endHop << std::endl;
+            return 1;
+        }
+        records.insert(records.end(), chunk.records.begin(), chunk.records.end());
+    }
+
+    // Frame n is current once hop n has been heard
+    if (!writer.write(outputPath, records, HopSize)) {
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Wrote " << totalHops << " frames to " << outputPath << " in " << seconds << " s ("
+              << static_cast<double>(totalHops) * HopSize / sampleRate / seconds << "x real time)" << std::endl;
+    return 0;
+}
@@ -57,6 +57,8 @@ bool Engine::initialize(int width, int height, const std::string& title)
     
     // Create audio processor
     m_audioProcessor = std::make_unique<AudioProcessor>();
+    m_audioProcessor->setSourceConfig(m_audioSourceConfig);
+    m_audioProcessor->setAnalysisConfig(m_audioAnalysisConfig);
     if (!m_audioProcessor->initialize()) {
         std::cerr << "Warning: Failed to initialize audio processor" << std::endl;
         // Continue anyway, audio might not be available
@@ -103,6 +105,13 @@ bool Engine::initialize(int width, int height, const std::string& title)
     m_visualizationManager->addVisualizer(std::make_unique<ParticleFountainVisualizer>());
     std::cout << "Added ParticleFountainVisualizer to visualization manager" << std::endl;
     
+    // Let visualizers ask for the fixed frequencies they follow
+    if (m_audioProcessor) {
+        for (const auto& visualization : m_visualizationManager->getVisualizations()) {
+            visualization->registerProbes(*m_audioProcessor);
+        }
+    }
+    
     // Set the current visualization to the ParticleFountainVisualizer (index 4)
     m_visualizationManager->setCurrentVisualization(4);
     std::cout << "Initial visualization set to: " << 
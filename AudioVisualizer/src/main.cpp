@@ -1,6 +1,7 @@
 #include "Engine.h"
 #include <iostream>
 #include <string>
+#include <cstdlib>
 #include <SDL.h>
 
 // Default settings
@@ -8,7 +9,109 @@ constexpr int DEFAULT_WIDTH = 1024;
 constexpr int DEFAULT_HEIGHT = 768;
 const std::string DEFAULT_TITLE = "Audio Visualizer";
 
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --source <type>     auto (default), capture, wasapi, synthetic, wav, pcm, track, replay\n"
+              << "  --input <path>      WAV file, raw PCM pipe ('-' for stdin), .avft feature track or .avlog log\n"
+              << "  --rate <hz>         Raw PCM sample rate (default 44100)\n"
+              << "  --channels <n>      Raw PCM channel count (default 2)\n"
+              << "  --format <fmt>      Raw PCM sample format: s16 (default), s24, s32, f32\n"
+              << "  --scenario <name>   Synthetic signal: tones (default), silence, pink-noise, log-sweep,\n"
+              << "                      kick-120, dense-mix, clipping\n"
+              << "  --seed <n>          Synthetic signal noise seed (default 1)\n"
+              << "  --bands <n>         Number of analysis bands (default 32)\n"
+              << "  --band-scale <s>    Band spacing: log (default), mel, third (1/3 octave)\n"
+              << "  --multires          Measure low bands with long decimated windows, highs with short ones\n"
+              << "  --no-spectrum       Low-power mode: skip the FFT stage, levels from envelopes and probes\n"
+              << "  --sliding-bands     Bands from a per-sample sliding DFT (one bin per band)\n"
+              << "  --fixed-bands       Fixed log curve for band levels instead of each band's recent range\n"
+              << "  --mono              Mix to mono on input, skipping the stereo spectra, correlation and goniometer\n"
+              << "  --record <path>     Record every analysis frame to an AudioData log (.avlog)\n"
+              << "  --replay-speed <x>  Feature track or log playback rate (default 1, 0 = one frame per render)\n";
+}
+
+// Parse the audio source and analysis options; returns false on a bad or unknown option
+bool parseAudioArgs(int argc, char* argv[], av::AudioSourceConfig& config, av::AudioAnalysisConfig& analysis,
+                    std::string& recordPath) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = (i + 1 < argc);
+        
+        if (arg == "--source" && hasValue) {
+            config.type = argv[++i];
+        } else if (arg == "--input" && hasValue) {
+            config.path = argv[++i];
+        } else if (arg == "--rate" && hasValue) {
+            config.sampleRate = std::atoi(argv[++i]);
+        } else if (arg == "--channels" && hasValue) {
+            config.channels = std::atoi(argv[++i]);
+        } else if (arg == "--format" && hasValue) {
+            if (!av::parseSampleFormat(argv[++i], config.format)) {
+                std::cerr << "Unknown sample format: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--scenario" && hasValue) {
+            if (!av::parseSyntheticScenario(argv[++i], config.scenario)) {
+                std::cerr << "Unknown synthetic scenario: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--bands" && hasValue) {
+            analysis.numBands = std::atoi(argv[++i]);
+        } else if (arg == "--band-scale" && hasValue) {
+            const std::string scale = argv[++i];
+            if (scale == "log") {
+                analysis.bandScale = av::FilterbankScale::Log;
+            } else if (scale == "mel") {
+                analysis.bandScale = av::FilterbankScale::Mel;
+            } else if (scale == "third") {
+                analysis.bandScale = av::FilterbankScale::ThirdOctave;
+            } else {
+                std::cerr << "Unknown band scale: " << scale << std::endl;
+                return false;
+            }
+        } else if (arg == "--multires") {
+            analysis.multiResolution = true;
+        } else if (arg == "--no-spectrum") {
+            analysis.spectrum = false;
+        } else if (arg == "--sliding-bands") {
+            analysis.slidingBands = true;
+        } else if (arg == "--fixed-bands") {
+            analysis.adaptiveBands = false;
+        } else if (arg == "--mono") {
+            analysis.stereo = false;
+        } else if (arg == "--record" && hasValue) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay-speed" && hasValue) {
+            config.replaySpeed = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    
+    // An input path without a source type implies a WAV file, or a feature track or log by its extension
+    if (config.type == "auto" && !config.path.empty()) {
+        auto hasExtension = [&config](const std::string& extension) {
+            return config.path.size() > extension.size() &&
+                config.path.compare(config.path.size() - extension.size(), extension.size(), extension) == 0;
+        };
+        config.type = hasExtension(".avft") ? "track" : hasExtension(".avlog") ? "replay" : "wav";
+    }
+    return true;
+}
+
 int main(int argc, char* argv[]) {
+    av::AudioSourceConfig audioSourceConfig;
+    av::AudioAnalysisConfig audioAnalysisConfig;
+    std::string recordPath;
+    if (!parseAudioArgs(argc, argv, audioSourceConfig, audioAnalysisConfig, recordPath)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+
     std::cout << "====================================================================================\n";
     std::cout << "================== STARTING APPLICATION - ENHANCED VISUALIZERS ====================\n";
     std::cout << "====================================================================================\n";
@@ -35,6 +138,8 @@ int main(int argc, char* argv[]) {
     
     // Create the engine
     av::Engine engine;
+    engine.setAudioSourceConfig(audioSourceConfig);
+    engine.setAudioAnalysisConfig(audioAnalysisConfig);
     
     // Initialize the engine
     std::cout << "Calling engine.initialize()..." << std::endl;
@@ -43,6 +148,11 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    // Record what the visualizers are fed, for replaying the same frames later
+    if (!recordPath.empty() && !engine.getAudioProcessor()->startRecording(recordPath)) {
+        return 1;
+    }
+    
     // Run the engine
     std::cout << "Engine.run() - Starting main loop NOW" << std::endl;
     engine.run();
@@ -349,13 +349,13 @@ void Bars3DVisualizer::render(Renderer* renderer, const AudioData& audioData)
     int spectrumHeight = 50;
     int spectrumY = height - spectrumHeight - 10;
     
-    // Draw spectrum if available
-    if (!audioData.spectrum.empty()) {
-        int barCount = std::min(64, static_cast<int>(audioData.spectrum.size()));
+    // Draw perceptual bands if available
+    if (!audioData.bands.empty()) {
+        int barCount = static_cast<int>(audioData.bands.size());
         float barWidth = static_cast<float>(width - 20) / barCount;
         
         for (int i = 0; i < barCount; i++) {
-            float value = audioData.spectrum[i * audioData.spectrum.size() / barCount];
+            float value = audioData.bands[i];
             value = std::min(1.0f, value * 3.0f); // Amplify for visibility
             
             float barHeight = value * spectrumHeight;
@@ -19,6 +19,7 @@ NeonCityscapeVisualizer::NeonCityscapeVisualizer()
     , m_trebleResponse(0.0f)
     , m_beatIntensity(0.0f)
     , m_beatActive(false)
+    , m_paletteKey(-1)
     , m_skyTopColor(0.05f, 0.05f, 0.15f, 1.0f)      // Dark blue
     , m_skyBottomColor(0.15f, 0.0f, 0.3f, 1.0f)     // Deep purple
     , m_groundColor(0.0f, 0.0f, 0.0f, 1.0f)         // Black ground
@@ -307,9 +308,51 @@ Color NeonCityscapeVisualizer::randomNeonColor()
     };
     
     std::uniform_int_distribution<int> colorDist(0, 6);
+    if (m_paletteKey >= 0) {
+        return keyNeonColor(colorDist(m_rng));
+    }
     return neonColors[colorDist(m_rng)];
 }
 
+Color NeonCityscapeVisualizer::keyNeonColor(int index) const
+{
+    // Tonic, dominant, subdominant and their complements; hues follow the circle
+    // of fifths so related keys get neighbouring palettes
+    const float hueOffsets[] = { 0.0f, 1.0f / 12.0f, -1.0f / 12.0f, 0.5f, 0.5f + 1.0f / 12.0f, 0.25f, 0.75f };
+    const int numOffsets = sizeof(hueOffsets) / sizeof(hueOffsets[0]);
+    
+    const int tonic = m_paletteKey % 12;
+    const bool minor = m_paletteKey >= 12;
+    float hue = ((tonic * 7) % 12) / 12.0f + hueOffsets[index % numOffsets];
+    hue -= std::floor(hue);
+    
+    // Minor keys are deeper and less saturated
+    const float saturation = minor ? 0.7f : 0.85f;
+    const float value = minor ? 0.8f : 1.0f;
+    return Color::fromHSV(hue, saturation, value);
+}
+
+void NeonCityscapeVisualizer::updateKeyPalette(const AudioData& audioData)
+{
+    const float confidentKey = 0.6f;
+    if (audioData.key < 0 || audioData.keyConfidence < confidentKey) {
+        return;
+    }
+    const int key = audioData.key + (audioData.keyMinor ? 12 : 0);
+    if (key == m_paletteKey) {
+        return;
+    }
+    m_paletteKey = key;
+    
+    // Colors depend only on the key and position, so a key always looks the same
+    for (size_t i = 0; i < m_buildings.size(); i++) {
+        m_buildings[i].color = keyNeonColor(static_cast<int>(i));
+    }
+    for (size_t i = 0; i < m_vehicles.size(); i++) {
+        m_vehicles[i].color = keyNeonColor(static_cast<int>(i) + 3);
+    }
+}
+
 void NeonCityscapeVisualizer::renderSkyline(Renderer* renderer)
 {
     // Draw each building
@@ -478,6 +521,9 @@ void NeonCityscapeVisualizer::processAudio(const AudioData& audioData)
     m_midResponse *= (m_amplificationFactor / 20.0f);
     m_trebleResponse *= (m_amplificationFactor / 20.0f);
     
+    // Palette follows the harmonic content
+    updateKeyPalette(audioData);
+    
     // Detect beats for pulsing effects
     float newBeatIntensity = getBeatIntensity(audioData);
     
@@ -68,8 +68,10 @@ void NeonMeterVisualizer::render(Renderer* renderer, const AudioData& audioData)
         lastHeight = height;
     }
     
-    // Get raw waveform data if available
-    if (audioData.waveform.empty()) {
+    // Prefer the analysis thread's crossover envelopes, then the raw waveform
+    if (audioData.envelopes.size() >= 3) {
+        processEnvelopeData(audioData);
+    } else if (audioData.waveform.empty()) {
         // Fallback to processed frequency data if waveform unavailable
         processFrequencyData(audioData);
     } else {
@@ -110,6 +112,23 @@ void NeonMeterVisualizer::render(Renderer* renderer, const AudioData& audioData)
     }
 }
 
+// Meter levels from the crossover band envelopes (bass, mid, presence, air)
+void NeonMeterVisualizer::processEnvelopeData(const AudioData& audioData)
+{
+    // Peak over the blocks since the last snapshot, so short hits still register
+    const size_t numBands = audioData.envelopes.size();
+    float peaks[3] = { 0.0f, 0.0f, 0.0f };
+    for (size_t i = 0; i < audioData.envelopeBlocks.size(); i++) {
+        const size_t meter = std::min<size_t>(i % numBands, 2);
+        peaks[meter] = std::max(peaks[meter], audioData.envelopeBlocks[i]);
+    }
+    
+    // Presence and air both feed the high meter
+    updateMeterValue(m_bassPrev, peaks[0]);
+    updateMeterValue(m_midPrev, peaks[1]);
+    updateMeterValue(m_treblePrev, peaks[2]);
+}
+
 // New method to directly analyze waveform data for more precise meter readings
 void NeonMeterVisualizer::processWaveformData(const AudioData& audioData)
 {
@@ -263,18 +263,18 @@ void ParticleFountainVisualizer::render(Renderer* renderer, const AudioData& aud
     );
     
     // Add audio frequency visualization at bottom
-    if (!audioData.spectrum.empty()) {
+    if (!audioData.bands.empty()) {
         // Draw a spectrum analyzer at the bottom
         float spectrumHeight = 30.0f;
         float spectrumY = height - spectrumHeight - 10;
         
-        // Use a subset of the spectrum
-        int barCount = std::min(64, static_cast<int>(audioData.spectrum.size()));
-        float barWidth = width / barCount;
+        // One bar per perceptual band
+        int barCount = static_cast<int>(audioData.bands.size());
+        float barWidth = static_cast<float>(width) / barCount;
         
         for (int i = 0; i < barCount; i++) {
             // Get frequency value
-            float value = audioData.spectrum[i * audioData.spectrum.size() / barCount];
+            float value = audioData.bands[i];
             value = std::min(1.0f, value * 3.0f); // Amplify
             
             // Height based on value
@@ -20,6 +20,8 @@ RetroWaveOscilloscopeVisualizer::RetroWaveOscilloscopeVisualizer()
     , m_waveformY(0)
     , m_time(0)
     , m_bassResponse(0)
+    , m_kickProbe(-1)
+    , m_kickResponse(0)
     , m_midResponse(0)
     , m_trebleResponse(0)
     , m_skyTopColor(0.05f, 0.0f, 0.2f, 1.0f)           // Deep purple
@@ -145,6 +147,12 @@ void RetroWaveOscilloscopeVisualizer::initStars()
     }
 }
 
+void RetroWaveOscilloscopeVisualizer::registerProbes(AudioProcessor& audioProcessor)
+{
+    // The sun pulses on the kick drum fundamental
+    m_kickProbe = audioProcessor.registerProbe(55.0f, 40.0f);
+}
+
 void RetroWaveOscilloscopeVisualizer::processAudio(const AudioData& audioData)
 {
     // Apply amplification factor
@@ -164,6 +172,11 @@ void RetroWaveOscilloscopeVisualizer::processAudio(const AudioData& audioData)
     m_midResponse = m_midResponse * (1.0f - smoothingFactor) + midValue * smoothingFactor;
     m_trebleResponse = m_trebleResponse * (1.0f - smoothingFactor) + trebleValue * smoothingFactor;
     
+    // Kick follows its probe instantly and falls back over a few frames
+    if (m_kickProbe >= 0 && m_kickProbe < static_cast<int>(audioData.probes.size())) {
+        m_kickResponse = std::max(audioData.probes[m_kickProbe], m_kickResponse * 0.85f);
+    }
+    
     // Ensure values are in range [0,1]
     m_bassResponse = std::max(0.0f, std::min(m_bassResponse, 1.0f));
     m_midResponse = std::max(0.0f, std::min(m_midResponse, 1.0f));
@@ -340,7 +353,7 @@ void RetroWaveOscilloscopeVisualizer::renderSun(Renderer* renderer)
     // Draw the sun
     Color sunColor = m_sun.color;
     float sunPulse = 0.8f + 0.2f * std::sin(m_time * 0.5f);
-    float radius = m_sun.radius * (0.9f + 0.1f * sunPulse + 0.1f * m_bassResponse);
+    float radius = m_sun.radius * (0.9f + 0.1f * sunPulse + 0.1f * m_bassResponse + 0.15f * m_kickResponse);
     
     // Draw sun disc
     renderer->drawFilledCircle(m_sun.x, sunY, radius, sunColor);
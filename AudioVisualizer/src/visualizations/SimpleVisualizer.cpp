@@ -133,13 +133,16 @@ void SimpleVisualizer::render(Renderer* renderer, const AudioData& audioData)
         }
     }
 
-    // Draw spectrum - enhanced version with 3D effect
-    if (!audioData.spectrum.empty()) {
+    // Draw spectrum - enhanced version with 3D effect. One bar per perceptual band,
+    // or sampled FFT bins when the analysis provides no bands
+    const bool useBands = !audioData.bands.empty();
+    if (useBands || !audioData.spectrum.empty()) {
         // Make the spectrum bigger and position it below the waveform
         int spectrumY = height / 2;
         int spectrumHeight = height / 3;
         
-        int barCount = std::min(128, static_cast<int>(audioData.spectrum.size()));
+        int barCount = useBands ? static_cast<int>(audioData.bands.size())
+                                : std::min(128, static_cast<int>(audioData.spectrum.size()));
         float barWidth = static_cast<float>(width - 40) / barCount;
         
         // Draw a background for the spectrum
@@ -153,11 +156,16 @@ void SimpleVisualizer::render(Renderer* renderer, const AudioData& audioData)
 
         // Draw spectrum bars with 3D effect
         for (int i = 0; i < barCount; i++) {
-            float index = static_cast<float>(i) / barCount * std::min(static_cast<int>(audioData.spectrum.size() - 1), 512);
-            int specIndex = static_cast<int>(index);
+            float level;
+            if (useBands) {
+                level = audioData.bands[i];
+            } else {
+                float index = static_cast<float>(i) / barCount * std::min(static_cast<int>(audioData.spectrum.size() - 1), 512);
+                level = audioData.spectrum[static_cast<int>(index)];
+            }
             
             // Apply an envelope to emphasize the shape
-            float amplifiedValue = std::min(1.0f, audioData.spectrum[specIndex] * m_amplificationFactor);
+            float amplifiedValue = std::min(1.0f, level * m_amplificationFactor);
             
             // Add some bounce based on the bass
             float bounceEffect = 0.0f;